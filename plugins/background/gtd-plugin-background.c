@@ -26,6 +26,7 @@
 #define AUTOSTART_NOTIFICATION_ID      "Gtd::BackgroundPlugin::autostart_notification"
 #define AUTOSTART_NOTIFICATION_TIMEOUT 3  /* seconds */
 #define MAX_BODY_LENGTH                50 /* chars */
+#define REMINDER_NOTIFICATION_ID       "Gtd::BackgroundPlugin::reminder::%s"
 
 struct _GtdPluginBackground
 {
@@ -38,8 +39,22 @@ struct _GtdPluginBackground
   gboolean            show_notifications : 1;
 
   guint               startup_notification_timeout_id;
+
+  /* GtdTask → GtdTimer deadline of its reminder */
+  GHashTable         *reminders;
+
+  /* Incomplete tasks due today */
+  GHashTable         *today_tasks;
+  GDateTime          *today;
 };
 
+/* Auxiliary struct for reminders */
+typedef struct
+{
+  GtdPluginBackground *self;
+  GtdTask             *task;
+} Reminder;
+
 static void          on_tasklist_notified                        (GtdPluginBackground      *self);
 
 static void          gtd_activatable_iface_init                  (GtdActivatableInterface  *iface);
@@ -171,47 +186,6 @@ is_today (GDateTime *now,
          g_date_time_get_day_of_month (dt) == g_date_time_get_day_of_month (now);
 }
 
-static GList*
-get_tasks_for_today (guint *n_events)
-{
-  g_autoptr (GDateTime) now;
-  GtdManager *manager;
-  GList *task_lists, *l;
-  GList *result;
-  guint n_tasks;
-
-  now = g_date_time_new_now_local ();
-  result = NULL;
-  n_tasks = 0;
-  manager = gtd_manager_get_default ();
-  task_lists = gtd_manager_get_task_lists (manager);
-
-  for (l = task_lists; l != NULL; l = l->next)
-    {
-      GList *tasks, *t;
-
-      tasks = gtd_task_list_get_tasks (l->data);
-
-      for (t = tasks; t != NULL; t = t->next)
-        {
-          GDateTime *due_date;
-
-          due_date = gtd_task_get_due_date (t->data);
-
-          if (!due_date || !is_today (now, due_date) || gtd_task_get_complete (t->data))
-            continue;
-
-          n_tasks += 1;
-          result = g_list_prepend (result, t->data);
-        }
-    }
-
-  if (n_events)
-    *n_events = n_tasks;
-
-  return result;
-}
-
 static void
 send_notification (GtdPluginBackground *self)
 {
@@ -236,13 +210,14 @@ send_notification (GtdPluginBackground *self)
   if (!g_settings_get_boolean (self->settings, "show-notifications"))
     return;
 
-  app = g_application_get_default ();
-  tasks = get_tasks_for_today (&n_tasks);
+  n_tasks = g_hash_table_size (self->today_tasks);
 
-  /* If n_tasks == 0, tasks == NULL, thus we don't need to free it */
   if (n_tasks == 0)
     return;
 
+  app = g_application_get_default ();
+  tasks = g_hash_table_get_keys (self->today_tasks);
+
   title = g_strdup_printf (g_dngettext (GETTEXT_PACKAGE,
                                         "You have %d task for today",
                                         "You have %d tasks for today",
@@ -259,9 +234,279 @@ send_notification (GtdPluginBackground *self)
   g_application_send_notification (app, AUTOSTART_NOTIFICATION_ID, notification);
 
   g_clear_pointer (&tasks, g_list_free);
+  g_clear_pointer (&title, g_free);
+  g_clear_pointer (&body, g_free);
   g_clear_object (&notification);
 }
 
+/*
+ * Reminders
+ *
+ * Each incomplete task due at a given time of the day gets a deadline
+ * in GtdTimer, which shows a notification when the task is due. Tasks
+ * due on a whole day are covered by the notification of today's tasks.
+ */
+static void
+reminder_free (Reminder *reminder)
+{
+  g_clear_object (&reminder->task);
+  g_free (reminder);
+}
+
+static void
+send_reminder_notification (GtdPluginBackground *self,
+                            GtdTask             *task)
+{
+  g_autoptr (GNotification) notification = NULL;
+  g_autofree gchar *notification_id = NULL;
+
+  if (!g_settings_get_boolean (self->settings, "show-notifications"))
+    return;
+
+  notification = g_notification_new (gtd_task_get_title (task));
+  g_notification_set_body (notification, _("This task is due now"));
+  g_notification_set_default_action (notification, "app.activate");
+
+  notification_id = g_strdup_printf (REMINDER_NOTIFICATION_ID, gtd_object_get_uid (GTD_OBJECT (task)));
+
+  g_application_send_notification (g_application_get_default (), notification_id, notification);
+}
+
+static void
+on_reminder_deadline_cb (GtdTimer *timer,
+                         gpointer  user_data)
+{
+  Reminder *reminder = user_data;
+
+  g_hash_table_remove (reminder->self->reminders, reminder->task);
+
+  send_reminder_notification (reminder->self, reminder->task);
+}
+
+static void
+update_reminder (GtdPluginBackground *self,
+                 GtdTask             *task,
+                 gboolean             removed)
+{
+  g_autoptr (GDateTime) due_date = NULL;
+  g_autoptr (GDateTime) now = NULL;
+  GtdTimer *timer;
+  Reminder *reminder;
+  gpointer deadline_id;
+
+  timer = gtd_manager_get_timer (gtd_manager_get_default ());
+
+  if (g_hash_table_lookup_extended (self->reminders, task, NULL, &deadline_id))
+    {
+      g_hash_table_remove (self->reminders, task);
+      gtd_timer_remove_deadline (timer, GPOINTER_TO_UINT (deadline_id));
+    }
+
+  if (removed || gtd_task_get_complete (task))
+    return;
+
+  due_date = gtd_task_get_due_date (task);
+
+  /* Only tasks due at a specific time */
+  if (!due_date ||
+      (g_date_time_get_hour (due_date) == 0 &&
+       g_date_time_get_minute (due_date) == 0 &&
+       g_date_time_get_second (due_date) == 0))
+    {
+      return;
+    }
+
+  /* Don't notify about past due dates */
+  now = g_date_time_new_now_local ();
+
+  if (g_date_time_compare (due_date, now) <= 0)
+    return;
+
+  reminder = g_new0 (Reminder, 1);
+  reminder->self = self;
+  reminder->task = g_object_ref (task);
+
+  deadline_id = GUINT_TO_POINTER (gtd_timer_add_deadline (timer,
+                                                          due_date,
+                                                          on_reminder_deadline_cb,
+                                                          reminder,
+                                                          (GDestroyNotify) reminder_free));
+
+  g_hash_table_insert (self->reminders, task, deadline_id);
+}
+
+static void
+remove_all_reminders (GtdPluginBackground *self)
+{
+  GHashTableIter iter;
+  gpointer deadline_id;
+  GtdTimer *timer;
+
+  timer = gtd_manager_get_timer (gtd_manager_get_default ());
+
+  g_hash_table_iter_init (&iter, self->reminders);
+
+  while (g_hash_table_iter_next (&iter, NULL, &deadline_id))
+    {
+      g_hash_table_iter_remove (&iter);
+      gtd_timer_remove_deadline (timer, GPOINTER_TO_UINT (deadline_id));
+    }
+}
+
+/*
+ * Today's tasks
+ *
+ * The set of incomplete tasks due today is kept up to date with each
+ * task change, so notifying about them doesn't need to look at every
+ * task of every list.
+ */
+static void
+update_today_task (GtdPluginBackground *self,
+                   GtdTask             *task,
+                   gboolean             removed)
+{
+  g_autoptr (GDateTime) due_date = NULL;
+
+  if (!removed && !gtd_task_get_complete (task))
+    due_date = gtd_task_get_due_date (task);
+
+  if (due_date && is_today (self->today, due_date))
+    g_hash_table_add (self->today_tasks, task);
+  else
+    g_hash_table_remove (self->today_tasks, task);
+}
+
+static void
+update_task (GtdPluginBackground *self,
+             GtdTask             *task,
+             gboolean             removed)
+{
+  update_today_task (self, task, removed);
+  update_reminder (self, task, removed);
+}
+
+static void
+on_task_added_cb (GtdTaskList         *list,
+                  GtdTask             *task,
+                  GtdPluginBackground *self)
+{
+  update_task (self, task, FALSE);
+}
+
+static void
+on_task_removed_cb (GtdTaskList         *list,
+                    GtdTask             *task,
+                    GtdPluginBackground *self)
+{
+  update_task (self, task, TRUE);
+}
+
+static void
+update_tasks_of_list (GtdPluginBackground *self,
+                      GtdTaskList         *list,
+                      gboolean             removed)
+{
+  GList *tasks, *l;
+
+  tasks = gtd_task_list_get_tasks (list);
+
+  for (l = tasks; l != NULL; l = l->next)
+    update_task (self, l->data, removed);
+
+  g_list_free (tasks);
+}
+
+static void
+on_list_added_cb (GtdManager          *manager,
+                  GtdTaskList         *list,
+                  GtdPluginBackground *self)
+{
+  g_signal_connect (list, "task-added", G_CALLBACK (on_task_added_cb), self);
+  g_signal_connect (list, "task-updated", G_CALLBACK (on_task_added_cb), self);
+  g_signal_connect (list, "task-removed", G_CALLBACK (on_task_removed_cb), self);
+
+  update_tasks_of_list (self, list, FALSE);
+}
+
+static void
+on_list_removed_cb (GtdManager          *manager,
+                    GtdTaskList         *list,
+                    GtdPluginBackground *self)
+{
+  g_signal_handlers_disconnect_by_data (list, self);
+
+  update_tasks_of_list (self, list, TRUE);
+}
+
+static void
+watch_tasks (GtdPluginBackground *self)
+{
+  GtdManager *manager;
+  GList *lists, *l;
+
+  manager = gtd_manager_get_default ();
+  lists = gtd_manager_get_task_lists (manager);
+
+  for (l = lists; l != NULL; l = l->next)
+    on_list_added_cb (manager, l->data, self);
+
+  g_signal_connect (manager, "list-added", G_CALLBACK (on_list_added_cb), self);
+  g_signal_connect (manager, "list-removed", G_CALLBACK (on_list_removed_cb), self);
+
+  g_list_free (lists);
+}
+
+static void
+unwatch_tasks (GtdPluginBackground *self)
+{
+  GtdManager *manager;
+  GList *lists, *l;
+
+  manager = gtd_manager_get_default ();
+  lists = gtd_manager_get_task_lists (manager);
+
+  for (l = lists; l != NULL; l = l->next)
+    g_signal_handlers_disconnect_by_data (l->data, self);
+
+  g_signal_handlers_disconnect_by_func (manager, on_list_added_cb, self);
+  g_signal_handlers_disconnect_by_func (manager, on_list_removed_cb, self);
+
+  remove_all_reminders (self);
+  g_hash_table_remove_all (self->today_tasks);
+
+  g_list_free (lists);
+}
+
+/* The day changed, so today's tasks are different ones */
+static void
+on_day_changed_cb (GtdPluginBackground *self)
+{
+  GList *lists, *l;
+
+  g_clear_pointer (&self->today, g_date_time_unref);
+  self->today = g_date_time_new_now_local ();
+
+  g_hash_table_remove_all (self->today_tasks);
+
+  lists = gtd_manager_get_task_lists (gtd_manager_get_default ());
+
+  for (l = lists; l != NULL; l = l->next)
+    {
+      GList *tasks, *t;
+
+      tasks = gtd_task_list_get_tasks (l->data);
+
+      for (t = tasks; t != NULL; t = t->next)
+        update_today_task (self, t->data, FALSE);
+
+      g_list_free (tasks);
+    }
+
+  g_list_free (lists);
+
+  send_notification (self);
+}
+
 /*
  * Callbacks
  */
@@ -324,7 +569,7 @@ watch_manager_for_new_lists (GtdPluginBackground *self)
 
   g_signal_connect_swapped (gtd_manager_get_timer (manager),
                             "update",
-                            G_CALLBACK (send_notification),
+                            G_CALLBACK (on_day_changed_cb),
                             self);
 }
 
@@ -353,6 +598,9 @@ gtd_plugin_background_activate (GtdActivatable *activatable)
 
   /* Start watching the manager to notify the user about today's tasks */
   watch_manager_for_new_lists (self);
+
+  /* And the tasks, to remind the user when they're due */
+  watch_tasks (self);
 }
 
 static void
@@ -379,9 +627,11 @@ gtd_plugin_background_deactivate (GtdActivatable *activatable)
                                         self);
 
   g_signal_handlers_disconnect_by_func (gtd_manager_get_timer (manager),
-                                        send_notification,
+                                        on_day_changed_cb,
                                         self);
 
+  unwatch_tasks (self);
+
   /* Deactivate the timeout */
   if (self->startup_notification_timeout_id > 0)
     {
@@ -436,6 +686,9 @@ gtd_plugin_background_finalize (GObject *object)
   GtdPluginBackground *self = (GtdPluginBackground *)object;
 
   g_clear_object (&self->settings);
+  g_clear_pointer (&self->reminders, g_hash_table_destroy);
+  g_clear_pointer (&self->today_tasks, g_hash_table_destroy);
+  g_clear_pointer (&self->today, g_date_time_unref);
 
   G_OBJECT_CLASS (gtd_plugin_background_parent_class)->finalize (object);
 }
@@ -490,6 +743,10 @@ gtd_plugin_background_init (GtdPluginBackground *self)
   /* Load the settings */
   self->settings = g_settings_new ("org.gnome.todo.plugins.background");
 
+  self->reminders = g_hash_table_new (g_direct_hash, g_direct_equal);
+  self->today_tasks = g_hash_table_new (g_direct_hash, g_direct_equal);
+  self->today = g_date_time_new_now_local ();
+
   /* And the preferences panel */
   builder = gtk_builder_new_from_resource ("/org/gnome/todo/ui/background/preferences.ui");
 
@@ -21,6 +21,9 @@
 
 #include <glib/gi18n.h>
 
+/* Maximum number of sources being connected at the same time */
+#define MAX_PARALLEL_CONNECTIONS 4
+
 /**
  * #GtdProviderEds is the base class of #GtdProviderLocal
  * and #GtdProviderGoa. It provides the common functionality
@@ -41,15 +44,41 @@ typedef struct
 
   GHashTable           *clients;
 
-  gint                  lazy_load_id;
+  /* Sources waiting to be connected */
+  GQueue               *pending_sources;
+  guint                 n_connecting;
+  guint                 load_sources_id;
+  gboolean              lists_loaded;
+
+  /* Task writes waiting to be sent, as GtdTask → PendingWrite */
+  GHashTable           *pending_updates;
+  GHashTable           *pending_removals;
+  guint                 flush_batches_id;
 } GtdProviderEdsPrivate;
 
-/* Auxiliary struct for asyncronous task operations */
-typedef struct _TaskData
+/* Auxiliary struct for a task write waiting to be sent */
+typedef struct
+{
+  ECalClient         *client;
+  GList              *results;
+} PendingWrite;
+
+/* Auxiliary struct for a batch of task writes to the same client */
+typedef struct
+{
+  ECalClient         *client;
+  GPtrArray          *tasks;
+  GPtrArray          *results;
+} BatchData;
+
+/* Auxiliary struct for connecting to a source */
+typedef struct
 {
   GtdProviderEds     *provider;
-  gpointer           *data;
-} TaskData;
+  ESource            *source;
+  gint64              start_time;
+  gint64              connected_time;
+} LoadSourceData;
 
 
 G_DEFINE_TYPE_WITH_PRIVATE (GtdProviderEds, gtd_provider_eds, GTD_TYPE_OBJECT)
@@ -60,17 +89,87 @@ enum {
   N_PROPS
 };
 
-static TaskData*
-task_data_new (GtdProviderEds *provider,
-               gpointer       *data)
+static void          gtd_provider_eds_load_pending_sources       (GtdProviderEds     *self);
+
+static void          gtd_provider_eds_flush_batches              (GtdProviderEds     *self);
+
+static BatchData*
+batch_data_new (ECalClient *client)
 {
-  TaskData *tdata;
+  BatchData *data;
 
-  tdata = g_new0 (TaskData, 1);
-  tdata->provider = provider;
-  tdata->data = data;
+  data = g_new0 (BatchData, 1);
+  data->client = g_object_ref (client);
+  data->tasks = g_ptr_array_new_with_free_func (g_object_unref);
+  data->results = g_ptr_array_new_with_free_func (g_object_unref);
+
+  return data;
+}
+
+static void
+batch_data_free (BatchData *data)
+{
+  g_clear_object (&data->client);
+  g_ptr_array_unref (data->tasks);
+  g_ptr_array_unref (data->results);
+  g_free (data);
+}
+
+static void
+batch_data_return (BatchData    *data,
+                   const GError *error)
+{
+  guint i;
+
+  for (i = 0; i < data->results->len; i++)
+    {
+      GTask *result = g_ptr_array_index (data->results, i);
 
-  return tdata;
+      if (error)
+        g_task_return_error (result, g_error_copy (error));
+      else
+        g_task_return_boolean (result, TRUE);
+    }
+}
+
+static PendingWrite*
+pending_write_new (ECalClient *client)
+{
+  PendingWrite *write;
+
+  write = g_new0 (PendingWrite, 1);
+  write->client = g_object_ref (client);
+
+  return write;
+}
+
+static void
+pending_write_free (PendingWrite *write)
+{
+  g_clear_object (&write->client);
+  g_list_free_full (write->results, g_object_unref);
+  g_free (write);
+}
+
+static LoadSourceData*
+load_source_data_new (GtdProviderEds *provider,
+                      ESource        *source)
+{
+  LoadSourceData *data;
+
+  data = g_new0 (LoadSourceData, 1);
+  data->provider = provider;
+  data->source = g_object_ref (source);
+  data->start_time = g_get_monotonic_time ();
+
+  return data;
+}
+
+static void
+load_source_data_free (LoadSourceData *data)
+{
+  g_clear_object (&data->source);
+  g_free (data);
 }
 
 static void
@@ -91,59 +190,37 @@ gtd_provider_eds_set_default (GtdProviderEds *self,
     gtd_manager_set_default_provider (manager, GTD_PROVIDER (self));
 }
 
+/*
+ * The lists are loaded once no source is waiting to be connected, and
+ * all the connected lists received their initial set of tasks.
+ */
 static void
-gtd_provider_eds_fill_task_list (GObject      *client,
-                                 GAsyncResult *result,
-                                 gpointer      user_data)
+gtd_provider_eds_update_lists_loaded (GtdProviderEds *self)
 {
-  GtdTaskList *list;
-  TaskData *data = user_data;
-  GSList *component_list;
-  GError *error = NULL;
-
-  g_return_if_fail (GTD_IS_PROVIDER_EDS (data->provider));
-
-  list = GTD_TASK_LIST (data->data);
+  GtdProviderEdsPrivate *priv;
+  GList *l;
 
-  e_cal_client_get_object_list_as_comps_finish (E_CAL_CLIENT (client),
-                                                result,
-                                                &component_list,
-                                                &error);
+  priv = gtd_provider_eds_get_instance_private (self);
 
-  gtd_object_set_ready (GTD_OBJECT (data->data), TRUE);
-  g_free (data);
+  if (priv->lists_loaded)
+    return;
 
-  if (!error)
+  if (priv->load_sources_id > 0 ||
+      priv->n_connecting > 0 ||
+      !g_queue_is_empty (priv->pending_sources))
     {
-      GSList *l;
-
-      for (l = component_list; l != NULL; l = l->next)
-        {
-          GtdTask *task;
-
-          task = gtd_task_new (l->data);
-          gtd_task_set_list (task, list);
-
-          gtd_task_list_save_task (list, task);
-        }
-
-      e_cal_client_free_ecalcomp_slist (component_list);
+      return;
     }
-  else
-    {
-      g_warning ("%s: %s: %s",
-                 G_STRFUNC,
-                 _("Error fetching tasks from list"),
-                 error->message);
 
-      gtd_manager_emit_error_message (gtd_manager_get_default (),
-                                      _("Error fetching tasks from list"),
-                                      error->message,
-                                      NULL,
-                                      NULL);
-      g_error_free (error);
-      return;
+  for (l = priv->task_lists; l != NULL; l = l->next)
+    {
+      if (!gtd_object_get_ready (l->data))
+        return;
     }
+
+  priv->lists_loaded = TRUE;
+
+  g_signal_emit_by_name (self, "lists-loaded");
 }
 
 static void
@@ -154,19 +231,26 @@ gtd_provider_eds_on_client_connected (GObject      *source_object,
   GtdProviderEdsPrivate *priv;
   GtdProviderEds *self;
   GtdTaskListEds *list;
+  LoadSourceData *data;
   ECalClient *client;
-  TaskData *data;
   ESource *default_source;
   ESource *source;
   ESource *parent;
   GError *error;
 
-  self = GTD_PROVIDER_EDS (user_data);
+  data = user_data;
+  self = data->provider;
   priv = gtd_provider_eds_get_instance_private (self);
   error = NULL;
-  source = e_client_get_source (E_CLIENT (source_object));
+  source = data->source;
   client = E_CAL_CLIENT (e_cal_client_connect_finish (result, &error));
 
+  data->connected_time = g_get_monotonic_time ();
+
+  /* A connection slot is free, start loading the next source */
+  priv->n_connecting--;
+  gtd_provider_eds_load_pending_sources (self);
+
   if (error)
     {
       g_debug ("%s: %s (%s): %s",
@@ -181,7 +265,10 @@ gtd_provider_eds_on_client_connected (GObject      *source_object,
                                       NULL,
                                       NULL);
 
+      load_source_data_free (data);
       g_error_free (error);
+
+      gtd_provider_eds_update_lists_loaded (self);
       return;
     }
 
@@ -191,23 +278,22 @@ gtd_provider_eds_on_client_connected (GObject      *source_object,
   /* creates a new task list */
   list = gtd_task_list_eds_new (GTD_PROVIDER (self), source);
 
-  /* it's not ready until we fetch the list of tasks from client */
-  gtd_object_set_ready (GTD_OBJECT (list), FALSE);
-
-  /* async data */
-  data = task_data_new (user_data, (gpointer) list);
+  /*
+   * The list keeps its tasks in sync with a live view on the client, and
+   * is not ready until the view reports the initial set of tasks.
+   */
+  gtd_task_list_eds_set_client (list, client);
 
-  /* asyncronously fetch the task list */
-  e_cal_client_get_object_list_as_comps (client,
-                                         "contains? \"any\" \"\"",
-                                         NULL,
-                                         gtd_provider_eds_fill_task_list,
-                                         data);
+  g_signal_connect_object (list,
+                           "notify::ready",
+                           G_CALLBACK (gtd_provider_eds_update_lists_loaded),
+                           self,
+                           G_CONNECT_SWAPPED);
 
   priv->task_lists = g_list_append (priv->task_lists, list);
 
   g_object_set_data (G_OBJECT (source), "task-list", list);
-  g_hash_table_insert (priv->clients, source, client);
+  g_hash_table_insert (priv->clients, g_object_ref (source), client);
 
   /* Check if the current list is the default one */
   default_source = e_source_registry_ref_default_task_list (priv->source_registry);
@@ -222,42 +308,71 @@ gtd_provider_eds_on_client_connected (GObject      *source_object,
 
   g_object_unref (parent);
 
-  g_debug ("%s: %s (%s)",
+  g_debug ("%s: %s (%s) in %.1f ms",
            G_STRFUNC,
            _("Task list source successfully connected"),
-           e_source_get_display_name (source));
-}
+           e_source_get_display_name (source),
+           (data->connected_time - data->start_time) / 1000.0);
 
-typedef struct
-{
-  GtdProviderEds *provider;
-  ESource        *source;
-} LoadSourceData;
+  load_source_data_free (data);
 
-static gboolean
-gtd_provider_eds_load_source_cb (LoadSourceData *data)
+  gtd_provider_eds_update_lists_loaded (self);
+}
+
+static void
+gtd_provider_eds_load_pending_sources (GtdProviderEds *self)
 {
   GtdProviderEdsPrivate *priv;
-  GtdProviderEds *provider;
-  ESource *source;
 
-  provider = data->provider;
-  source = data->source;
-  priv = gtd_provider_eds_get_instance_private (provider);
+  priv = gtd_provider_eds_get_instance_private (self);
 
-  if (e_source_has_extension (source, E_SOURCE_EXTENSION_TASK_LIST) &&
-      !g_hash_table_lookup (priv->clients, source) &&
-      GTD_PROVIDER_EDS_CLASS (G_OBJECT_GET_CLASS (provider))->should_load_source (provider, source))
+  while (priv->n_connecting < MAX_PARALLEL_CONNECTIONS &&
+         !g_queue_is_empty (priv->pending_sources))
     {
+      LoadSourceData *data;
+      ESource *source;
+
+      data = g_queue_pop_head (priv->pending_sources);
+      source = data->source;
+
+      if (!e_source_has_extension (source, E_SOURCE_EXTENSION_TASK_LIST) ||
+          g_hash_table_lookup (priv->clients, source) ||
+          !GTD_PROVIDER_EDS_CLASS (G_OBJECT_GET_CLASS (self))->should_load_source (self, source))
+        {
+          load_source_data_free (data);
+          continue;
+        }
+
+      g_debug ("%s: %s (%s): waited %.1f ms in queue",
+               G_STRFUNC,
+               "Connecting to task list",
+               e_source_get_display_name (source),
+               (g_get_monotonic_time () - data->start_time) / 1000.0);
+
+      priv->n_connecting++;
+
       e_cal_client_connect (source,
                             E_CAL_CLIENT_SOURCE_TYPE_TASKS,
                             10, /* seconds to wait */
                             NULL,
                             gtd_provider_eds_on_client_connected,
-                            provider);
+                            data);
     }
+}
 
-  g_free (data);
+static gboolean
+gtd_provider_eds_load_sources_cb (gpointer user_data)
+{
+  GtdProviderEds *self;
+  GtdProviderEdsPrivate *priv;
+
+  self = GTD_PROVIDER_EDS (user_data);
+  priv = gtd_provider_eds_get_instance_private (self);
+
+  priv->load_sources_id = 0;
+
+  gtd_provider_eds_load_pending_sources (self);
+  gtd_provider_eds_update_lists_loaded (self);
 
   return G_SOURCE_REMOVE;
 }
@@ -266,22 +381,21 @@ static void
 gtd_provider_eds_load_source (GtdProviderEds *provider,
                               ESource        *source)
 {
-  LoadSourceData *data;
+  GtdProviderEdsPrivate *priv;
 
-  data = g_new0 (LoadSourceData, 1);
-  data->provider = provider;
-  data->source = source;
-
-  /* HACK: I really don't like to use arbitrary timeouts on
-   * my code, but we have absolutely no guarantees that
-   * ESourceRegistry::source-added was emited to the other
-   * objects before. So Milan Crha told me to add this timeout
-   * and "guarantee" that other objects will receive the
-   * signal.
+  priv = gtd_provider_eds_get_instance_private (provider);
+
+  g_queue_push_tail (priv->pending_sources, load_source_data_new (provider, source));
+
+  /*
+   * We have no guarantees that ESourceRegistry::source-added was
+   * emitted to the other objects before us, so connecting must not
+   * happen from within the signal emission. Wait until the main loop
+   * is idle again, which also batches all the sources that are added
+   * at once (e.g. at startup) into a single dispatch.
    */
-  g_timeout_add (1000,
-                 (GSourceFunc) gtd_provider_eds_load_source_cb,
-                 data);
+  if (priv->load_sources_id == 0)
+    priv->load_sources_id = g_idle_add (gtd_provider_eds_load_sources_cb, provider);
 }
 
 static void
@@ -303,6 +417,8 @@ gtd_provider_eds_remove_source (GtdProviderEds *provider,
    * to let it stay here.
    */
   g_signal_emit_by_name (provider, "list-removed", list);
+
+  gtd_provider_eds_update_lists_loaded (provider);
 }
 
 
@@ -445,6 +561,21 @@ gtd_provider_eds_finalize (GObject *object)
 
   g_signal_handlers_disconnect_by_func (priv->source_registry, default_tasklist_changed_cb, self);
 
+  if (priv->load_sources_id > 0)
+    {
+      g_source_remove (priv->load_sources_id);
+      priv->load_sources_id = 0;
+    }
+
+  g_queue_free_full (priv->pending_sources, (GDestroyNotify) load_source_data_free);
+  priv->pending_sources = NULL;
+
+  /* Don't lose pending writes */
+  gtd_provider_eds_flush_batches (self);
+
+  g_clear_pointer (&priv->pending_updates, g_hash_table_destroy);
+  g_clear_pointer (&priv->pending_removals, g_hash_table_destroy);
+
   g_clear_pointer (&priv->clients, g_hash_table_destroy);
   g_clear_object (&priv->credentials_prompter);
   g_clear_object (&priv->source_registry);
@@ -545,6 +676,9 @@ gtd_provider_eds_set_registry (GtdProviderEds  *provider,
   g_set_object (&priv->source_registry, registry);
 
   gtd_provider_eds_load_registry (provider);
+
+  /* Without any source, there's nothing to wait for */
+  gtd_provider_eds_update_lists_loaded (provider);
 }
 
 
@@ -553,21 +687,43 @@ gtd_provider_eds_create_task_finished (GObject      *client,
                                        GAsyncResult *result,
                                        gpointer      user_data)
 {
-  TaskData *data = user_data;
+  GTask *operation = user_data;
+  GtdProviderEds *self;
+  GtdTaskListEds *tasklist;
+  GtdTask *task;
   gchar *new_uid = NULL;
   GError *error = NULL;
 
+  self = g_task_get_source_object (operation);
+  task = g_task_get_task_data (operation);
+  tasklist = g_object_steal_data (G_OBJECT (task), "gtd-creating-task-list");
+
   e_cal_client_create_object_finish (E_CAL_CLIENT (client),
                                      result,
                                      &new_uid,
                                      &error);
 
-  gtd_object_set_ready (GTD_OBJECT (data->data), TRUE);
+  /*
+   * In the case the task UID changes because of creation proccess,
+   * reapply it to the task before the list adds the tasks it held back.
+   */
+  if (!error && new_uid)
+    gtd_object_set_uid (GTD_OBJECT (task), new_uid);
 
-  if (error)
-    {
-      GtdTask *task = GTD_TASK (data->data);
+  g_free (new_uid);
 
+  gtd_task_list_eds_end_task_creation (tasklist);
+  g_object_unref (tasklist);
+
+  gtd_object_set_ready (GTD_OBJECT (task), TRUE);
+
+  if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+    {
+      /* Whoever cancelled it doesn't want the task anymore */
+      g_task_return_error (operation, error);
+    }
+  else if (error)
+    {
       g_warning ("%s: %s: %s",
                  G_STRFUNC,
                  _("Error creating task"),
@@ -583,44 +739,43 @@ gtd_provider_eds_create_task_finished (GObject      *client,
                                       NULL,
                                       NULL);
 
-      g_error_free (error);
+      g_task_return_error (operation, error);
     }
   else
     {
       /* Update the default tasklist */
-      gtd_provider_eds_set_default (data->provider, gtd_task_get_list (GTD_TASK (data->data)));
+      gtd_provider_eds_set_default (self, gtd_task_get_list (task));
 
-      /*
-       * In the case the task UID changes because of creation proccess,
-       * reapply it to the task.
-       */
-      if (new_uid)
-        {
-          gtd_object_set_uid (GTD_OBJECT (data->data), new_uid);
-          g_free (new_uid);
-        }
+      g_task_return_boolean (operation, TRUE);
     }
 
-  g_free (data);
+  g_object_unref (operation);
 }
 
 static void
-gtd_provider_eds_update_task_finished (GObject      *client,
-                                       GAsyncResult *result,
-                                       gpointer      user_data)
+gtd_provider_eds_update_tasks_finished (GObject      *client,
+                                        GAsyncResult *result,
+                                        gpointer      user_data)
 {
-  TaskData *data = user_data;
+  BatchData *data = user_data;
   GError *error = NULL;
+  guint i;
 
-  e_cal_client_modify_object_finish (E_CAL_CLIENT (client),
-                                     result,
-                                     &error);
+  e_cal_client_modify_objects_finish (E_CAL_CLIENT (client),
+                                      result,
+                                      &error);
+
+  for (i = 0; i < data->tasks->len; i++)
+    gtd_object_set_ready (g_ptr_array_index (data->tasks, i), TRUE);
+
+  batch_data_return (data, error);
 
   if (error)
     {
-      g_warning ("%s: %s: %s",
+      g_warning ("%s: %s (%u tasks): %s",
                  G_STRFUNC,
                  _("Error updating task"),
+                 data->tasks->len,
                  error->message);
 
       gtd_manager_emit_error_message (gtd_manager_get_default (),
@@ -632,33 +787,39 @@ gtd_provider_eds_update_task_finished (GObject      *client,
       g_error_free (error);
     }
 
-  gtd_object_set_ready (GTD_OBJECT (data->data), TRUE);
-
-  g_free (data);
+  batch_data_free (data);
 }
 
 static void
-gtd_provider_eds_remove_task_finished (GObject      *client,
-                                       GAsyncResult *result,
-                                       gpointer      user_data)
+gtd_provider_eds_remove_tasks_finished (GObject      *client,
+                                        GAsyncResult *result,
+                                        gpointer      user_data)
 {
-  TaskData *data = user_data;
+  BatchData *data = user_data;
   GError *error = NULL;
+  guint i;
 
-  e_cal_client_remove_object_finish (E_CAL_CLIENT (client),
-                                     result,
-                                     &error);
+  e_cal_client_remove_objects_finish (E_CAL_CLIENT (client),
+                                      result,
+                                      &error);
+
+  /* Removed tasks are owned by us, drop them */
+  for (i = 0; i < data->tasks->len; i++)
+    {
+      GtdTask *task = g_ptr_array_index (data->tasks, i);
 
-  gtd_object_set_ready (GTD_OBJECT (data->data), TRUE);
+      gtd_object_set_ready (GTD_OBJECT (task), TRUE);
+      g_object_unref (task);
+    }
 
-  g_object_unref ((GtdTask*) data->data);
-  g_free (data);
+  batch_data_return (data, error);
 
   if (error)
     {
-      g_warning ("%s: %s: %s",
+      g_warning ("%s: %s (%u tasks): %s",
                  G_STRFUNC,
                  _("Error removing task"),
+                 data->tasks->len,
                  error->message);
 
       gtd_manager_emit_error_message (gtd_manager_get_default (),
@@ -667,8 +828,222 @@ gtd_provider_eds_remove_task_finished (GObject      *client,
                                       NULL,
                                       NULL);
       g_error_free (error);
+    }
+
+  batch_data_free (data);
+}
+
+static gboolean
+pending_write_is_cancelled (PendingWrite *write)
+{
+  GList *l;
+
+  if (!write->results)
+    return FALSE;
+
+  for (l = write->results; l != NULL; l = l->next)
+    {
+      if (!g_cancellable_is_cancelled (g_task_get_cancellable (l->data)))
+        return FALSE;
+    }
+
+  return TRUE;
+}
+
+/*
+ * Updates and removals of tasks are not sent right away. Instead, they're
+ * grouped per client and sent once per main loop iteration with a single
+ * call, so that operations on many tasks (e.g. clearing completed tasks)
+ * don't flood EDS with one D-Bus call per task.
+ */
+static GHashTable*
+group_pending_tasks_by_client (GHashTable *pending)
+{
+  GHashTable *batches;
+  GHashTableIter iter;
+  PendingWrite *write;
+  gpointer task;
+
+  batches = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+  g_hash_table_iter_init (&iter, pending);
+
+  while (g_hash_table_iter_next (&iter, &task, (gpointer*) &write))
+    {
+      BatchData *batch;
+      GList *l;
+
+      /* Nobody is waiting for this write anymore, so don't send it */
+      if (pending_write_is_cancelled (write))
+        {
+          for (l = write->results; l != NULL; l = l->next)
+            g_task_return_error_if_cancelled (l->data);
+
+          gtd_object_set_ready (GTD_OBJECT (task), TRUE);
+          g_hash_table_iter_remove (&iter);
+          continue;
+        }
+
+      batch = g_hash_table_lookup (batches, write->client);
+
+      if (!batch)
+        {
+          batch = batch_data_new (write->client);
+          g_hash_table_insert (batches, write->client, batch);
+        }
+
+      /* The batch takes over the references held by the pending table */
+      g_ptr_array_add (batch->tasks, task);
+
+      for (l = write->results; l != NULL; l = l->next)
+        g_ptr_array_add (batch->results, l->data);
+
+      g_clear_pointer (&write->results, g_list_free);
+
+      g_hash_table_iter_steal (&iter);
+      pending_write_free (write);
+    }
+
+  return batches;
+}
+
+static void
+gtd_provider_eds_flush_batches (GtdProviderEds *self)
+{
+  GtdProviderEdsPrivate *priv;
+  GHashTableIter iter;
+  GHashTable *batches;
+  BatchData *batch;
+
+  priv = gtd_provider_eds_get_instance_private (self);
+
+  if (priv->flush_batches_id > 0)
+    {
+      g_source_remove (priv->flush_batches_id);
+      priv->flush_batches_id = 0;
+    }
+
+  /* Updates */
+  batches = group_pending_tasks_by_client (priv->pending_updates);
+
+  g_hash_table_iter_init (&iter, batches);
+
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer*) &batch))
+    {
+      GSList *components;
+      guint i;
+
+      components = NULL;
+
+      for (i = 0; i < batch->tasks->len; i++)
+        {
+          ECalComponent *component = gtd_task_get_component (g_ptr_array_index (batch->tasks, i));
+
+          components = g_slist_prepend (components, e_cal_component_get_icalcomponent (component));
+        }
+
+      g_debug ("%s: %s (%u tasks)", G_STRFUNC, "Updating tasks", batch->tasks->len);
+
+      e_cal_client_modify_objects (batch->client,
+                                   components,
+                                   E_CAL_OBJ_MOD_THIS,
+                                   NULL, // We won't cancel the operation
+                                   (GAsyncReadyCallback) gtd_provider_eds_update_tasks_finished,
+                                   batch);
+
+      g_slist_free (components);
+    }
+
+  g_hash_table_destroy (batches);
+
+  /* Removals */
+  batches = group_pending_tasks_by_client (priv->pending_removals);
+
+  g_hash_table_iter_init (&iter, batches);
+
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer*) &batch))
+    {
+      GSList *ids;
+      guint i;
+
+      ids = NULL;
+
+      for (i = 0; i < batch->tasks->len; i++)
+        {
+          ECalComponent *component = gtd_task_get_component (g_ptr_array_index (batch->tasks, i));
+
+          ids = g_slist_prepend (ids, e_cal_component_get_id (component));
+        }
+
+      g_debug ("%s: %s (%u tasks)", G_STRFUNC, "Removing tasks", batch->tasks->len);
+
+      e_cal_client_remove_objects (batch->client,
+                                   ids,
+                                   E_CAL_OBJ_MOD_THIS,
+                                   NULL, // We won't cancel the operation
+                                   (GAsyncReadyCallback) gtd_provider_eds_remove_tasks_finished,
+                                   batch);
+
+      g_slist_free_full (ids, (GDestroyNotify) e_cal_component_free_id);
+    }
+
+  g_hash_table_destroy (batches);
+}
+
+static gboolean
+gtd_provider_eds_flush_batches_cb (gpointer user_data)
+{
+  GtdProviderEds *self = GTD_PROVIDER_EDS (user_data);
+  GtdProviderEdsPrivate *priv = gtd_provider_eds_get_instance_private (self);
+
+  priv->flush_batches_id = 0;
+
+  gtd_provider_eds_flush_batches (self);
+
+  return G_SOURCE_REMOVE;
+}
+
+/* Takes ownership of @operation */
+static void
+gtd_provider_eds_queue_task (GtdProviderEds *self,
+                             GHashTable     *pending,
+                             GtdTask        *task,
+                             GTask          *operation)
+{
+  GtdProviderEdsPrivate *priv;
+  GtdTaskListEds *tasklist;
+  PendingWrite *write;
+  ECalClient *client;
+
+  priv = gtd_provider_eds_get_instance_private (self);
+  tasklist = GTD_TASK_LIST_EDS (gtd_task_get_list (task));
+  client = g_hash_table_lookup (priv->clients, gtd_task_list_eds_get_source (tasklist));
+
+  if (!client)
+    {
+      g_task_return_new_error (operation,
+                               G_IO_ERROR,
+                               G_IO_ERROR_NOT_CONNECTED,
+                               "The task list of this task is not connected");
+      g_object_unref (operation);
       return;
     }
+
+  /* The task is not ready until we finish the operation */
+  gtd_object_set_ready (GTD_OBJECT (task), FALSE);
+
+  write = g_hash_table_lookup (pending, task);
+
+  if (!write)
+    {
+      write = pending_write_new (client);
+      g_hash_table_insert (pending, g_object_ref (task), write);
+    }
+
+  write->results = g_list_prepend (write->results, operation);
+
+  if (priv->flush_batches_id == 0)
+    priv->flush_batches_id = g_idle_add (gtd_provider_eds_flush_batches_cb, self);
 }
 
 static void
@@ -839,6 +1214,17 @@ gtd_provider_eds_init (GtdProviderEds *self)
                                          (GEqualFunc) e_source_equal,
                                          g_object_unref,
                                          g_object_unref);
+
+  priv->pending_sources = g_queue_new ();
+
+  priv->pending_updates = g_hash_table_new_full (g_direct_hash,
+                                                 g_direct_equal,
+                                                 g_object_unref,
+                                                 (GDestroyNotify) pending_write_free);
+  priv->pending_removals = g_hash_table_new_full (g_direct_hash,
+                                                  g_direct_equal,
+                                                  g_object_unref,
+                                                  (GDestroyNotify) pending_write_free);
 }
 
 GtdProviderEds*
@@ -861,16 +1247,43 @@ gtd_provider_eds_get_registry (GtdProviderEds *provider)
   return priv->source_registry;
 }
 
+static GTask*
+gtd_provider_eds_new_operation (GtdProviderEds      *provider,
+                                GtdTask             *task,
+                                gpointer             source_tag,
+                                GCancellable        *cancellable,
+                                GAsyncReadyCallback  callback,
+                                gpointer             user_data)
+{
+  GTask *operation;
+
+  operation = g_task_new (provider, cancellable, callback, user_data);
+  g_task_set_source_tag (operation, source_tag);
+  g_task_set_task_data (operation, g_object_ref (task), g_object_unref);
+
+  return operation;
+}
+
 void
 gtd_provider_eds_create_task (GtdProviderEds *provider,
                               GtdTask        *task)
+{
+  gtd_provider_eds_create_task_async (provider, task, NULL, NULL, NULL);
+}
+
+void
+gtd_provider_eds_create_task_async (GtdProviderEds      *provider,
+                                    GtdTask             *task,
+                                    GCancellable        *cancellable,
+                                    GAsyncReadyCallback  callback,
+                                    gpointer             user_data)
 {
   GtdProviderEdsPrivate *priv;
   GtdTaskListEds *tasklist;
   ECalComponent *component;
   ECalClient *client;
-  TaskData *data;
   ESource *source;
+  GTask *operation;
 
   g_return_if_fail (GTD_IS_TASK (task));
   g_return_if_fail (GTD_IS_TASK_LIST_EDS (gtd_task_get_list (task)));
@@ -881,91 +1294,214 @@ gtd_provider_eds_create_task (GtdProviderEds *provider,
   client = g_hash_table_lookup (priv->clients, source);
   component = gtd_task_get_component (task);
 
-  /* Temporary data for async operation */
-  data = task_data_new (provider, (gpointer) task);
+  operation = gtd_provider_eds_new_operation (provider,
+                                              task,
+                                              gtd_provider_eds_create_task_async,
+                                              cancellable,
+                                              callback,
+                                              user_data);
+
+  if (g_task_return_error_if_cancelled (operation))
+    {
+      g_object_unref (operation);
+      return;
+    }
 
   /* The task is not ready until we finish the operation */
   gtd_object_set_ready (GTD_OBJECT (task), FALSE);
 
+  gtd_task_list_eds_begin_task_creation (tasklist);
+
+  g_object_set_data (G_OBJECT (task), "gtd-creating-task-list", g_object_ref (tasklist));
+
   e_cal_client_create_object (client,
                               e_cal_component_get_icalcomponent (component),
-                              NULL, // We won't cancel the operation
+                              cancellable,
                               (GAsyncReadyCallback) gtd_provider_eds_create_task_finished,
-                              data);
+                              operation);
 }
 
 void
 gtd_provider_eds_update_task (GtdProviderEds *provider,
                               GtdTask        *task)
+{
+  gtd_provider_eds_update_task_async (provider, task, NULL, NULL, NULL);
+}
+
+void
+gtd_provider_eds_update_task_async (GtdProviderEds      *provider,
+                                    GtdTask             *task,
+                                    GCancellable        *cancellable,
+                                    GAsyncReadyCallback  callback,
+                                    gpointer             user_data)
 {
   GtdProviderEdsPrivate *priv;
-  GtdTaskListEds *tasklist;
-  ECalComponent *component;
-  ECalClient *client;
-  TaskData *data;
-  ESource *source;
+  GTask *operation;
 
   g_return_if_fail (GTD_IS_TASK (task));
   g_return_if_fail (GTD_IS_TASK_LIST_EDS (gtd_task_get_list (task)));
 
   priv = gtd_provider_eds_get_instance_private (provider);
-  tasklist = GTD_TASK_LIST_EDS (gtd_task_get_list (task));
-  source = gtd_task_list_eds_get_source (tasklist);
-  client = g_hash_table_lookup (priv->clients, source);
-  component = gtd_task_get_component (task);
 
-  /* Temporary data for async operation */
-  data = task_data_new (provider, (gpointer) task);
+  operation = gtd_provider_eds_new_operation (provider,
+                                              task,
+                                              gtd_provider_eds_update_task_async,
+                                              cancellable,
+                                              callback,
+                                              user_data);
 
-  /* The task is not ready until we finish the operation */
-  gtd_object_set_ready (GTD_OBJECT (task), FALSE);
+  /* No need to update a task that is about to be removed */
+  if (g_hash_table_contains (priv->pending_removals, task))
+    {
+      g_task_return_boolean (operation, TRUE);
+      g_object_unref (operation);
+      return;
+    }
 
-  e_cal_client_modify_object (client,
-                              e_cal_component_get_icalcomponent (component),
-                              E_CAL_OBJ_MOD_THIS,
-                              NULL, // We won't cancel the operation
-                              (GAsyncReadyCallback) gtd_provider_eds_update_task_finished,
-                              data);
+  gtd_provider_eds_queue_task (provider, priv->pending_updates, task, operation);
 }
 
 void
 gtd_provider_eds_remove_task (GtdProviderEds *provider,
                               GtdTask        *task)
 {
+  gtd_provider_eds_remove_task_async (provider, task, NULL, NULL, NULL);
+}
 
+void
+gtd_provider_eds_remove_task_async (GtdProviderEds      *provider,
+                                    GtdTask             *task,
+                                    GCancellable        *cancellable,
+                                    GAsyncReadyCallback  callback,
+                                    gpointer             user_data)
+{
   GtdProviderEdsPrivate *priv;
-  ECalComponent *component;
-  GtdTaskListEds *tasklist;
-  ECalComponentId *id;
-  ECalClient *client;
-  TaskData *data;
-  ESource *source;
+  PendingWrite *update;
+  GTask *operation;
 
   g_return_if_fail (GTD_IS_TASK (task));
   g_return_if_fail (GTD_IS_TASK_LIST_EDS (gtd_task_get_list (task)));
 
   priv = gtd_provider_eds_get_instance_private (provider);
-  tasklist = GTD_TASK_LIST_EDS (gtd_task_get_list (task));
-  source = gtd_task_list_eds_get_source (tasklist);
-  client = g_hash_table_lookup (priv->clients, source);
-  component = gtd_task_get_component (task);
-  id = e_cal_component_get_id (component);
 
-  /* Temporary data for async operation */
-  data = task_data_new (provider, (gpointer) task);
+  operation = gtd_provider_eds_new_operation (provider,
+                                              task,
+                                              gtd_provider_eds_remove_task_async,
+                                              cancellable,
+                                              callback,
+                                              user_data);
 
-  /* The task is not ready until we finish the operation */
-  gtd_object_set_ready (GTD_OBJECT (task), FALSE);
+  /* A pending update is superseded by the removal */
+  update = g_hash_table_lookup (priv->pending_updates, task);
+
+  if (update)
+    {
+      GList *l;
+
+      for (l = update->results; l != NULL; l = l->next)
+        g_task_return_boolean (l->data, TRUE);
+
+      g_hash_table_remove (priv->pending_updates, task);
+    }
+
+  gtd_provider_eds_queue_task (provider, priv->pending_removals, task, operation);
+}
+
+/*
+ * The removals of a batch are all queued in this iteration, so they're
+ * sent together in a single call per client. The batch finishes when the
+ * last of them does.
+ */
+typedef struct
+{
+  guint n_pending;
+  GError *error;
+} RemoveTasksData;
+
+static void
+remove_tasks_data_free (RemoveTasksData *data)
+{
+  g_clear_error (&data->error);
+  g_free (data);
+}
+
+static void
+gtd_provider_eds_remove_tasks_part_cb (GObject      *source,
+                                       GAsyncResult *result,
+                                       gpointer      user_data)
+{
+  RemoveTasksData *data;
+  GTask *batch;
+  GError *error;
+
+  batch = user_data;
+  data = g_task_get_task_data (batch);
+  error = NULL;
+
+  /* Only the first error is reported */
+  if (!g_task_propagate_boolean (G_TASK (result), &error) && !data->error)
+    data->error = g_steal_pointer (&error);
+
+  g_clear_error (&error);
+
+  if (--data->n_pending == 0)
+    {
+      if (data->error)
+        g_task_return_error (batch, g_steal_pointer (&data->error));
+      else
+        g_task_return_boolean (batch, TRUE);
+    }
 
-  e_cal_client_remove_object (client,
-                              id->uid,
-                              id->rid,
-                              E_CAL_OBJ_MOD_THIS,
-                              NULL, // We won't cancel the operation
-                              (GAsyncReadyCallback) gtd_provider_eds_remove_task_finished,
-                              data);
+  g_object_unref (batch);
+}
+
+void
+gtd_provider_eds_remove_tasks_async (GtdProviderEds      *provider,
+                                     GPtrArray           *tasks,
+                                     GCancellable        *cancellable,
+                                     GAsyncReadyCallback  callback,
+                                     gpointer             user_data)
+{
+  RemoveTasksData *data;
+  GTask *batch;
+  guint i;
+
+  batch = g_task_new (provider, cancellable, callback, user_data);
+  g_task_set_source_tag (batch, gtd_provider_eds_remove_tasks_async);
+
+  if (tasks->len == 0)
+    {
+      g_task_return_boolean (batch, TRUE);
+      g_object_unref (batch);
+      return;
+    }
 
-  e_cal_component_free_id (id);
+  data = g_new0 (RemoveTasksData, 1);
+  data->n_pending = tasks->len;
+
+  g_task_set_task_data (batch, data, (GDestroyNotify) remove_tasks_data_free);
+
+  for (i = 0; i < tasks->len; i++)
+    {
+      gtd_provider_eds_remove_task_async (provider,
+                                          g_ptr_array_index (tasks, i),
+                                          cancellable,
+                                          gtd_provider_eds_remove_tasks_part_cb,
+                                          g_object_ref (batch));
+    }
+
+  g_object_unref (batch);
+}
+
+/* Finishes any of the asynchronous task operations above */
+gboolean
+gtd_provider_eds_finish_task_operation (GtdProviderEds  *provider,
+                                        GAsyncResult    *result,
+                                        GError         **error)
+{
+  g_return_val_if_fail (g_task_is_valid (result, provider), FALSE);
+
+  return g_task_propagate_boolean (G_TASK (result), error);
 }
 
 void
@@ -1063,6 +1599,14 @@ gtd_provider_eds_get_task_lists (GtdProviderEds *provider)
   return priv->task_lists;
 }
 
+gboolean
+gtd_provider_eds_get_lists_loaded (GtdProviderEds *provider)
+{
+  GtdProviderEdsPrivate *priv = gtd_provider_eds_get_instance_private (provider);
+
+  return priv->lists_loaded;
+}
+
 GtdTaskList*
 gtd_provider_eds_get_default_task_list (GtdProviderEds *provider)
 {
@@ -51,6 +51,34 @@ void                 gtd_provider_eds_update_task                (GtdProviderEds
 void                 gtd_provider_eds_remove_task                (GtdProviderEds     *provider,
                                                                   GtdTask            *task);
 
+void                 gtd_provider_eds_create_task_async          (GtdProviderEds     *provider,
+                                                                  GtdTask            *task,
+                                                                  GCancellable       *cancellable,
+                                                                  GAsyncReadyCallback callback,
+                                                                  gpointer            user_data);
+
+void                 gtd_provider_eds_update_task_async          (GtdProviderEds     *provider,
+                                                                  GtdTask            *task,
+                                                                  GCancellable       *cancellable,
+                                                                  GAsyncReadyCallback callback,
+                                                                  gpointer            user_data);
+
+void                 gtd_provider_eds_remove_task_async          (GtdProviderEds     *provider,
+                                                                  GtdTask            *task,
+                                                                  GCancellable       *cancellable,
+                                                                  GAsyncReadyCallback callback,
+                                                                  gpointer            user_data);
+
+void                 gtd_provider_eds_remove_tasks_async         (GtdProviderEds     *provider,
+                                                                  GPtrArray          *tasks,
+                                                                  GCancellable       *cancellable,
+                                                                  GAsyncReadyCallback callback,
+                                                                  gpointer            user_data);
+
+gboolean             gtd_provider_eds_finish_task_operation      (GtdProviderEds     *provider,
+                                                                  GAsyncResult       *result,
+                                                                  GError            **error);
+
 void                 gtd_provider_eds_create_task_list           (GtdProviderEds     *provider,
                                                                   GtdTaskList        *list);
 
@@ -62,6 +90,8 @@ void                 gtd_provider_eds_remove_task_list           (GtdProviderEds
 
 GList*               gtd_provider_eds_get_task_lists             (GtdProviderEds     *provider);
 
+gboolean             gtd_provider_eds_get_lists_loaded           (GtdProviderEds     *provider);
+
 GtdTaskList*         gtd_provider_eds_get_default_task_list      (GtdProviderEds     *provider);
 
 void                 gtd_provider_eds_set_default_task_list      (GtdProviderEds     *provider,
@@ -111,6 +111,54 @@ gtd_provider_local_remove_task (GtdProvider *provider,
   gtd_provider_eds_remove_task (GTD_PROVIDER_EDS (provider), task);
 }
 
+static void
+gtd_provider_local_create_task_async (GtdProvider         *provider,
+                                      GtdTask             *task,
+                                      GCancellable        *cancellable,
+                                      GAsyncReadyCallback  callback,
+                                      gpointer             user_data)
+{
+  gtd_provider_eds_create_task_async (GTD_PROVIDER_EDS (provider), task, cancellable, callback, user_data);
+}
+
+static void
+gtd_provider_local_update_task_async (GtdProvider         *provider,
+                                      GtdTask             *task,
+                                      GCancellable        *cancellable,
+                                      GAsyncReadyCallback  callback,
+                                      gpointer             user_data)
+{
+  gtd_provider_eds_update_task_async (GTD_PROVIDER_EDS (provider), task, cancellable, callback, user_data);
+}
+
+static void
+gtd_provider_local_remove_task_async (GtdProvider         *provider,
+                                      GtdTask             *task,
+                                      GCancellable        *cancellable,
+                                      GAsyncReadyCallback  callback,
+                                      gpointer             user_data)
+{
+  gtd_provider_eds_remove_task_async (GTD_PROVIDER_EDS (provider), task, cancellable, callback, user_data);
+}
+
+static void
+gtd_provider_local_remove_tasks_async (GtdProvider         *provider,
+                                        GPtrArray           *tasks,
+                                        GCancellable        *cancellable,
+                                        GAsyncReadyCallback  callback,
+                                        gpointer             user_data)
+{
+  gtd_provider_eds_remove_tasks_async (GTD_PROVIDER_EDS (provider), tasks, cancellable, callback, user_data);
+}
+
+static gboolean
+gtd_provider_local_finish_task_operation (GtdProvider   *provider,
+                                          GAsyncResult  *result,
+                                          GError       **error)
+{
+  return gtd_provider_eds_finish_task_operation (GTD_PROVIDER_EDS (provider), result, error);
+}
+
 static void
 gtd_provider_local_create_task_list (GtdProvider *provider,
                                      GtdTaskList *list)
@@ -183,6 +231,12 @@ gtd_provider_local_get_task_lists (GtdProvider *provider)
   return gtd_provider_eds_get_task_lists (GTD_PROVIDER_EDS (provider));
 }
 
+static gboolean
+gtd_provider_local_get_lists_loaded (GtdProvider *provider)
+{
+  return gtd_provider_eds_get_lists_loaded (GTD_PROVIDER_EDS (provider));
+}
+
 static GtdTaskList*
 gtd_provider_local_get_default_task_list (GtdProvider *provider)
 {
@@ -208,9 +262,18 @@ gtd_provider_iface_init (GtdProviderInterface *iface)
   iface->create_task = gtd_provider_local_create_task;
   iface->update_task = gtd_provider_local_update_task;
   iface->remove_task = gtd_provider_local_remove_task;
+  iface->create_task_async = gtd_provider_local_create_task_async;
+  iface->create_task_finish = gtd_provider_local_finish_task_operation;
+  iface->update_task_async = gtd_provider_local_update_task_async;
+  iface->update_task_finish = gtd_provider_local_finish_task_operation;
+  iface->remove_task_async = gtd_provider_local_remove_task_async;
+  iface->remove_task_finish = gtd_provider_local_finish_task_operation;
+  iface->remove_tasks_async = gtd_provider_local_remove_tasks_async;
+  iface->remove_tasks_finish = gtd_provider_local_finish_task_operation;
   iface->create_task_list = gtd_provider_local_create_task_list;
   iface->update_task_list = gtd_provider_local_update_task_list;
   iface->remove_task_list = gtd_provider_local_remove_task_list;
+  iface->get_lists_loaded = gtd_provider_local_get_lists_loaded;
   iface->get_task_lists = gtd_provider_local_get_task_lists;
   iface->get_default_task_list = gtd_provider_local_get_default_task_list;
   iface->set_default_task_list = gtd_provider_local_set_default_task_list;
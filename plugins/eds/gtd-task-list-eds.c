@@ -20,12 +20,33 @@
 
 #include <glib/gi18n.h>
 
+/* Matches every component of the task list */
+#define TASK_LIST_VIEW_QUERY "contains? \"any\" \"\""
+
+/* Matches incomplete tasks, and tasks completed after the given time */
+#define RECENT_TASKS_VIEW_QUERY "(or (not (is-completed?)) (not (completed-before? (make-time \"%s\"))))"
+
 struct _GtdTaskListEds
 {
   GtdTaskList         parent;
 
   ESource            *source;
 
+  ECalClient         *client;
+  ECalClientView     *view;
+  GCancellable       *view_cancellable;
+  gint64              view_start_time;
+
+  /* Whether completed tasks older than the window are loaded */
+  gboolean            completed_tasks_loaded;
+
+  /* UID → ECalComponent, or NULL for removed components */
+  GHashTable         *pending_changes;
+  guint               pending_changes_id;
+
+  /* Tasks of this list being created, that may still change their UID */
+  guint               n_creating_tasks;
+
   GCancellable       *cancellable;
 };
 
@@ -33,6 +54,7 @@ G_DEFINE_TYPE (GtdTaskListEds, gtd_task_list_eds, GTD_TYPE_TASK_LIST)
 
 enum {
   PROP_0,
+  PROP_CLIENT,
   PROP_SOURCE,
   N_PROPS
 };
@@ -72,6 +94,361 @@ save_task_list_finished_cb (GObject      *source,
     }
 }
 
+/*
+ * ECalClientView
+ *
+ * Changes reported by the view are coalesced per component UID and
+ * applied once per main loop iteration, so that bulk changes made by
+ * other clients don't update the same task many times.
+ */
+static void
+pending_change_free (ECalComponent *component)
+{
+  if (component)
+    g_object_unref (component);
+}
+
+static void
+update_task_from_component (GtdTask       *task,
+                            ECalComponent *component)
+{
+  g_autoptr (GDateTime) due_date = NULL;
+  g_autoptr (GtdTask) updated = NULL;
+
+  updated = gtd_task_new (component);
+  due_date = gtd_task_get_due_date (updated);
+
+  gtd_task_set_title (task, gtd_task_get_title (updated));
+  gtd_task_set_priority (task, gtd_task_get_priority (updated));
+  gtd_task_set_due_date (task, due_date);
+  gtd_task_set_complete (task, gtd_task_get_complete (updated));
+
+  if (g_strcmp0 (gtd_task_get_description (task), gtd_task_get_description (updated)) != 0)
+    gtd_task_set_description (task, gtd_task_get_description (updated));
+}
+
+static void
+update_task_parent (GtdTaskList   *list,
+                    GtdTask       *task,
+                    ECalComponent *component)
+{
+  icalcomponent *ical_comp;
+  icalproperty *property;
+  GtdTask *old_parent;
+  GtdTask *new_parent;
+
+  ical_comp = e_cal_component_get_icalcomponent (component);
+  property = icalcomponent_get_first_property (ical_comp, ICAL_RELATEDTO_PROPERTY);
+  old_parent = gtd_task_get_parent (task);
+  new_parent = NULL;
+
+  if (property)
+    {
+      new_parent = gtd_task_list_get_task_by_id (list, icalproperty_get_relatedto (property));
+
+      /* The parent isn't loaded yet, keep the current one until it is */
+      if (!new_parent)
+        return;
+    }
+
+  if (new_parent == old_parent)
+    return;
+
+  if (new_parent)
+    gtd_task_add_subtask (new_parent, task);
+  else
+    gtd_task_remove_subtask (old_parent, task);
+}
+
+static gboolean
+apply_pending_changes_cb (gpointer user_data)
+{
+  g_autoptr (GHashTable) changes = NULL;
+  GtdTaskListEds *self;
+  GtdTaskList *list;
+  GHashTableIter iter;
+  gpointer uid;
+  gpointer component;
+
+  self = GTD_TASK_LIST_EDS (user_data);
+  list = GTD_TASK_LIST (self);
+
+  self->pending_changes_id = 0;
+
+  /* Steal the current batch, new changes go to the next one */
+  changes = self->pending_changes;
+  self->pending_changes = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) pending_change_free);
+
+  g_hash_table_iter_init (&iter, changes);
+
+  while (g_hash_table_iter_next (&iter, &uid, &component))
+    {
+      GtdTask *task;
+
+      task = gtd_task_list_get_task_by_id (list, uid);
+
+      if (!component)
+        {
+          if (task)
+            {
+              gtd_task_list_remove_task (list, task);
+              g_object_unref (task);
+            }
+
+          continue;
+        }
+
+      if (task)
+        {
+          update_task_from_component (task, component);
+        }
+      else if (self->n_creating_tasks > 0)
+        {
+          /*
+           * The view may report a task created by us before the creation
+           * finishes and gives the task its final UID. Wait until then,
+           * so the task isn't added twice.
+           */
+          g_hash_table_insert (self->pending_changes, g_strdup (uid), g_object_ref (component));
+        }
+      else
+        {
+          task = gtd_task_new (component);
+          gtd_task_set_list (task, list);
+
+          gtd_task_list_save_task (list, task);
+        }
+    }
+
+  /* Parents may be among the tasks added above, so apply RELATED-TO last */
+  g_hash_table_iter_init (&iter, changes);
+
+  while (g_hash_table_iter_next (&iter, &uid, &component))
+    {
+      GtdTask *task;
+
+      if (!component)
+        continue;
+
+      task = gtd_task_list_get_task_by_id (list, uid);
+
+      if (task)
+        update_task_parent (list, task, component);
+    }
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+queue_change (GtdTaskListEds *self,
+              const gchar    *uid,
+              ECalComponent  *component)
+{
+  g_hash_table_insert (self->pending_changes, g_strdup (uid), component);
+
+  if (self->pending_changes_id == 0)
+    self->pending_changes_id = g_idle_add (apply_pending_changes_cb, self);
+}
+
+static void
+view_objects_changed_cb (ECalClientView *view,
+                         const GSList   *objects,
+                         GtdTaskListEds *self)
+{
+  const GSList *l;
+
+  for (l = objects; l != NULL; l = l->next)
+    {
+      ECalComponent *component;
+      const gchar *uid;
+
+      component = e_cal_component_new_from_icalcomponent (icalcomponent_new_clone (l->data));
+
+      if (!component)
+        continue;
+
+      e_cal_component_get_uid (component, &uid);
+
+      queue_change (self, uid, component);
+    }
+}
+
+static void
+view_objects_removed_cb (ECalClientView *view,
+                         const GSList   *ids,
+                         GtdTaskListEds *self)
+{
+  const GSList *l;
+
+  for (l = ids; l != NULL; l = l->next)
+    {
+      ECalComponentId *id = l->data;
+
+      queue_change (self, id->uid, NULL);
+    }
+}
+
+static void
+view_complete_cb (ECalClientView *view,
+                  const GError   *error,
+                  GtdTaskListEds *self)
+{
+  gtd_object_set_ready (GTD_OBJECT (self), TRUE);
+
+  if (error)
+    {
+      g_warning ("%s: %s: %s",
+                 G_STRFUNC,
+                 _("Error fetching tasks from list"),
+                 error->message);
+
+      gtd_manager_emit_error_message (gtd_manager_get_default (),
+                                      _("Error fetching tasks from list"),
+                                      error->message,
+                                      NULL,
+                                      NULL);
+      return;
+    }
+
+  g_debug ("%s: %s (%s): initial tasks fetched in %.1f ms",
+           G_STRFUNC,
+           "Task list view complete",
+           e_source_get_display_name (self->source),
+           (g_get_monotonic_time () - self->view_start_time) / 1000.0);
+}
+
+static void
+client_view_ready_cb (GObject      *source,
+                      GAsyncResult *result,
+                      gpointer      user_data)
+{
+  g_autoptr (GCancellable) cancellable = NULL;
+  GtdTaskListEds *self;
+  ECalClientView *view;
+  GError *error;
+
+  cancellable = G_CANCELLABLE (user_data);
+  view = NULL;
+  error = NULL;
+
+  e_cal_client_get_view_finish (E_CAL_CLIENT (source), result, &view, &error);
+
+  /*
+   * The view was stopped, or replaced by another one, meanwhile. The
+   * request may still have succeeded, and the list may be gone.
+   */
+  if (g_cancellable_is_cancelled (cancellable) ||
+      g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+    {
+      g_clear_object (&view);
+      g_clear_error (&error);
+      return;
+    }
+
+  self = GTD_TASK_LIST_EDS (g_object_get_data (G_OBJECT (cancellable), "task-list"));
+
+  if (error)
+    {
+      gtd_object_set_ready (GTD_OBJECT (self), TRUE);
+
+      g_warning ("%s: %s: %s",
+                 G_STRFUNC,
+                 _("Error fetching tasks from list"),
+                 error->message);
+
+      gtd_manager_emit_error_message (gtd_manager_get_default (),
+                                      _("Error fetching tasks from list"),
+                                      error->message,
+                                      NULL,
+                                      NULL);
+
+      g_clear_error (&error);
+      return;
+    }
+
+  self->view = view;
+
+  g_signal_connect (view, "objects-added", G_CALLBACK (view_objects_changed_cb), self);
+  g_signal_connect (view, "objects-modified", G_CALLBACK (view_objects_changed_cb), self);
+  g_signal_connect (view, "objects-removed", G_CALLBACK (view_objects_removed_cb), self);
+  g_signal_connect (view, "complete", G_CALLBACK (view_complete_cb), self);
+
+  e_cal_client_view_start (view, &error);
+
+  if (error)
+    {
+      g_warning ("%s: %s: %s",
+                 G_STRFUNC,
+                 _("Error fetching tasks from list"),
+                 error->message);
+
+      gtd_object_set_ready (GTD_OBJECT (self), TRUE);
+      g_clear_error (&error);
+    }
+}
+
+static gchar*
+build_view_query (GtdTaskListEds *self)
+{
+  g_autoptr (GSettings) settings = NULL;
+  g_autofree gchar *since = NULL;
+  guint window;
+
+  if (self->completed_tasks_loaded)
+    return g_strdup (TASK_LIST_VIEW_QUERY);
+
+  settings = g_settings_new ("org.gnome.todo.plugins.eds");
+  window = g_settings_get_uint (settings, "completed-tasks-window");
+  since = isodate_from_time_t (time (NULL) - (time_t) window * 24 * 60 * 60);
+
+  return g_strdup_printf (RECENT_TASKS_VIEW_QUERY, since);
+}
+
+static void
+start_view (GtdTaskListEds *self)
+{
+  g_autofree gchar *query = NULL;
+
+  query = build_view_query (self);
+
+  self->view_cancellable = g_cancellable_new ();
+  self->view_start_time = g_get_monotonic_time ();
+
+  /* The list is finalized only after the view is stopped, which cancels it */
+  g_object_set_data (G_OBJECT (self->view_cancellable), "task-list", self);
+
+  g_debug ("%s: %s (%s): %s",
+           G_STRFUNC,
+           "Starting task list view",
+           e_source_get_display_name (self->source),
+           query);
+
+  e_cal_client_get_view (self->client,
+                         query,
+                         self->view_cancellable,
+                         client_view_ready_cb,
+                         g_object_ref (self->view_cancellable));
+}
+
+static void
+stop_view (GtdTaskListEds *self)
+{
+  /* The view may still be being created */
+  if (self->view_cancellable)
+    {
+      g_cancellable_cancel (self->view_cancellable);
+      g_clear_object (&self->view_cancellable);
+    }
+
+  if (!self->view)
+    return;
+
+  g_signal_handlers_disconnect_by_data (self->view, self);
+  e_cal_client_view_stop (self->view, NULL);
+
+  g_clear_object (&self->view);
+}
+
 static void
 save_task_list (GtdTaskListEds *list)
 {
@@ -88,6 +465,31 @@ save_task_list (GtdTaskListEds *list)
                       list);
     }
 }
+
+/*
+ * GtdTaskList overrides
+ */
+static void
+gtd_task_list_eds_load_completed_tasks (GtdTaskList *list)
+{
+  GtdTaskListEds *self = GTD_TASK_LIST_EDS (list);
+
+  if (self->completed_tasks_loaded)
+    return;
+
+  self->completed_tasks_loaded = TRUE;
+
+  /*
+   * Replace the view by one that matches every task. Tasks that are
+   * already loaded are reported again, and are left untouched.
+   */
+  if (self->client)
+    {
+      stop_view (self);
+      start_view (self);
+    }
+}
+
 static gboolean
 color_to_string (GBinding     *binding,
                  const GValue *from_value,
@@ -130,7 +532,17 @@ gtd_task_list_eds_finalize (GObject *object)
 
   g_cancellable_cancel (self->cancellable);
 
+  if (self->pending_changes_id > 0)
+    {
+      g_source_remove (self->pending_changes_id);
+      self->pending_changes_id = 0;
+    }
+
+  stop_view (self);
+
+  g_clear_pointer (&self->pending_changes, g_hash_table_destroy);
   g_clear_object (&self->cancellable);
+  g_clear_object (&self->client);
   g_clear_object (&self->source);
 
   G_OBJECT_CLASS (gtd_task_list_eds_parent_class)->finalize (object);
@@ -146,6 +558,10 @@ gtd_task_list_eds_get_property (GObject    *object,
 
   switch (prop_id)
     {
+    case PROP_CLIENT:
+      g_value_set_object (value, self->client);
+      break;
+
     case PROP_SOURCE:
       g_value_set_object (value, self->source);
       break;
@@ -165,6 +581,10 @@ gtd_task_list_eds_set_property (GObject      *object,
 
   switch (prop_id)
     {
+    case PROP_CLIENT:
+      gtd_task_list_eds_set_client (self, g_value_get_object (value));
+      break;
+
     case PROP_SOURCE:
       gtd_task_list_eds_set_source (self, g_value_get_object (value));
       break;
@@ -177,12 +597,28 @@ gtd_task_list_eds_set_property (GObject      *object,
 static void
 gtd_task_list_eds_class_init (GtdTaskListEdsClass *klass)
 {
+  GtdTaskListClass *task_list_class = GTD_TASK_LIST_CLASS (klass);
   GObjectClass *object_class = G_OBJECT_CLASS (klass);
 
+  task_list_class->load_completed_tasks = gtd_task_list_eds_load_completed_tasks;
+
   object_class->finalize = gtd_task_list_eds_finalize;
   object_class->get_property = gtd_task_list_eds_get_property;
   object_class->set_property = gtd_task_list_eds_set_property;
 
+  /**
+   * GtdTaskListEds::client:
+   *
+   * The #ECalClient this list receives its tasks from.
+   */
+  g_object_class_install_property (object_class,
+                                   PROP_CLIENT,
+                                   g_param_spec_object ("client",
+                                                        "ECalClient of this list",
+                                                        "The ECalClient of this list",
+                                                        E_TYPE_CAL_CLIENT,
+                                                        G_PARAM_READWRITE));
+
   /**
    * GtdTaskListEds::source:
    *
@@ -200,6 +636,7 @@ gtd_task_list_eds_class_init (GtdTaskListEdsClass *klass)
 static void
 gtd_task_list_eds_init (GtdTaskListEds *self)
 {
+  self->pending_changes = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) pending_change_free);
 }
 
 GtdTaskListEds*
@@ -249,6 +686,9 @@ gtd_task_list_eds_set_source (GtdTaskListEds *list,
                                    list,
                                    NULL);
 
+      /* The source uid identifies the list across sessions */
+      gtd_object_set_uid (GTD_OBJECT (list), e_source_get_uid (source));
+
       /* Setup tasklist name */
       gtd_task_list_set_name (GTD_TASK_LIST (list), e_source_get_display_name (source));
 
@@ -282,3 +722,83 @@ gtd_task_list_eds_set_source (GtdTaskListEds *list,
       g_object_notify (G_OBJECT (list), "source");
     }
 }
+
+ECalClient*
+gtd_task_list_eds_get_client (GtdTaskListEds *list)
+{
+  g_return_val_if_fail (GTD_IS_TASK_LIST_EDS (list), NULL);
+
+  return list->client;
+}
+
+/**
+ * gtd_task_list_eds_set_client:
+ * @list: a #GtdTaskListEds
+ * @client: (nullable): an #ECalClient, or %NULL
+ *
+ * Sets the client of @list. The tasks of @list are kept in sync with
+ * an #ECalClientView on @client, so changes made by other EDS clients
+ * show up without reloading. @list is not ready until the view reports
+ * the initial set of tasks.
+ *
+ * Only incomplete and recently completed tasks are loaded at first, see
+ * gtd_task_list_load_completed_tasks().
+ */
+void
+gtd_task_list_eds_set_client (GtdTaskListEds *list,
+                              ECalClient     *client)
+{
+  g_return_if_fail (GTD_IS_TASK_LIST_EDS (list));
+
+  if (!g_set_object (&list->client, client))
+    return;
+
+  stop_view (list);
+
+  if (client)
+    {
+      gtd_object_set_ready (GTD_OBJECT (list), FALSE);
+      start_view (list);
+    }
+
+  g_object_notify (G_OBJECT (list), "client");
+}
+
+/**
+ * gtd_task_list_eds_begin_task_creation:
+ * @list: a #GtdTaskListEds
+ *
+ * Tells @list that one of its tasks is being created. Until the creation
+ * ends, tasks reported by the view with unknown UIDs are not added, since
+ * they may be the task being created under the UID given by the server.
+ */
+void
+gtd_task_list_eds_begin_task_creation (GtdTaskListEds *list)
+{
+  g_return_if_fail (GTD_IS_TASK_LIST_EDS (list));
+
+  list->n_creating_tasks++;
+}
+
+/**
+ * gtd_task_list_eds_end_task_creation:
+ * @list: a #GtdTaskListEds
+ *
+ * Tells @list that the creation of one of its tasks ended, and that the
+ * task has its final UID.
+ */
+void
+gtd_task_list_eds_end_task_creation (GtdTaskListEds *list)
+{
+  g_return_if_fail (GTD_IS_TASK_LIST_EDS (list));
+  g_return_if_fail (list->n_creating_tasks > 0);
+
+  list->n_creating_tasks--;
+
+  if (list->n_creating_tasks == 0 &&
+      list->pending_changes_id == 0 &&
+      g_hash_table_size (list->pending_changes) > 0)
+    {
+      list->pending_changes_id = g_idle_add (apply_pending_changes_cb, list);
+    }
+}
@@ -37,6 +37,15 @@ ESource*             gtd_task_list_eds_get_source                (GtdTaskListEds
 void                 gtd_task_list_eds_set_source                (GtdTaskListEds     *list,
                                                                   ESource            *source);
 
+ECalClient*          gtd_task_list_eds_get_client                (GtdTaskListEds     *list);
+
+void                 gtd_task_list_eds_set_client                (GtdTaskListEds     *list,
+                                                                  ECalClient         *client);
+
+void                 gtd_task_list_eds_begin_task_creation       (GtdTaskListEds     *list);
+
+void                 gtd_task_list_eds_end_task_creation         (GtdTaskListEds     *list);
+
 G_END_DECLS
 
 #endif /* GTD_TASK_LIST_EDS_H */
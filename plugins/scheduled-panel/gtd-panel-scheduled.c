@@ -29,11 +29,33 @@ struct _GtdPanelScheduled
   GMenu              *menu;
 
   gchar              *title;
-  guint               number_of_tasks;
-  GList              *task_list;
   GtkWidget          *view;
+
+  /* Follows the tasks with a due date */
+  GtdTaskTracker     *tracker;
+
+  /* GtdTask → GINT_TO_POINTER (day), for the tracked tasks */
+  GHashTable         *tasks;
+
+  /* Day → Bucket */
+  GHashTable         *buckets;
+  gint                today;
 };
 
+/*
+ * Tasks due on the same day share the header. Days are represented by
+ * their Julian day number, so they can be compared and subtracted as
+ * plain integers.
+ */
+typedef struct
+{
+  gint                day;
+  guint               n_tasks;
+
+  GtkWidget          *header;
+  GtkWidget          *label;
+} Bucket;
+
 static void          gtd_panel_iface_init                        (GtdPanelInterface  *iface);
 
 G_DEFINE_TYPE_EXTENDED (GtdPanelScheduled, gtd_panel_scheduled, GTK_TYPE_BOX,
@@ -51,50 +73,45 @@ enum {
   N_PROPS
 };
 
-static void
-get_date_offset (GDateTime *dt,
-                 gint      *days_diff,
-                 gint      *next_year_diff)
+static gint
+get_day_for_date (GDateTime *dt)
 {
-  g_autoptr (GDateTime) now, next_year;
-
-  now = g_date_time_new_now_local ();
+  GDate date;
 
-  next_year = g_date_time_new_utc (g_date_time_get_year (now) + 1,
-                                   G_DATE_JANUARY,
-                                   1,
-                                   0, 0, 0);
+  g_date_clear (&date, 1);
+  g_date_set_dmy (&date,
+                  g_date_time_get_day_of_month (dt),
+                  g_date_time_get_month (dt),
+                  g_date_time_get_year (dt));
 
-  if (g_date_time_get_year (dt) == g_date_time_get_year (now))
-    {
-      if (days_diff)
-        *days_diff = g_date_time_get_day_of_year (dt) - g_date_time_get_day_of_year (now);
-    }
-  else
-    {
-      if (next_year_diff)
-        *next_year_diff = g_date_time_difference (dt, now) / G_TIME_SPAN_DAY;
-    }
-
-  if (next_year_diff)
-    *next_year_diff = g_date_time_difference (next_year, now) / G_TIME_SPAN_DAY;
+  return g_date_get_julian (&date);
 }
 
 static gchar*
-get_string_for_date (GDateTime *dt,
-                     gint      *span)
+get_string_for_day (gint  day,
+                    gint  today)
 {
+  g_autoptr (GDateTime) dt = NULL;
+  GDate next_year;
+  GDate date;
   gchar *str;
   gint days_diff;
   gint next_year_diff;
 
-  /* This case should never happen */
-  if (!dt)
-    return g_strdup (_("No date set"));
+  g_date_clear (&date, 1);
+  g_date_set_julian (&date, day);
+
+  g_date_clear (&next_year, 1);
+  g_date_set_julian (&next_year, today);
+  g_date_set_dmy (&next_year, 1, G_DATE_JANUARY, g_date_get_year (&next_year) + 1);
 
-  days_diff = next_year_diff = 0;
+  dt = g_date_time_new_local (g_date_get_year (&date),
+                              g_date_get_month (&date),
+                              g_date_get_day (&date),
+                              0, 0, 0);
 
-  get_date_offset (dt, &days_diff, &next_year_diff);
+  days_diff = day - today;
+  next_year_diff = g_date_get_julian (&next_year) - today;
 
   if (days_diff < 0)
     {
@@ -121,36 +138,25 @@ get_string_for_date (GDateTime *dt,
       str = g_strdup_printf ("%d", g_date_time_get_year (dt));
     }
 
-  if (span)
-    *span = days_diff;
-
   return str;
 }
 
 static GtkWidget*
-create_label (const gchar *text,
-              gint         span,
-              gboolean     first_header)
+create_label (GtkWidget **label)
 {
-  GtkStyleContext *context;
-  GtkWidget *label;
   GtkWidget *box;
 
-  label = g_object_new (GTK_TYPE_LABEL,
-                        "label", text,
-                        "margin-left", 12,
-                        "margin-bottom", 6,
-                        "margin-top", first_header ? 6 : 18,
-                        "xalign", 0.0,
-                        "hexpand", TRUE,
-                        NULL);
-
-  context = gtk_widget_get_style_context (label);
-  gtk_style_context_add_class (context, span < 0 ? "date-overdue" : "date-scheduled");
+  *label = g_object_new (GTK_TYPE_LABEL,
+                         "margin-left", 12,
+                         "margin-bottom", 6,
+                         "margin-top", 18,
+                         "xalign", 0.0,
+                         "hexpand", TRUE,
+                         NULL);
 
   box = gtk_box_new (GTK_ORIENTATION_VERTICAL, 0);
 
-  gtk_container_add (GTK_CONTAINER (box), label);
+  gtk_container_add (GTK_CONTAINER (box), *label);
   gtk_container_add (GTK_CONTAINER (box), gtk_separator_new (GTK_ORIENTATION_HORIZONTAL));
 
   gtk_widget_show_all (box);
@@ -158,14 +164,90 @@ create_label (const gchar *text,
   return box;
 }
 
+/*
+ * Buckets
+ */
+static void
+bucket_update_label (Bucket *bucket,
+                     gint    today)
+{
+  g_autofree gchar *text = NULL;
+  GtkStyleContext *context;
+  gboolean overdue;
+
+  text = get_string_for_day (bucket->day, today);
+  overdue = bucket->day < today;
+
+  gtk_label_set_label (GTK_LABEL (bucket->label), text);
+
+  context = gtk_widget_get_style_context (bucket->label);
+  gtk_style_context_remove_class (context, overdue ? "date-scheduled" : "date-overdue");
+  gtk_style_context_add_class (context, overdue ? "date-overdue" : "date-scheduled");
+}
+
+static Bucket*
+bucket_new (gint day,
+            gint today)
+{
+  Bucket *bucket;
+
+  bucket = g_new0 (Bucket, 1);
+  bucket->day = day;
+  bucket->header = g_object_ref_sink (create_label (&bucket->label));
+
+  bucket_update_label (bucket, today);
+
+  return bucket;
+}
+
+static void
+bucket_free (Bucket *bucket)
+{
+  g_clear_object (&bucket->header);
+  g_free (bucket);
+}
+
+static void
+add_task_to_bucket (GtdPanelScheduled *panel,
+                    gint               day)
+{
+  Bucket *bucket;
+
+  bucket = g_hash_table_lookup (panel->buckets, GINT_TO_POINTER (day));
+
+  if (!bucket)
+    {
+      bucket = bucket_new (day, panel->today);
+      g_hash_table_insert (panel->buckets, GINT_TO_POINTER (day), bucket);
+    }
+
+  bucket->n_tasks++;
+}
+
+static void
+remove_task_from_bucket (GtdPanelScheduled *panel,
+                         gint               day)
+{
+  Bucket *bucket;
+
+  bucket = g_hash_table_lookup (panel->buckets, GINT_TO_POINTER (day));
+
+  g_return_if_fail (bucket != NULL);
+
+  if (--bucket->n_tasks == 0)
+    g_hash_table_remove (panel->buckets, GINT_TO_POINTER (day));
+}
+
 static gint
-compare_by_date (GDateTime *d1,
-                 GDateTime *d2)
+get_day_for_task (GtdPanelScheduled *panel,
+                  GtdTask           *task)
 {
-  if (g_date_time_get_year (d1) != g_date_time_get_year (d2))
-    return g_date_time_get_year (d1) - g_date_time_get_year (d2);
+  gpointer day;
+
+  if (!g_hash_table_lookup_extended (panel->tasks, task, NULL, &day))
+    return G_MAXINT;
 
-  return g_date_time_get_day_of_year (d1) - g_date_time_get_day_of_year (d2);
+  return GPOINTER_TO_INT (day);
 }
 
 static void
@@ -175,47 +257,30 @@ gtd_panel_scheduled_header_func (GtkListBoxRow     *row,
                                  GtdTask           *before_task,
                                  GtdPanelScheduled *panel)
 {
-  GDateTime *dt;
-  gchar *text;
-  gint span;
+  Bucket *bucket;
+  gint day;
 
-  dt = gtd_task_get_due_date (row_task);
+  day = get_day_for_task (panel, row_task);
 
-  if (!before)
+  /* Only the first task of each day gets the header */
+  if (before && day == get_day_for_task (panel, before_task))
     {
-      text = get_string_for_date (dt, &span);
-
-      gtk_list_box_row_set_header (row, create_label (text,
-                                                      span,
-                                                      TRUE));
-
-      g_free (text);
+      gtk_list_box_row_set_header (row, NULL);
+      return;
     }
-  else
-    {
-      GDateTime *before_dt;
-      gint diff;
-
-      before_dt = gtd_task_get_due_date (before_task);
-      diff = compare_by_date (before_dt, dt);
 
-      if (diff != 0)
-        {
-          text = get_string_for_date (dt, &span);
+  bucket = g_hash_table_lookup (panel->buckets, GINT_TO_POINTER (day));
 
-          gtk_list_box_row_set_header (row, create_label (text, span, FALSE));
-
-          g_free (text);
-        }
-      else
-        {
-          gtk_list_box_row_set_header (row, NULL);
-        }
-
-      g_clear_pointer (&before_dt, g_date_time_unref);
+  if (!bucket)
+    {
+      gtk_list_box_row_set_header (row, NULL);
+      return;
     }
 
-  g_clear_pointer (&dt, g_date_time_unref);
+  gtk_widget_set_margin_top (bucket->label, before ? 18 : 6);
+
+  if (gtk_list_box_row_get_header (row) != bucket->header)
+    gtk_list_box_row_set_header (row, bucket->header);
 }
 
 static gint
@@ -238,21 +303,8 @@ gtd_panel_scheduled_sort_func (GtkListBoxRow     *row1,
   if (!row2_task)
     return -1;
 
-  /* First, compare by ::due-date. */
-  dt1 = gtd_task_get_due_date (row1_task);
-  dt2 = gtd_task_get_due_date (row2_task);
-
-  if (!dt1 && !dt2)
-    retval = 0;
-  else if (!dt1)
-    retval = 1;
-  else if (!dt2)
-    retval = -1;
-  else
-    retval = compare_by_date (dt1, dt2);
-
-  g_clear_pointer (&dt1, g_date_time_unref);
-  g_clear_pointer (&dt2, g_date_time_unref);
+  /* First, compare by ::due-date. Tasks without a due date go last. */
+  retval = get_day_for_task (panel, row1_task) - get_day_for_task (panel, row2_task);
 
   if (retval != 0)
     return retval;
@@ -302,79 +354,116 @@ gtd_panel_scheduled_sort_func (GtkListBoxRow     *row1,
   return retval;
 }
 
+/*
+ * Task tracking
+ */
 static void
-gtd_panel_scheduled_count_tasks (GtdPanelScheduled *panel)
+update_title (GtdPanelScheduled *panel)
 {
-  g_autoptr (GDateTime) now;
-  GtdManager *manager;
-  GList *tasklists;
-  GList *l;
   guint number_of_tasks;
 
-  now = g_date_time_new_now_local ();
-  manager = gtd_manager_get_default ();
-  tasklists = gtd_manager_get_task_lists (manager);
-  number_of_tasks = 0;
+  number_of_tasks = gtd_task_tracker_get_n_incomplete_tasks (panel->tracker);
 
-  g_clear_pointer (&panel->task_list, g_list_free);
+  g_clear_pointer (&panel->title, g_free);
 
-  /* Recount tasks */
-  for (l = tasklists; l != NULL; l = l->next)
+  if (number_of_tasks == 0)
+    {
+      panel->title = g_strdup (_("Scheduled"));
+    }
+  else
     {
-      GList *tasks;
-      GList *t;
+      panel->title = g_strdup_printf ("%s (%d)",
+                                      _("Scheduled"),
+                                      number_of_tasks);
+    }
 
-      tasks = gtd_task_list_get_tasks (l->data);
+  g_object_notify (G_OBJECT (panel), "title");
+}
 
-      for (t = tasks; t != NULL; t = t->next)
-        {
-          GDateTime *task_dt;
+static gboolean
+is_task_scheduled (GtdTask           *task,
+                   GtdPanelScheduled *panel)
+{
+  g_autoptr (GDateTime) due_date = NULL;
 
-          task_dt = gtd_task_get_due_date (t->data);
+  due_date = gtd_task_get_due_date (task);
 
-          /*
-           * GtdTaskListView automagically updates the list
-           * whever a task is added/removed/changed.
-           */
-          if (task_dt)
-            {
-              panel->task_list = g_list_prepend (panel->task_list, t->data);
+  return due_date != NULL;
+}
 
-              if (!gtd_task_get_complete (t->data))
-                number_of_tasks++;
-            }
+static gint
+get_due_day (GtdTask *task)
+{
+  g_autoptr (GDateTime) due_date = NULL;
 
-          g_clear_pointer (&task_dt, g_date_time_unref);
-        }
+  due_date = gtd_task_get_due_date (task);
 
-      g_list_free (tasks);
-    }
+  return get_day_for_date (due_date);
+}
 
-  /* Add the tasks to the view */
-  gtd_task_list_view_set_list (GTD_TASK_LIST_VIEW (panel->view), panel->task_list);
-  gtd_task_list_view_set_default_date (GTD_TASK_LIST_VIEW (panel->view), now);
+static void
+on_task_added_cb (GtdTaskTracker    *tracker,
+                  GtdTask           *task,
+                  GtdPanelScheduled *panel)
+{
+  gint day;
 
-  if (number_of_tasks != panel->number_of_tasks)
-    {
-      panel->number_of_tasks = number_of_tasks;
-
-      /* Update title */
-      g_clear_pointer (&panel->title, g_free);
-      if (number_of_tasks == 0)
-        {
-          panel->title = g_strdup (_("Scheduled"));
-        }
-      else
-        {
-          panel->title = g_strdup_printf ("%s (%d)",
-                                          _("Scheduled"),
-                                          panel->number_of_tasks);
-        }
-
-      g_object_notify (G_OBJECT (panel), "title");
-    }
+  day = get_due_day (task);
+
+  g_hash_table_insert (panel->tasks, task, GINT_TO_POINTER (day));
+  add_task_to_bucket (panel, day);
+}
+
+static void
+on_task_removed_cb (GtdTaskTracker    *tracker,
+                    GtdTask           *task,
+                    GtdPanelScheduled *panel)
+{
+  remove_task_from_bucket (panel, get_day_for_task (panel, task));
+  g_hash_table_remove (panel->tasks, task);
+}
+
+/* Moves the task to another bucket if its due date changed */
+static void
+on_task_updated_cb (GtdTaskTracker    *tracker,
+                    GtdTask           *task,
+                    GtdPanelScheduled *panel)
+{
+  gint old_day;
+  gint day;
+
+  old_day = get_day_for_task (panel, task);
+  day = get_due_day (task);
+
+  if (old_day == day)
+    return;
+
+  remove_task_from_bucket (panel, old_day);
+  add_task_to_bucket (panel, day);
+
+  g_hash_table_insert (panel->tasks, task, GINT_TO_POINTER (day));
+}
+
+/*
+ * Headers are relative to the current day, so they're relabeled in place
+ * when the day changes. Tasks keep their buckets.
+ */
+static void
+on_day_changed_cb (GtdPanelScheduled *panel)
+{
+  g_autoptr (GDateTime) now = NULL;
+  GHashTableIter iter;
+  Bucket *bucket;
+
+  now = g_date_time_new_now_local ();
+  panel->today = get_day_for_date (now);
+
+  g_hash_table_iter_init (&iter, panel->buckets);
 
-  g_list_free (tasklists);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer*) &bucket))
+    bucket_update_label (bucket, panel->today);
+
+  gtd_task_list_view_set_default_date (GTD_TASK_LIST_VIEW (panel->view), now);
 }
 
 /**********************
@@ -420,7 +509,9 @@ gtd_panel_scheduled_finalize (GObject *object)
 
   g_clear_object (&self->menu);
   g_clear_pointer (&self->title, g_free);
-  g_clear_pointer (&self->task_list, g_list_free);
+  g_clear_object (&self->tracker);
+  g_clear_pointer (&self->tasks, g_hash_table_destroy);
+  g_clear_pointer (&self->buckets, g_hash_table_destroy);
 
   G_OBJECT_CLASS (gtd_panel_scheduled_parent_class)->finalize (object);
 }
@@ -478,30 +569,15 @@ gtd_panel_scheduled_class_init (GtdPanelScheduledClass *klass)
 static void
 gtd_panel_scheduled_init (GtdPanelScheduled *self)
 {
+  g_autoptr (GDateTime) now = NULL;
   GtdManager *manager;
 
-  /* Connect to GtdManager::list-* signals to update the title */
   manager = gtd_manager_get_default ();
+  now = g_date_time_new_now_local ();
 
-  g_signal_connect_swapped (manager,
-                            "list-added",
-                            G_CALLBACK (gtd_panel_scheduled_count_tasks),
-                            self);
-
-  g_signal_connect_swapped (manager,
-                            "list-removed",
-                            G_CALLBACK (gtd_panel_scheduled_count_tasks),
-                            self);
-
-  g_signal_connect_swapped (manager,
-                            "list-changed",
-                            G_CALLBACK (gtd_panel_scheduled_count_tasks),
-                            self);
-
-  g_signal_connect_swapped (gtd_manager_get_timer (manager),
-                            "update",
-                            G_CALLBACK (gtd_panel_scheduled_count_tasks),
-                            self);
+  self->tasks = g_hash_table_new (g_direct_hash, g_direct_equal);
+  self->buckets = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, (GDestroyNotify) bucket_free);
+  self->today = get_day_for_date (now);
 
   /* Setup a title */
   self->title = g_strdup (_("Scheduled"));
@@ -531,6 +607,43 @@ gtd_panel_scheduled_init (GtdPanelScheduled *self)
                                     self);
 
   gtk_widget_show_all (GTK_WIDGET (self));
+
+  /* Track the tasks of the current and future lists */
+  self->tracker = gtd_task_tracker_new (GTD_TASK_LIST_VIEW (self->view),
+                                        (GtdTaskTrackerFilterFunc) is_task_scheduled,
+                                        self);
+
+  g_signal_connect_object (self->tracker,
+                           "task-added",
+                           G_CALLBACK (on_task_added_cb),
+                           self,
+                           0);
+
+  g_signal_connect_object (self->tracker,
+                           "task-removed",
+                           G_CALLBACK (on_task_removed_cb),
+                           self,
+                           0);
+
+  g_signal_connect_object (self->tracker,
+                           "task-updated",
+                           G_CALLBACK (on_task_updated_cb),
+                           self,
+                           0);
+
+  g_signal_connect_object (self->tracker,
+                           "notify::n-incomplete-tasks",
+                           G_CALLBACK (update_title),
+                           self,
+                           G_CONNECT_SWAPPED);
+
+  gtd_task_tracker_start (self->tracker);
+
+  g_signal_connect_object (gtd_manager_get_timer (manager),
+                           "update",
+                           G_CALLBACK (on_day_changed_cb),
+                           self,
+                           G_CONNECT_SWAPPED);
 }
 
 GtkWidget*
@@ -52,13 +52,22 @@ enum {
 static void
 gtd_plugin_scheduled_panel_activate (GtdActivatable *activatable)
 {
-  ;
+  GtdPluginScheduledPanel *self = GTD_PLUGIN_SCHEDULED_PANEL (activatable);
+  GtkWidget *panel;
+
+  panel = gtd_panel_scheduled_new ();
+  self->panels = g_list_append (NULL, panel);
+
+  g_signal_emit_by_name (self, "panel-added", panel);
 }
 
 static void
 gtd_plugin_scheduled_panel_deactivate (GtdActivatable *activatable)
 {
-  ;
+  GtdPluginScheduledPanel *self = GTD_PLUGIN_SCHEDULED_PANEL (activatable);
+
+  /* The plugin manager already removed the panel */
+  g_clear_pointer (&self->panels, g_list_free);
 }
 
 static GList*
@@ -162,9 +171,6 @@ gtd_plugin_scheduled_panel_init (GtdPluginScheduledPanel *self)
   else
     gtk_css_provider_load_from_resource (self->css_provider, "/org/gnome/todo/theme/scheduled-panel/Adwaita.css");
 
-  /* And then the panel */
-  self->panels = g_list_append (NULL, gtd_panel_scheduled_new ());
-
   g_object_unref (settings);
   g_object_unref (css_file);
   g_free (theme_name);
@@ -0,0 +1,296 @@
+/* gtd-plugin-score.c
+ *
+ * Copyright (C) 2017 Georges Basile Stavracas Neto <georges.stavracas@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define G_LOG_DOMAIN "Score"
+
+#include "gtd-plugin-score.h"
+#include "gtd-score-manager.h"
+
+#include <glib/gi18n.h>
+#include <glib-object.h>
+
+struct _GtdPluginScore
+{
+  PeasExtensionBase   parent;
+
+  GtkWidget          *header_button;
+  GtkWidget          *listbox;
+
+  GtdScoreManager    *manager;
+};
+
+static void          gtd_activatable_iface_init                  (GtdActivatableInterface  *iface);
+
+G_DEFINE_DYNAMIC_TYPE_EXTENDED (GtdPluginScore, gtd_plugin_score, PEAS_TYPE_EXTENSION_BASE,
+                                0,
+                                G_IMPLEMENT_INTERFACE_DYNAMIC (GTD_TYPE_ACTIVATABLE,
+                                                               gtd_activatable_iface_init))
+
+enum {
+  PROP_0,
+  PROP_PREFERENCES_PANEL,
+  N_PROPS
+};
+
+
+static void
+add_row (GtdPluginScore *self,
+         const gchar    *format,
+         GtdTask        *task)
+{
+  g_autofree gchar *markup = NULL;
+  GtkWidget *label;
+  GtkWidget *row;
+
+  markup = g_markup_printf_escaped (format, gtd_task_get_title (task));
+
+  label = g_object_new (GTK_TYPE_LABEL,
+                        "label", markup,
+                        "use-markup", TRUE,
+                        "hexpand", TRUE,
+                        "xalign", 0.0,
+                        NULL);
+
+  row = gtk_list_box_row_new ();
+  gtk_container_set_border_width (GTK_CONTAINER (row), 6);
+  gtk_container_add (GTK_CONTAINER (row), label);
+  gtk_widget_show_all (row);
+
+  gtk_container_add (GTK_CONTAINER (self->listbox), row);
+}
+
+static void
+update_score_label (GtdPluginScore *self)
+{
+  g_autofree gchar *text = NULL;
+
+  text = g_strdup_printf ("%d", gtd_score_manager_get_score (self->manager));
+
+  gtk_button_set_label (GTK_BUTTON (self->header_button), text);
+}
+
+static void
+on_score_changed_cb (GtdPluginScore *self)
+{
+  update_score_label (self);
+}
+
+static void
+on_score_added_cb (GtdScoreManager *manager,
+                   gint             score,
+                   GtdTask         *task,
+                   GtdPluginScore  *self)
+{
+  /* Translators: %s is the title of the task */
+  add_row (self, _("<b>%s</b> completed"), task);
+}
+
+static void
+on_score_removed_cb (GtdScoreManager *manager,
+                     gint             score,
+                     GtdTask         *task,
+                     GtdPluginScore  *self)
+{
+  /* Translators: %s is the title of the task */
+  add_row (self, _("<b>%s</b> readded"), task);
+}
+
+static void
+setup_popover (GtdPluginScore *self)
+{
+  g_autofree gchar *title = NULL;
+  GtkWidget *placeholder;
+  GtkWidget *popover;
+  GtkWidget *label;
+  GtkWidget *box;
+
+  /* Placeholder */
+  placeholder = gtk_box_new (GTK_ORIENTATION_VERTICAL, 6);
+  gtk_container_set_border_width (GTK_CONTAINER (placeholder), 12);
+  gtk_container_add (GTK_CONTAINER (placeholder),
+                     gtk_image_new_from_icon_name ("face-embarrassed-symbolic", GTK_ICON_SIZE_DIALOG));
+  gtk_container_add (GTK_CONTAINER (placeholder), gtk_label_new (_("No task completed today")));
+  gtk_widget_show_all (placeholder);
+
+  /* Listbox */
+  self->listbox = gtk_list_box_new ();
+  gtk_list_box_set_selection_mode (GTK_LIST_BOX (self->listbox), GTK_SELECTION_NONE);
+  gtk_list_box_set_placeholder (GTK_LIST_BOX (self->listbox), placeholder);
+  gtk_style_context_add_class (gtk_widget_get_style_context (self->listbox), "background");
+
+  /* Title */
+  title = g_markup_printf_escaped ("<b>%s</b>", _("Today"));
+
+  label = g_object_new (GTK_TYPE_LABEL,
+                        "label", title,
+                        "use-markup", TRUE,
+                        "hexpand", TRUE,
+                        "xalign", 0.0,
+                        NULL);
+
+  box = gtk_box_new (GTK_ORIENTATION_VERTICAL, 6);
+  gtk_container_set_border_width (GTK_CONTAINER (box), 18);
+  gtk_container_add (GTK_CONTAINER (box), label);
+  gtk_container_add (GTK_CONTAINER (box), self->listbox);
+  gtk_widget_show_all (box);
+
+  popover = gtk_popover_new (self->header_button);
+  gtk_container_add (GTK_CONTAINER (popover), box);
+
+  gtk_menu_button_set_popover (GTK_MENU_BUTTON (self->header_button), popover);
+}
+
+
+/*
+ * GtdActivatable interface implementation
+ */
+static void
+gtd_plugin_score_activate (GtdActivatable *activatable)
+{
+  ;
+}
+
+static void
+gtd_plugin_score_deactivate (GtdActivatable *activatable)
+{
+  ;
+}
+
+static GList*
+gtd_plugin_score_get_header_widgets (GtdActivatable *activatable)
+{
+  GtdPluginScore *self = GTD_PLUGIN_SCORE (activatable);
+
+  return g_list_append (NULL, self->header_button);
+}
+
+static GtkWidget*
+gtd_plugin_score_get_preferences_panel (GtdActivatable *activatable)
+{
+  return NULL;
+}
+
+static GList*
+gtd_plugin_score_get_panels (GtdActivatable *activatable)
+{
+  return NULL;
+}
+
+static GList*
+gtd_plugin_score_get_providers (GtdActivatable *activatable)
+{
+  return NULL;
+}
+
+static void
+gtd_activatable_iface_init (GtdActivatableInterface *iface)
+{
+  iface->activate = gtd_plugin_score_activate;
+  iface->deactivate = gtd_plugin_score_deactivate;
+  iface->get_header_widgets = gtd_plugin_score_get_header_widgets;
+  iface->get_preferences_panel = gtd_plugin_score_get_preferences_panel;
+  iface->get_panels = gtd_plugin_score_get_panels;
+  iface->get_providers = gtd_plugin_score_get_providers;
+}
+
+static void
+gtd_plugin_score_finalize (GObject *object)
+{
+  GtdPluginScore *self = (GtdPluginScore *)object;
+
+  g_signal_handlers_disconnect_by_data (self->manager, self);
+
+  g_clear_object (&self->header_button);
+
+  G_OBJECT_CLASS (gtd_plugin_score_parent_class)->finalize (object);
+}
+
+static void
+gtd_plugin_score_get_property (GObject    *object,
+                               guint       prop_id,
+                               GValue     *value,
+                               GParamSpec *pspec)
+{
+  switch (prop_id)
+    {
+    case PROP_PREFERENCES_PANEL:
+      g_value_set_object (value, NULL);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+    }
+}
+
+static void
+gtd_plugin_score_class_init (GtdPluginScoreClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->finalize = gtd_plugin_score_finalize;
+  object_class->get_property = gtd_plugin_score_get_property;
+
+  g_object_class_override_property (object_class,
+                                    PROP_PREFERENCES_PANEL,
+                                    "preferences-panel");
+}
+
+static void
+gtd_plugin_score_init (GtdPluginScore *self)
+{
+  self->manager = gtd_score_manager_get_default ();
+
+  /* Header button */
+  self->header_button = g_object_ref_sink (gtk_menu_button_new ());
+  gtk_widget_set_halign (self->header_button, GTK_ALIGN_END);
+  gtk_style_context_add_class (gtk_widget_get_style_context (self->header_button), "image-button");
+  gtk_widget_show (self->header_button);
+
+  setup_popover (self);
+  update_score_label (self);
+
+  g_signal_connect_swapped (self->manager,
+                            "notify::score",
+                            G_CALLBACK (on_score_changed_cb),
+                            self);
+
+  g_signal_connect (self->manager,
+                    "score-added",
+                    G_CALLBACK (on_score_added_cb),
+                    self);
+
+  g_signal_connect (self->manager,
+                    "score-removed",
+                    G_CALLBACK (on_score_removed_cb),
+                    self);
+}
+
+static void
+gtd_plugin_score_class_finalize (GtdPluginScoreClass *klass)
+{
+}
+
+G_MODULE_EXPORT void
+gtd_plugin_score_register_types (PeasObjectModule *module)
+{
+  gtd_plugin_score_register_type (G_TYPE_MODULE (module));
+
+  peas_object_module_register_extension_type (module,
+                                              GTD_TYPE_ACTIVATABLE,
+                                              GTD_TYPE_PLUGIN_SCORE);
+}
@@ -0,0 +1,557 @@
+/* gtd-score-manager.c
+ *
+ * Copyright (C) 2017 Georges Basile Stavracas Neto <georges.stavracas@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define G_LOG_DOMAIN "Score"
+
+#include "gtd-score-manager.h"
+
+#include <gnome-todo.h>
+
+/*
+ * The score manager keeps running aggregates of the tasks of every list,
+ * so that both the score and the task counters of the score plugin are
+ * available in O(1). Each task has an entry with the state that was last
+ * accounted for, and every change is applied as a delta against it
+ * instead of rescanning the lists.
+ */
+
+typedef struct
+{
+  gint                value;
+  gboolean            complete;
+
+  /* Whether the task was completed while being watched, and thus counts */
+  gboolean            scored;
+} TaskEntry;
+
+struct _GtdScoreManager
+{
+  GObject             parent;
+
+  /* GtdTask → TaskEntry */
+  GHashTable         *tasks;
+
+  gint                score;
+  guint               n_completed_tasks;
+  guint               n_scored_tasks;
+};
+
+G_DEFINE_TYPE (GtdScoreManager, gtd_score_manager, G_TYPE_OBJECT)
+
+enum {
+  PROP_0,
+  PROP_N_COMPLETED_TASKS,
+  PROP_N_SCORED_TASKS,
+  PROP_N_TASKS,
+  PROP_SCORE,
+  N_PROPS
+};
+
+enum {
+  SCORE_ADDED,
+  SCORE_REMOVED,
+  NUM_SIGNALS
+};
+
+static GParamSpec *properties [N_PROPS] = { NULL, };
+
+static guint signals [NUM_SIGNALS] = { 0, };
+
+
+static inline gint
+get_task_value (GtdTask *task)
+{
+  return 10 + gtd_task_get_priority (task) * 5;
+}
+
+static void
+on_task_complete_changed_cb (GtdTask         *task,
+                             GParamSpec      *pspec,
+                             GtdScoreManager *self)
+{
+  TaskEntry *entry;
+  gboolean complete;
+
+  entry = g_hash_table_lookup (self->tasks, task);
+  complete = gtd_task_get_complete (task);
+
+  if (!entry || entry->complete == complete)
+    return;
+
+  entry->complete = complete;
+
+  if (complete)
+    {
+      self->n_completed_tasks++;
+      self->n_scored_tasks++;
+      self->score += entry->value;
+      entry->scored = TRUE;
+
+      g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_N_COMPLETED_TASKS]);
+      g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_N_SCORED_TASKS]);
+      g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_SCORE]);
+
+      g_signal_emit (self, signals[SCORE_ADDED], 0, self->score, task);
+    }
+  else
+    {
+      self->n_completed_tasks--;
+      g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_N_COMPLETED_TASKS]);
+
+      /* Tasks that were already complete when loaded never added to the score */
+      if (!entry->scored)
+        return;
+
+      self->n_scored_tasks--;
+      self->score -= entry->value;
+      entry->scored = FALSE;
+
+      g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_N_SCORED_TASKS]);
+      g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_SCORE]);
+
+      g_signal_emit (self, signals[SCORE_REMOVED], 0, self->score, task);
+    }
+}
+
+static void
+on_task_priority_changed_cb (GtdTask         *task,
+                             GParamSpec      *pspec,
+                             GtdScoreManager *self)
+{
+  TaskEntry *entry;
+  gint value;
+
+  entry = g_hash_table_lookup (self->tasks, task);
+  value = get_task_value (task);
+
+  if (!entry || entry->value == value)
+    return;
+
+  if (entry->scored)
+    {
+      self->score += value - entry->value;
+      g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_SCORE]);
+    }
+
+  entry->value = value;
+}
+
+static void
+add_task (GtdScoreManager *self,
+          GtdTask         *task)
+{
+  TaskEntry *entry;
+
+  if (g_hash_table_contains (self->tasks, task))
+    return;
+
+  entry = g_slice_new0 (TaskEntry);
+  entry->value = get_task_value (task);
+  entry->complete = gtd_task_get_complete (task);
+
+  g_hash_table_insert (self->tasks, g_object_ref (task), entry);
+
+  g_signal_connect_object (task,
+                           "notify::complete",
+                           G_CALLBACK (on_task_complete_changed_cb),
+                           self,
+                           0);
+
+  g_signal_connect_object (task,
+                           "notify::priority",
+                           G_CALLBACK (on_task_priority_changed_cb),
+                           self,
+                           0);
+
+  if (entry->complete)
+    self->n_completed_tasks++;
+}
+
+static void
+remove_task (GtdScoreManager *self,
+             GtdTask         *task)
+{
+  TaskEntry *entry;
+
+  entry = g_hash_table_lookup (self->tasks, task);
+
+  if (!entry)
+    return;
+
+  if (entry->complete)
+    self->n_completed_tasks--;
+
+  /* The score earned by a task is kept even after it is deleted */
+  if (entry->scored)
+    {
+      self->n_scored_tasks--;
+      g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_N_SCORED_TASKS]);
+    }
+
+  g_signal_handlers_disconnect_by_data (task, self);
+  g_hash_table_remove (self->tasks, task);
+}
+
+static void
+notify_counters (GtdScoreManager *self)
+{
+  g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_N_COMPLETED_TASKS]);
+  g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_N_TASKS]);
+}
+
+static void
+on_task_added_cb (GtdTaskList     *list,
+                  GtdTask         *task,
+                  GtdScoreManager *self)
+{
+  add_task (self, task);
+  notify_counters (self);
+}
+
+static void
+on_task_removed_cb (GtdTaskList     *list,
+                    GtdTask         *task,
+                    GtdScoreManager *self)
+{
+  remove_task (self, task);
+  notify_counters (self);
+}
+
+static void
+on_list_added_cb (GtdManager      *manager,
+                  GtdTaskList     *list,
+                  GtdScoreManager *self)
+{
+  GList *tasks;
+  GList *l;
+
+  g_signal_connect_object (list,
+                           "task-added",
+                           G_CALLBACK (on_task_added_cb),
+                           self,
+                           0);
+
+  g_signal_connect_object (list,
+                           "task-removed",
+                           G_CALLBACK (on_task_removed_cb),
+                           self,
+                           0);
+
+  tasks = gtd_task_list_get_tasks (list);
+
+  for (l = tasks; l != NULL; l = l->next)
+    add_task (self, l->data);
+
+  notify_counters (self);
+
+  g_list_free (tasks);
+}
+
+static void
+on_list_removed_cb (GtdManager      *manager,
+                    GtdTaskList     *list,
+                    GtdScoreManager *self)
+{
+  GList *tasks;
+  GList *l;
+
+  g_signal_handlers_disconnect_by_data (list, self);
+
+  tasks = gtd_task_list_get_tasks (list);
+
+  for (l = tasks; l != NULL; l = l->next)
+    remove_task (self, l->data);
+
+  notify_counters (self);
+
+  g_list_free (tasks);
+}
+
+static void
+task_entry_free (gpointer data)
+{
+  g_slice_free (TaskEntry, data);
+}
+
+static void
+gtd_score_manager_finalize (GObject *object)
+{
+  GtdScoreManager *self = (GtdScoreManager *)object;
+  GHashTableIter iter;
+  gpointer task;
+
+  g_hash_table_iter_init (&iter, self->tasks);
+
+  while (g_hash_table_iter_next (&iter, &task, NULL))
+    g_signal_handlers_disconnect_by_data (task, self);
+
+  g_clear_pointer (&self->tasks, g_hash_table_destroy);
+
+  G_OBJECT_CLASS (gtd_score_manager_parent_class)->finalize (object);
+}
+
+static void
+gtd_score_manager_get_property (GObject    *object,
+                                guint       prop_id,
+                                GValue     *value,
+                                GParamSpec *pspec)
+{
+  GtdScoreManager *self = GTD_SCORE_MANAGER (object);
+
+  switch (prop_id)
+    {
+    case PROP_N_COMPLETED_TASKS:
+      g_value_set_uint (value, self->n_completed_tasks);
+      break;
+
+    case PROP_N_SCORED_TASKS:
+      g_value_set_uint (value, self->n_scored_tasks);
+      break;
+
+    case PROP_N_TASKS:
+      g_value_set_uint (value, g_hash_table_size (self->tasks));
+      break;
+
+    case PROP_SCORE:
+      g_value_set_int (value, self->score);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+    }
+}
+
+static void
+gtd_score_manager_class_init (GtdScoreManagerClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->finalize = gtd_score_manager_finalize;
+  object_class->get_property = gtd_score_manager_get_property;
+
+  /**
+   * GtdScoreManager::n-completed-tasks:
+   *
+   * The number of completed tasks in all lists.
+   */
+  properties[PROP_N_COMPLETED_TASKS] = g_param_spec_uint ("n-completed-tasks",
+                                                          "Number of completed tasks",
+                                                          "The number of completed tasks in all lists",
+                                                          0,
+                                                          G_MAXUINT,
+                                                          0,
+                                                          G_PARAM_READABLE | G_PARAM_EXPLICIT_NOTIFY);
+
+  /**
+   * GtdScoreManager::n-scored-tasks:
+   *
+   * The number of existing tasks that were completed since the score
+   * started being tracked.
+   */
+  properties[PROP_N_SCORED_TASKS] = g_param_spec_uint ("n-scored-tasks",
+                                                       "Number of scored tasks",
+                                                       "The number of tasks completed while tracking the score",
+                                                       0,
+                                                       G_MAXUINT,
+                                                       0,
+                                                       G_PARAM_READABLE | G_PARAM_EXPLICIT_NOTIFY);
+
+  /**
+   * GtdScoreManager::n-tasks:
+   *
+   * The number of tasks in all lists.
+   */
+  properties[PROP_N_TASKS] = g_param_spec_uint ("n-tasks",
+                                                "Number of tasks",
+                                                "The number of tasks in all lists",
+                                                0,
+                                                G_MAXUINT,
+                                                0,
+                                                G_PARAM_READABLE | G_PARAM_EXPLICIT_NOTIFY);
+
+  /**
+   * GtdScoreManager::score:
+   *
+   * The current score.
+   */
+  properties[PROP_SCORE] = g_param_spec_int ("score",
+                                             "Score",
+                                             "The current score",
+                                             G_MININT,
+                                             G_MAXINT,
+                                             0,
+                                             G_PARAM_READABLE | G_PARAM_EXPLICIT_NOTIFY);
+
+  g_object_class_install_properties (object_class, N_PROPS, properties);
+
+  /**
+   * GtdScoreManager::score-added:
+   * @self: a #GtdScoreManager
+   * @score: the new score
+   * @task: the #GtdTask that was completed
+   *
+   * The ::score-added signal is emitted when a task is completed.
+   */
+  signals[SCORE_ADDED] = g_signal_new ("score-added",
+                                       GTD_TYPE_SCORE_MANAGER,
+                                       G_SIGNAL_RUN_FIRST,
+                                       0,
+                                       NULL,
+                                       NULL,
+                                       NULL,
+                                       G_TYPE_NONE,
+                                       2,
+                                       G_TYPE_INT,
+                                       GTD_TYPE_TASK);
+
+  /**
+   * GtdScoreManager::score-removed:
+   * @self: a #GtdScoreManager
+   * @score: the new score
+   * @task: the #GtdTask that was marked as incomplete again
+   *
+   * The ::score-removed signal is emitted when a task that added to
+   * the score is marked as incomplete.
+   */
+  signals[SCORE_REMOVED] = g_signal_new ("score-removed",
+                                         GTD_TYPE_SCORE_MANAGER,
+                                         G_SIGNAL_RUN_FIRST,
+                                         0,
+                                         NULL,
+                                         NULL,
+                                         NULL,
+                                         G_TYPE_NONE,
+                                         2,
+                                         G_TYPE_INT,
+                                         GTD_TYPE_TASK);
+}
+
+static void
+gtd_score_manager_init (GtdScoreManager *self)
+{
+  GtdManager *manager;
+  GList *lists;
+  GList *l;
+
+  self->tasks = g_hash_table_new_full (g_direct_hash, g_direct_equal, g_object_unref, task_entry_free);
+
+  manager = gtd_manager_get_default ();
+  lists = gtd_manager_get_task_lists (manager);
+
+  for (l = lists; l != NULL; l = l->next)
+    on_list_added_cb (manager, l->data, self);
+
+  g_list_free (lists);
+
+  g_signal_connect_object (manager,
+                           "list-added",
+                           G_CALLBACK (on_list_added_cb),
+                           self,
+                           0);
+
+  g_signal_connect_object (manager,
+                           "list-removed",
+                           G_CALLBACK (on_list_removed_cb),
+                           self,
+                           0);
+}
+
+/**
+ * gtd_score_manager_get_default:
+ *
+ * Retrieves the singleton #GtdScoreManager instance. Other plugins can use
+ * it to read the aggregates without rescanning the task lists.
+ *
+ * Returns: (transfer none): the default #GtdScoreManager
+ */
+GtdScoreManager*
+gtd_score_manager_get_default (void)
+{
+  static GtdScoreManager *instance = NULL;
+
+  if (!instance)
+    instance = g_object_new (GTD_TYPE_SCORE_MANAGER, NULL);
+
+  return instance;
+}
+
+/**
+ * gtd_score_manager_get_score:
+ * @self: a #GtdScoreManager
+ *
+ * Retrieves the current score, i.e. the sum of the values of the
+ * tasks completed since the score started being tracked.
+ *
+ * Returns: the current score
+ */
+gint
+gtd_score_manager_get_score (GtdScoreManager *self)
+{
+  g_return_val_if_fail (GTD_IS_SCORE_MANAGER (self), 0);
+
+  return self->score;
+}
+
+/**
+ * gtd_score_manager_get_n_tasks:
+ * @self: a #GtdScoreManager
+ *
+ * Retrieves the number of tasks in all lists.
+ *
+ * Returns: the number of tasks
+ */
+guint
+gtd_score_manager_get_n_tasks (GtdScoreManager *self)
+{
+  g_return_val_if_fail (GTD_IS_SCORE_MANAGER (self), 0);
+
+  return g_hash_table_size (self->tasks);
+}
+
+/**
+ * gtd_score_manager_get_n_completed_tasks:
+ * @self: a #GtdScoreManager
+ *
+ * Retrieves the number of completed tasks in all lists.
+ *
+ * Returns: the number of completed tasks
+ */
+guint
+gtd_score_manager_get_n_completed_tasks (GtdScoreManager *self)
+{
+  g_return_val_if_fail (GTD_IS_SCORE_MANAGER (self), 0);
+
+  return self->n_completed_tasks;
+}
+
+/**
+ * gtd_score_manager_get_n_scored_tasks:
+ * @self: a #GtdScoreManager
+ *
+ * Retrieves the number of tasks that were completed since the score
+ * started being tracked, and are still complete.
+ *
+ * Returns: the number of scored tasks
+ */
+guint
+gtd_score_manager_get_n_scored_tasks (GtdScoreManager *self)
+{
+  g_return_val_if_fail (GTD_IS_SCORE_MANAGER (self), 0);
+
+  return self->n_scored_tasks;
+}
@@ -0,0 +1,42 @@
+/* gtd-score-manager.h
+ *
+ * Copyright (C) 2017 Georges Basile Stavracas Neto <georges.stavracas@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GTD_SCORE_MANAGER_H
+#define GTD_SCORE_MANAGER_H
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+#define GTD_TYPE_SCORE_MANAGER (gtd_score_manager_get_type())
+
+G_DECLARE_FINAL_TYPE (GtdScoreManager, gtd_score_manager, GTD, SCORE_MANAGER, GObject)
+
+GtdScoreManager*     gtd_score_manager_get_default               (void);
+
+gint                 gtd_score_manager_get_score                 (GtdScoreManager    *self);
+
+guint                gtd_score_manager_get_n_tasks               (GtdScoreManager    *self);
+
+guint                gtd_score_manager_get_n_completed_tasks     (GtdScoreManager    *self);
+
+guint                gtd_score_manager_get_n_scored_tasks        (GtdScoreManager    *self);
+
+G_END_DECLS
+
+#endif /* GTD_SCORE_MANAGER_H */
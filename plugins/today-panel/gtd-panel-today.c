@@ -31,8 +31,10 @@ struct _GtdPanelToday
   gint                day_change_callback_id;
 
   gchar              *title;
-  guint               number_of_tasks;
-  GList              *task_list;
+
+  /* Follows the tasks due today */
+  GtdTaskTracker     *tracker;
+  GDateTime          *today;
 };
 
 static void          gtd_panel_iface_init                        (GtdPanelInterface  *iface);
@@ -71,77 +73,52 @@ is_today (GDateTime *today,
 }
 
 static void
-gtd_panel_today_count_tasks (GtdPanelToday *panel)
+update_title (GtdPanelToday *panel)
 {
-  g_autoptr (GDateTime) now;
-  GtdManager *manager;
-  GList *tasklists;
-  GList *l;
   guint number_of_tasks;
 
-  now = g_date_time_new_now_local ();
-  manager = gtd_manager_get_default ();
-  tasklists = gtd_manager_get_task_lists (manager);
-  number_of_tasks = 0;
+  number_of_tasks = gtd_task_tracker_get_n_incomplete_tasks (panel->tracker);
 
-  g_clear_pointer (&panel->task_list, g_list_free);
+  g_clear_pointer (&panel->title, g_free);
 
-  /* Recount tasks */
-  for (l = tasklists; l != NULL; l = l->next)
+  if (number_of_tasks == 0)
     {
-      GList *tasks;
-      GList *t;
-
-      tasks = gtd_task_list_get_tasks (l->data);
-
-      for (t = tasks; t != NULL; t = t->next)
-        {
-          GDateTime *task_dt;
-
-          task_dt = gtd_task_get_due_date (t->data);
-
-          if (!is_today (now, task_dt))
-            {
-              g_clear_pointer (&task_dt, g_date_time_unref);
-              continue;
-            }
+      panel->title = g_strdup (_("Today"));
+    }
+  else
+    {
+      panel->title = g_strdup_printf ("%s (%d)",
+                                      _("Today"),
+                                      number_of_tasks);
+    }
 
-          panel->task_list = g_list_prepend (panel->task_list, t->data);
+  g_object_notify (G_OBJECT (panel), "title");
+}
 
-          if (!gtd_task_get_complete (t->data))
-            number_of_tasks++;
+static gboolean
+is_task_for_today (GtdTask       *task,
+                   GtdPanelToday *panel)
+{
+  g_autoptr (GDateTime) task_dt = NULL;
 
-          g_clear_pointer (&task_dt, g_date_time_unref);
-        }
+  task_dt = gtd_task_get_due_date (task);
 
-      g_list_free (tasks);
-    }
+  return is_today (panel->today, task_dt);
+}
 
-  /* Add the tasks to the view */
-  gtd_task_list_view_set_list (GTD_TASK_LIST_VIEW (panel->view), panel->task_list);
-  gtd_task_list_view_set_default_date (GTD_TASK_LIST_VIEW (panel->view), now);
+/*
+ * The day changed, so every task has to be tested again. This is the only
+ * time all the tasks are traversed.
+ */
+static void
+on_day_changed_cb (GtdPanelToday *panel)
+{
+  g_clear_pointer (&panel->today, g_date_time_unref);
+  panel->today = g_date_time_new_now_local ();
 
-  if (number_of_tasks != panel->number_of_tasks)
-    {
-      panel->number_of_tasks = number_of_tasks;
-
-      /* Update title */
-      g_clear_pointer (&panel->title, g_free);
-      if (number_of_tasks == 0)
-        {
-          panel->title = g_strdup (_("Today"));
-        }
-      else
-        {
-          panel->title = g_strdup_printf ("%s (%d)",
-                                          _("Today"),
-                                          panel->number_of_tasks);
-        }
-
-      g_object_notify (G_OBJECT (panel), "title");
-    }
+  gtd_task_list_view_set_default_date (GTD_TASK_LIST_VIEW (panel->view), panel->today);
 
-  g_list_free (tasklists);
+  gtd_task_tracker_refilter (panel->tracker);
 }
 
 /**********************
@@ -187,7 +164,8 @@ gtd_panel_today_finalize (GObject *object)
 
   g_clear_object (&self->menu);
   g_clear_pointer (&self->title, g_free);
-  g_clear_pointer (&self->task_list, g_list_free);
+  g_clear_object (&self->tracker);
+  g_clear_pointer (&self->today, g_date_time_unref);
 
   G_OBJECT_CLASS (gtd_panel_today_parent_class)->finalize (object);
 }
@@ -246,26 +224,10 @@ static void
 gtd_panel_today_init (GtdPanelToday *self)
 {
   GtdManager *manager;
-  GDateTime *now;
 
-  /* Connect to GtdManager::list-* signals to update the title */
   manager = gtd_manager_get_default ();
-  now = g_date_time_new_now_local ();
 
-  g_signal_connect_swapped (manager,
-                            "list-added",
-                            G_CALLBACK (gtd_panel_today_count_tasks),
-                            self);
-
-  g_signal_connect_swapped (manager,
-                            "list-removed",
-                            G_CALLBACK (gtd_panel_today_count_tasks),
-                            self);
-
-  g_signal_connect_swapped (manager,
-                            "list-changed",
-                            G_CALLBACK (gtd_panel_today_count_tasks),
-                            self);
+  self->today = g_date_time_new_now_local ();
 
   /* Setup a title */
   self->title = g_strdup (_("Today"));
@@ -281,7 +243,7 @@ gtd_panel_today_init (GtdPanelToday *self)
   gtd_task_list_view_set_handle_subtasks (GTD_TASK_LIST_VIEW (self->view), FALSE);
   gtd_task_list_view_set_show_list_name (GTD_TASK_LIST_VIEW (self->view), TRUE);
   gtd_task_list_view_set_show_due_date (GTD_TASK_LIST_VIEW (self->view), FALSE);
-  gtd_task_list_view_set_default_date (GTD_TASK_LIST_VIEW (self->view), now);
+  gtd_task_list_view_set_default_date (GTD_TASK_LIST_VIEW (self->view), self->today);
 
   gtk_widget_set_hexpand (self->view, TRUE);
   gtk_widget_set_vexpand (self->view, TRUE);
@@ -289,13 +251,25 @@ gtd_panel_today_init (GtdPanelToday *self)
 
   gtk_widget_show_all (GTK_WIDGET (self));
 
-  /* Start timer */
-  g_signal_connect_swapped (gtd_manager_get_timer (manager),
-                            "update",
-                            G_CALLBACK (gtd_panel_today_count_tasks),
-                            self);
+  /* Track the tasks of the current and future lists */
+  self->tracker = gtd_task_tracker_new (GTD_TASK_LIST_VIEW (self->view),
+                                        (GtdTaskTrackerFilterFunc) is_task_for_today,
+                                        self);
 
-  g_clear_pointer (&now, g_date_time_unref);
+  g_signal_connect_object (self->tracker,
+                           "notify::n-incomplete-tasks",
+                           G_CALLBACK (update_title),
+                           self,
+                           G_CONNECT_SWAPPED);
+
+  gtd_task_tracker_start (self->tracker);
+
+  /* Start timer */
+  g_signal_connect_object (gtd_manager_get_timer (manager),
+                           "update",
+                           G_CALLBACK (on_day_changed_cb),
+                           self,
+                           G_CONNECT_SWAPPED);
 }
 
 GtkWidget*
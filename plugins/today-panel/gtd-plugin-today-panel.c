@@ -50,13 +50,22 @@ enum {
 static void
 gtd_plugin_today_panel_activate (GtdActivatable *activatable)
 {
-  ;
+  GtdPluginTodayPanel *self = GTD_PLUGIN_TODAY_PANEL (activatable);
+  GtkWidget *panel;
+
+  panel = gtd_panel_today_new ();
+  self->panels = g_list_append (NULL, panel);
+
+  g_signal_emit_by_name (self, "panel-added", panel);
 }
 
 static void
 gtd_plugin_today_panel_deactivate (GtdActivatable *activatable)
 {
-  ;
+  GtdPluginTodayPanel *self = GTD_PLUGIN_TODAY_PANEL (activatable);
+
+  /* The plugin manager already removed the panel */
+  g_clear_pointer (&self->panels, g_list_free);
 }
 
 static GList*
@@ -139,7 +148,6 @@ gtd_plugin_today_panel_class_init (GtdPluginTodayPanelClass *klass)
 static void
 gtd_plugin_today_panel_init (GtdPluginTodayPanel *self)
 {
-  self->panels = g_list_append (NULL, gtd_panel_today_new ());
 }
 
 static void
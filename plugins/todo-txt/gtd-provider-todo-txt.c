@@ -24,6 +24,8 @@
 
 #include <glib/gi18n.h>
 
+/* Time spent parsing the file in each main loop iteration */
+#define LOAD_TASKS_BUDGET_US 4000
 
 struct _GtdProviderTodoTxt
 {
@@ -40,6 +42,19 @@ struct _GtdProviderTodoTxt
   GList              *task_lists;
   GPtrArray          *cache;
   gboolean            should_reload;
+
+  /* Loading of the file, in progress while cancellable is set */
+  GCancellable       *cancellable;
+  gchar             **lines;
+  guint               next_line;
+  guint               load_tasks_id;
+  gint64              load_start;
+  gboolean            lists_loaded;
+  gboolean            write_after_load;
+
+  /* Task operations waiting for the next write of the file */
+  GList              *pending_writes;
+  guint               write_source_id;
 };
 
 static void          gtd_provider_iface_init                     (GtdProviderInterface *iface);
@@ -88,6 +103,16 @@ gtd_provider_todo_txt_get_enabled (GtdProvider *provider)
   return TRUE;
 }
 
+static gboolean
+gtd_provider_todo_txt_get_lists_loaded (GtdProvider *provider)
+{
+  GtdProviderTodoTxt *self;
+
+  self = GTD_PROVIDER_TODO_TXT (provider);
+
+  return self->lists_loaded;
+}
+
 static GIcon*
 gtd_provider_todo_txt_get_icon (GtdProvider *provider)
 {
@@ -119,18 +144,16 @@ emit_generic_error (GError *error)
                                   NULL);
 }
 
-static void
-update_source (GtdProviderTodoTxt *self)
+static gboolean
+write_source (GtdProviderTodoTxt  *self,
+              GError             **error)
 {
-
   GFileOutputStream *write_stream;
   GDataOutputStream *writer;
   GtdTaskList *list;
-  GError *error;
   GList *tasks, *l;
   guint i;
 
-  error = NULL;
   tasks = NULL;
   l = NULL;
   self->should_reload = FALSE;
@@ -140,13 +163,9 @@ update_source (GtdProviderTodoTxt *self)
                                  TRUE,
                                  G_FILE_CREATE_NONE,
                                  NULL,
-                                 &error);
-  if (error)
-    {
-      emit_generic_error (error);
-      g_error_free (error);
-      return;
-    }
+                                 error);
+  if (!write_stream)
+    return FALSE;
 
   writer = g_data_output_stream_new (G_OUTPUT_STREAM (write_stream));
 
@@ -184,6 +203,114 @@ update_source (GtdProviderTodoTxt *self)
 
   g_output_stream_close (G_OUTPUT_STREAM (writer), NULL, NULL);
   g_output_stream_close (G_OUTPUT_STREAM (write_stream), NULL, NULL);
+
+  g_object_unref (writer);
+  g_object_unref (write_stream);
+
+  return TRUE;
+}
+
+static void
+update_source (GtdProviderTodoTxt *self)
+{
+  GError *error = NULL;
+
+  /* Writing now would drop the lines that were not parsed yet */
+  if (self->cancellable)
+    {
+      self->write_after_load = TRUE;
+      return;
+    }
+
+  if (!write_source (self, &error))
+    {
+      emit_generic_error (error);
+      g_error_free (error);
+    }
+}
+
+/*
+ * Every task operation rewrites the whole file, so the asynchronous ones
+ * are completed together by a single write in the next main loop
+ * iteration.
+ */
+static void
+flush_pending_writes (GtdProviderTodoTxt *self)
+{
+  GList *operations;
+  GList *l;
+  GError *error;
+  gboolean needs_write;
+
+  if (self->write_source_id > 0)
+    {
+      g_source_remove (self->write_source_id);
+      self->write_source_id = 0;
+    }
+
+  /* Flushed again when the file is loaded */
+  if (self->cancellable)
+    return;
+
+  operations = g_steal_pointer (&self->pending_writes);
+  needs_write = FALSE;
+  error = NULL;
+
+  for (l = operations; l != NULL; l = l->next)
+    {
+      if (!g_cancellable_is_cancelled (g_task_get_cancellable (l->data)))
+        needs_write = TRUE;
+    }
+
+  if (needs_write && !write_source (self, &error))
+    emit_generic_error (error);
+
+  for (l = operations; l != NULL; l = l->next)
+    {
+      if (g_task_return_error_if_cancelled (l->data))
+        continue;
+
+      if (error)
+        g_task_return_error (l->data, g_error_copy (error));
+      else
+        g_task_return_boolean (l->data, TRUE);
+    }
+
+  g_list_free_full (operations, g_object_unref);
+  g_clear_error (&error);
+}
+
+static gboolean
+flush_pending_writes_cb (gpointer user_data)
+{
+  GtdProviderTodoTxt *self = user_data;
+
+  self->write_source_id = 0;
+
+  flush_pending_writes (self);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+queue_write (GtdProviderTodoTxt  *self,
+             gpointer             task_data,
+             GDestroyNotify       task_data_destroy,
+             gpointer             source_tag,
+             GCancellable        *cancellable,
+             GAsyncReadyCallback  callback,
+             gpointer             user_data)
+{
+  GTask *operation;
+
+  operation = g_task_new (self, cancellable, callback, user_data);
+  g_task_set_source_tag (operation, source_tag);
+  g_task_set_task_data (operation, task_data, task_data_destroy);
+
+  self->pending_writes = g_list_append (self->pending_writes, operation);
+
+  if (self->write_source_id == 0)
+    self->write_source_id = g_idle_add (flush_pending_writes_cb, self);
 }
 
 static GtdTaskList*
@@ -222,109 +349,198 @@ create_task (void)
 }
 
 static void
-gtd_provider_todo_txt_load_tasks (GtdProviderTodoTxt *self)
+parse_line (GtdProviderTodoTxt *self,
+            gchar              *line)
 {
-  GFileInputStream *readstream;
-  GDataInputStream *reader;
   GtdTaskList *list;
   GtdTask *parent_task;
   GtdTask *task;
-  GError *error;
   GList *tokens;
-  gboolean valid;
-  gchar *line_read;
   gchar *list_name;
   gchar *root_task_name;
 
-  g_return_if_fail (G_IS_FILE (self->source_file));
+  g_strstrip (line);
+  tokens = gtd_todo_txt_parser_tokenize (line);
 
-  tokens = NULL;
-  error = NULL;
-  readstream = g_file_read (self->source_file, NULL, &error);
+  if (!gtd_todo_txt_parser_validate_token_format (tokens))
+    goto out;
 
-  if (error)
+  if (g_list_length (tokens) == 1)
     {
-      emit_generic_error (error);
-      g_error_free (error);
-      return;
+      list_name = &((gchar*)tokens->data)[0];
+      list_name++;
+      create_list (self, list_name);
+      goto out;
     }
 
+  task = gtd_todo_txt_parser_parse_tokens (tokens);
+  g_hash_table_insert (self->tasks, g_strdup (gtd_task_get_title (task)), task);
+  list = create_list (self, g_object_get_data (G_OBJECT (task), "list_name"));
+  gtd_task_set_list (task, list);
 
-  reader = g_data_input_stream_new (G_INPUT_STREAM (readstream));
-
-  while (!error)
+  if (g_object_get_data (G_OBJECT (task), "root_task_name"))
     {
-      line_read = g_data_input_stream_read_line (reader, NULL, NULL, &error);
+      root_task_name = g_object_get_data (G_OBJECT (task), "root_task_name");
 
-      if (error)
+      if (g_hash_table_contains (self->tasks, root_task_name))
         {
-          g_warning ("%s: %s: %s",
-                     G_STRFUNC,
-                     _("Error while reading a line from Todo.txt"),
-                     error->message);
-
-          gtd_manager_emit_error_message (gtd_manager_get_default (),
-                                          _("Error while reading a line from Todo.txt"),
-                                          error->message,
-                                          NULL,
-                                          NULL);
-          g_error_free (error);
-
-          continue;
+          parent_task =  g_hash_table_lookup (self->tasks, root_task_name);
         }
+      else
+        {
+          parent_task = create_task ();
+          gtd_task_set_list (parent_task, list);
+          gtd_task_set_title (parent_task, g_object_get_data (G_OBJECT (task), "root_task_name"));
 
-      if (!line_read)
-        break;
+          g_hash_table_insert (self->tasks, root_task_name, parent_task);
+        }
 
-      g_strstrip (line_read);
-      tokens = gtd_todo_txt_parser_tokenize (line_read);
-      valid = gtd_todo_txt_parser_validate_token_format (tokens);
+      gtd_task_add_subtask (parent_task, task);
+      gtd_task_list_save_task (list, parent_task);
+    }
 
-      if (valid)
-        {
-          if (g_list_length (tokens) == 1)
-            {
-              list_name = &((gchar*)tokens->data)[0];
-              list_name++;
-              create_list (self, list_name);
-              continue;
-            }
-
-          task = gtd_todo_txt_parser_parse_tokens (tokens);
-          g_hash_table_insert (self->tasks, g_strdup (gtd_task_get_title (task)), task);
-          list = create_list (self, g_object_get_data (G_OBJECT (task), "list_name"));
-          gtd_task_set_list (task, list);
-
-          if (g_object_get_data (G_OBJECT (task), "root_task_name"))
-            {
-              root_task_name = g_object_get_data (G_OBJECT (task), "root_task_name");
-
-              if (g_hash_table_contains (self->tasks, root_task_name))
-                {
-                  parent_task =  g_hash_table_lookup (self->tasks, root_task_name);
-                }
-              else
-                {
-                  parent_task = create_task ();
-                  gtd_task_set_list (parent_task, list);
-                  gtd_task_set_title (parent_task, g_object_get_data (G_OBJECT (task), "root_task_name"));
-
-                  g_hash_table_insert (self->tasks, root_task_name, parent_task);
-                }
-
-              gtd_task_add_subtask (parent_task, task);
-              gtd_task_list_save_task (list, parent_task);
-            }
-
-          gtd_task_list_save_task (list, task);
-        }
+  gtd_task_list_save_task (list, task);
+
+out:
+  g_list_free_full (tokens, g_free);
+}
+
+static void
+reset_lists (GtdProviderTodoTxt *self)
+{
+  g_clear_pointer (&self->lists, g_hash_table_destroy);
+  g_clear_pointer (&self->tasks, g_hash_table_destroy);
+  g_ptr_array_free (self->cache, TRUE);
+  g_clear_pointer (&self->task_lists, g_list_free);
+
+  self->lists = g_hash_table_new ((GHashFunc) g_str_hash, (GEqualFunc) g_str_equal);
+  self->tasks = g_hash_table_new ((GHashFunc) g_str_hash, (GEqualFunc) g_str_equal);
+  self->cache = g_ptr_array_new ();
+}
+
+/*
+ * Lists are only announced once the whole file is parsed, so that
+ * they don't show up half-filled.
+ */
+static void
+finish_loading (GtdProviderTodoTxt *self)
+{
+  guint i;
 
-      g_list_free_full (tokens, g_free);
-      g_free (line_read);
+  g_clear_pointer (&self->lines, g_strfreev);
+  g_clear_object (&self->cancellable);
+
+  for (i = 0; i < self->cache->len; i++)
+    g_signal_emit_by_name (self, "list-added", g_ptr_array_index (self->cache, i));
+
+  g_debug ("Todo.txt file loaded in %.3lfms", (g_get_monotonic_time () - self->load_start) / 1000.0);
+
+  if (!self->lists_loaded)
+    {
+      self->lists_loaded = TRUE;
+      g_signal_emit_by_name (self, "lists-loaded");
+    }
+
+  gtd_object_set_ready (GTD_OBJECT (self), TRUE);
+
+  if (self->write_after_load)
+    {
+      self->write_after_load = FALSE;
+      update_source (self);
+    }
+
+  if (self->pending_writes)
+    flush_pending_writes (self);
+}
+
+static gboolean
+load_tasks_cb (gpointer user_data)
+{
+  GtdProviderTodoTxt *self;
+  gint64 deadline;
+
+  self = GTD_PROVIDER_TODO_TXT (user_data);
+  deadline = g_get_monotonic_time () + LOAD_TASKS_BUDGET_US;
+
+  while (self->lines[self->next_line])
+    {
+      parse_line (self, self->lines[self->next_line++]);
+
+      if (g_get_monotonic_time () >= deadline)
+        return G_SOURCE_CONTINUE;
     }
 
-  g_input_stream_close (G_INPUT_STREAM (reader), NULL, NULL);
-  g_input_stream_close (G_INPUT_STREAM (readstream), NULL, NULL);
+  self->load_tasks_id = 0;
+
+  finish_loading (self);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+load_contents_cb (GObject      *source,
+                  GAsyncResult *result,
+                  gpointer      user_data)
+{
+  GtdProviderTodoTxt *self;
+  GError *error;
+  gchar *contents;
+
+  self = GTD_PROVIDER_TODO_TXT (user_data);
+  contents = NULL;
+  error = NULL;
+
+  g_file_load_contents_finish (G_FILE (source), result, &contents, NULL, NULL, &error);
+
+  /* Another load replaced this one */
+  if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+    goto out;
+
+  if (error)
+    {
+      emit_generic_error (error);
+      finish_loading (self);
+      goto out;
+    }
+
+  self->lines = g_strsplit (contents, "\n", -1);
+  self->next_line = 0;
+  self->load_tasks_id = g_idle_add (load_tasks_cb, self);
+
+out:
+  g_clear_error (&error);
+  g_free (contents);
+  g_object_unref (self);
+}
+
+/*
+ * The file is read asynchronously, and parsed in small chunks from
+ * idle callbacks, so large files don't block the main loop.
+ */
+static void
+start_loading (GtdProviderTodoTxt *self)
+{
+  g_return_if_fail (G_IS_FILE (self->source_file));
+
+  if (self->cancellable)
+    g_cancellable_cancel (self->cancellable);
+
+  if (self->load_tasks_id > 0)
+    {
+      g_source_remove (self->load_tasks_id);
+      self->load_tasks_id = 0;
+    }
+
+  g_clear_object (&self->cancellable);
+  g_clear_pointer (&self->lines, g_strfreev);
+
+  self->cancellable = g_cancellable_new ();
+  self->load_start = g_get_monotonic_time ();
+
+  g_file_load_contents_async (self->source_file,
+                              self->cancellable,
+                              load_contents_cb,
+                              g_object_ref (self));
 }
 
 static void
@@ -335,9 +551,6 @@ gtd_provider_todo_txt_reload (GFileMonitor       *monitor,
                               GtdProviderTodoTxt *self)
 {
   GList *l;
-  guint i;
-
-  l = NULL;
 
   if (!self->should_reload)
     {
@@ -345,27 +558,15 @@ gtd_provider_todo_txt_reload (GFileMonitor       *monitor,
       return;
     }
 
-  g_clear_pointer (&self->lists, g_hash_table_destroy);
-  g_clear_pointer (&self->tasks, g_hash_table_destroy);
-  g_ptr_array_free (self->cache, TRUE);
-
-  for (l = self->task_lists; l != NULL; l = l->next)
-    g_signal_emit_by_name (self, "list-removed", l->data);
-
-  g_list_free (self->task_lists);
-  self->task_lists = NULL;
-  self->lists = g_hash_table_new ((GHashFunc) g_str_hash, (GEqualFunc) g_str_equal);
-  self->tasks = g_hash_table_new ((GHashFunc) g_str_hash, (GEqualFunc) g_str_equal);
-  self->cache = g_ptr_array_new ();
-
-  gtd_provider_todo_txt_load_tasks (self);
-
-  for (i = 0; i < self->cache->len; i++)
+  /* The lists of a load in progress were not announced yet */
+  if (!self->cancellable)
     {
-      GtdTaskList *list;
-      list = g_ptr_array_index (self->cache, i);
-      g_signal_emit_by_name (self, "list-added", list);
+      for (l = self->task_lists; l != NULL; l = l->next)
+        g_signal_emit_by_name (self, "list-removed", l->data);
     }
+
+  reset_lists (self);
+  start_loading (self);
 }
 
 static void
@@ -436,6 +637,90 @@ gtd_provider_todo_txt_remove_task (GtdProvider *provider,
   update_source (self);
 }
 
+static void
+gtd_provider_todo_txt_create_task_async (GtdProvider         *provider,
+                                         GtdTask             *task,
+                                         GCancellable        *cancellable,
+                                         GAsyncReadyCallback  callback,
+                                         gpointer             user_data)
+{
+  g_return_if_fail (GTD_IS_TASK (task));
+  g_return_if_fail (GTD_IS_TASK_LIST (gtd_task_get_list (task)));
+
+  queue_write (GTD_PROVIDER_TODO_TXT (provider),
+               g_object_ref (task),
+               g_object_unref,
+               gtd_provider_todo_txt_create_task_async,
+               cancellable,
+               callback,
+               user_data);
+}
+
+static void
+gtd_provider_todo_txt_update_task_async (GtdProvider         *provider,
+                                         GtdTask             *task,
+                                         GCancellable        *cancellable,
+                                         GAsyncReadyCallback  callback,
+                                         gpointer             user_data)
+{
+  g_return_if_fail (GTD_IS_TASK (task));
+  g_return_if_fail (GTD_IS_TASK_LIST (gtd_task_get_list (task)));
+
+  queue_write (GTD_PROVIDER_TODO_TXT (provider),
+               g_object_ref (task),
+               g_object_unref,
+               gtd_provider_todo_txt_update_task_async,
+               cancellable,
+               callback,
+               user_data);
+}
+
+static void
+gtd_provider_todo_txt_remove_task_async (GtdProvider         *provider,
+                                         GtdTask             *task,
+                                         GCancellable        *cancellable,
+                                         GAsyncReadyCallback  callback,
+                                         gpointer             user_data)
+{
+  g_return_if_fail (GTD_IS_TASK (task));
+  g_return_if_fail (GTD_IS_TASK_LIST (gtd_task_get_list (task)));
+
+  queue_write (GTD_PROVIDER_TODO_TXT (provider),
+               g_object_ref (task),
+               g_object_unref,
+               gtd_provider_todo_txt_remove_task_async,
+               cancellable,
+               callback,
+               user_data);
+}
+
+static void
+gtd_provider_todo_txt_remove_tasks_async (GtdProvider         *provider,
+                                          GPtrArray           *tasks,
+                                          GCancellable        *cancellable,
+                                          GAsyncReadyCallback  callback,
+                                          gpointer             user_data)
+{
+  /* The whole batch is a single rewrite of the file */
+  queue_write (GTD_PROVIDER_TODO_TXT (provider),
+               g_ptr_array_ref (tasks),
+               (GDestroyNotify) g_ptr_array_unref,
+               gtd_provider_todo_txt_remove_tasks_async,
+               cancellable,
+               callback,
+               user_data);
+}
+
+static gboolean
+gtd_provider_todo_txt_finish_task_operation (GtdProvider   *provider,
+                                             GAsyncResult  *result,
+                                             GError       **error)
+{
+  g_return_val_if_fail (g_task_is_valid (result, provider), FALSE);
+
+  return g_task_propagate_boolean (G_TASK (result), error);
+}
+
 static void
 gtd_provider_todo_txt_create_task_list (GtdProvider *provider,
                                         GtdTaskList *list)
@@ -454,7 +739,9 @@ gtd_provider_todo_txt_create_task_list (GtdProvider *provider,
 
   update_source (self);
 
-  g_signal_emit_by_name (provider, "list-added", list);
+  /* Otherwise it's announced with the lists of the file */
+  if (!self->cancellable)
+    g_signal_emit_by_name (provider, "list-added", list);
 }
 
 static void
@@ -520,11 +807,20 @@ gtd_provider_iface_init (GtdProviderInterface *iface)
   iface->get_name = gtd_provider_todo_txt_get_name;
   iface->get_description = gtd_provider_todo_txt_get_description;
   iface->get_enabled = gtd_provider_todo_txt_get_enabled;
+  iface->get_lists_loaded = gtd_provider_todo_txt_get_lists_loaded;
   iface->get_icon = gtd_provider_todo_txt_get_icon;
   iface->get_edit_panel = gtd_provider_todo_txt_get_edit_panel;
   iface->create_task = gtd_provider_todo_txt_create_task;
   iface->update_task = gtd_provider_todo_txt_update_task;
   iface->remove_task = gtd_provider_todo_txt_remove_task;
+  iface->create_task_async = gtd_provider_todo_txt_create_task_async;
+  iface->create_task_finish = gtd_provider_todo_txt_finish_task_operation;
+  iface->update_task_async = gtd_provider_todo_txt_update_task_async;
+  iface->update_task_finish = gtd_provider_todo_txt_finish_task_operation;
+  iface->remove_task_async = gtd_provider_todo_txt_remove_task_async;
+  iface->remove_task_finish = gtd_provider_todo_txt_finish_task_operation;
+  iface->remove_tasks_async = gtd_provider_todo_txt_remove_tasks_async;
+  iface->remove_tasks_finish = gtd_provider_todo_txt_finish_task_operation;
   iface->create_task_list = gtd_provider_todo_txt_create_task_list;
   iface->update_task_list = gtd_provider_todo_txt_update_task_list;
   iface->remove_task_list = gtd_provider_todo_txt_remove_task_list;
@@ -547,6 +843,21 @@ gtd_provider_todo_txt_finalize (GObject *object)
 {
   GtdProviderTodoTxt *self = (GtdProviderTodoTxt *)object;
 
+  if (self->load_tasks_id > 0)
+    {
+      g_source_remove (self->load_tasks_id);
+      self->load_tasks_id = 0;
+    }
+
+  g_clear_object (&self->cancellable);
+  g_clear_pointer (&self->lines, g_strfreev);
+
+  if (self->write_source_id > 0)
+    {
+      g_source_remove (self->write_source_id);
+      self->write_source_id = 0;
+    }
+
   g_clear_pointer (&self->lists, g_hash_table_destroy);
   g_clear_pointer (&self->tasks, g_hash_table_destroy);
   g_ptr_array_free (self->cache, TRUE);
@@ -608,7 +919,9 @@ gtd_provider_todo_txt_set_property (GObject      *object,
     case PROP_SOURCE:
       self->source_file = g_value_dup_object (value);
       gtd_provider_todo_txt_load_source_monitor (self);
-      gtd_provider_todo_txt_load_tasks (self);
+
+      /* Lists are added when the whole file is loaded */
+      start_loading (self);
       break;
 
     default:
@@ -644,7 +957,8 @@ gtd_provider_todo_txt_class_init (GtdProviderTodoTxtClass *klass)
 static void
 gtd_provider_todo_txt_init (GtdProviderTodoTxt *self)
 {
-  gtd_object_set_ready (GTD_OBJECT (self), TRUE);
+  /* Not ready until the file is loaded */
+  gtd_object_set_ready (GTD_OBJECT (self), FALSE);
 
   self->lists = g_hash_table_new ((GHashFunc) g_str_hash, (GEqualFunc) g_str_equal);
   self->tasks = g_hash_table_new ((GHashFunc) g_str_hash, (GEqualFunc) g_str_equal);
@@ -29,6 +29,14 @@
 
 #define TODOIST_URL "https://todoist.com/API/v7/sync"
 
+/* Adaptive synchronization intervals, in seconds */
+#define SYNC_INTERVAL_ACTIVE   60
+#define SYNC_INTERVAL_IDLE     300
+#define SYNC_INTERVAL_MAX      1800
+
+/* Time without input after which the user is considered idle */
+#define USER_IDLE_TIMEOUT      (5 * 60 * G_USEC_PER_SEC)
+
 struct _GtdProviderTodoist
 {
   GtdObject           parent;
@@ -42,10 +50,22 @@ struct _GtdProviderTodoist
 
   GHashTable         *lists;
   GHashTable         *tasks;
+
+  /* Periodic synchronization */
+  guint               sync_timeout_id;
+  guint               sync_interval;
+  gint64              last_activity;
+  gboolean            sync_in_progress;
+  gboolean            sync_failed;
+
+  /* Whether the first synchronization finished */
+  gboolean            lists_loaded;
 };
 
 static void          gtd_provider_iface_init                     (GtdProviderInterface *iface);
 
+static void          synchronize_call                            (GtdProviderTodoist   *self);
+
 G_DEFINE_TYPE_WITH_CODE (GtdProviderTodoist, gtd_provider_todoist, GTD_TYPE_OBJECT,
                          G_IMPLEMENT_INTERFACE (GTD_TYPE_PROVIDER,
                                                 gtd_provider_iface_init))
@@ -120,6 +140,16 @@ gtd_provider_todoist_get_enabled (GtdProvider *provider)
   return TRUE;
 }
 
+static gboolean
+gtd_provider_todoist_get_lists_loaded (GtdProvider *provider)
+{
+  GtdProviderTodoist *self;
+
+  self = GTD_PROVIDER_TODOIST (provider);
+
+  return self->lists_loaded;
+}
+
 static GIcon*
 gtd_provider_todoist_get_icon (GtdProvider *provider)
 {
@@ -246,6 +276,13 @@ store_access_token (GtdProviderTodoist *self)
     }
 }
 
+static inline gboolean
+is_deleted (JsonObject *object)
+{
+  return json_object_has_member (object, "is_deleted") &&
+         json_object_get_int_member (object, "is_deleted");
+}
+
 static void
 parse_array_to_list (GtdProviderTodoist *self,
                      JsonArray          *projects)
@@ -260,28 +297,57 @@ parse_array_to_list (GtdProviderTodoist *self,
       JsonObject *object;
       GtdTaskList *list;
       const gchar *name;
-      gchar *uid;
+      GdkRGBA *color;
       guint32 id;
       guint color_index;
 
       object = json_node_get_object (l->data);
-      list = gtd_task_list_new (GTD_PROVIDER (self));
+
+      id = json_object_get_int_member (object, "id");
+      list = g_hash_table_lookup (self->lists, GUINT_TO_POINTER (id));
+
+      /* Incremental syncs report deleted projects */
+      if (is_deleted (object))
+        {
+          if (list)
+            {
+              g_hash_table_remove (self->lists, GUINT_TO_POINTER (id));
+              g_signal_emit_by_name (self, "list-removed", list);
+              g_object_unref (list);
+            }
+
+          continue;
+        }
 
       name = json_object_get_string_member (object, "name");
       color_index = json_object_get_int_member (object, "color");
-      id = json_object_get_int_member (object, "id");
+      color = convert_color_code (color_index);
+
+      if (!list)
+        {
+          g_autofree gchar *uid = NULL;
 
-      uid = g_strdup_printf ("%u", id);
+          uid = g_strdup_printf ("%u", id);
 
-      gtd_task_list_set_name (list, name);
-      gtd_task_list_set_color (list, convert_color_code (color_index));
-      gtd_task_list_set_is_removable (list, TRUE);
-      gtd_object_set_uid (GTD_OBJECT (list), uid);
-      g_hash_table_insert (self->lists, GUINT_TO_POINTER (id), list);
-      g_signal_emit_by_name (self, "list-added", list);
+          list = gtd_task_list_new (GTD_PROVIDER (self));
+          gtd_task_list_set_name (list, name);
+          gtd_task_list_set_color (list, color);
+          gtd_task_list_set_is_removable (list, TRUE);
+          gtd_object_set_uid (GTD_OBJECT (list), uid);
+          g_hash_table_insert (self->lists, GUINT_TO_POINTER (id), list);
+          g_signal_emit_by_name (self, "list-added", list);
+        }
+      else
+        {
+          gtd_task_list_set_name (list, name);
+          gtd_task_list_set_color (list, color);
+          g_signal_emit_by_name (self, "list-changed", list);
+        }
 
-      g_free (uid);
+      gdk_rgba_free (color);
     }
+
+  g_list_free (lists);
 }
 
 static GDateTime*
@@ -314,44 +380,77 @@ parse_array_to_task (GtdProviderTodoist *self,
 
   for (l = lists; l != NULL; l = l->next)
     {
+      g_autoptr (GDateTime) due_dt = NULL;
       JsonObject *object;
       GtdTaskList *list;
-      ECalComponent *component;
       GtdTask *task;
       const gchar *title;
       const gchar *due_date;
-      gchar *uid;
       guint32 id;
       guint32 project_id;
       gint priority;
       guint is_complete;
-
-      component = e_cal_component_new ();
-      e_cal_component_set_new_vtype (component, E_CAL_COMPONENT_TODO);
-      e_cal_component_set_uid (component, e_cal_component_gen_uid ());
+      gboolean is_new;
 
       object = json_node_get_object (l->data);
 
+      id = json_object_get_int_member (object, "id");
+      task = g_hash_table_lookup (self->tasks, GUINT_TO_POINTER (id));
+
+      /* Incremental syncs report deleted items */
+      if (is_deleted (object))
+        {
+          if (task)
+            {
+              g_hash_table_remove (self->tasks, GUINT_TO_POINTER (id));
+              gtd_task_list_remove_task (gtd_task_get_list (task), task);
+            }
+
+          continue;
+        }
+
       title = json_object_get_string_member (object, "content");
       priority = json_object_get_int_member (object, "priority");
-      id = json_object_get_int_member (object, "id");
       project_id = json_object_get_int_member (object, "project_id");
       is_complete = json_object_get_int_member (object, "checked");
       due_date = json_object_get_string_member (object, "due_date_utc");
 
       list = g_hash_table_lookup (self->lists, GUINT_TO_POINTER (project_id));
-      uid = g_strdup_printf ("%u", id);
+
+      if (!list)
+        continue;
+
+      is_new = !task;
+
+      if (is_new)
+        {
+          g_autofree gchar *uid = NULL;
+          ECalComponent *component;
+
+          component = e_cal_component_new ();
+          e_cal_component_set_new_vtype (component, E_CAL_COMPONENT_TODO);
+          e_cal_component_set_uid (component, e_cal_component_gen_uid ());
+
+          uid = g_strdup_printf ("%u", id);
+
+          task = gtd_task_new (component);
+          gtd_object_set_uid (GTD_OBJECT (task), uid);
+          gtd_task_set_list (task, list);
+        }
+      else if (gtd_task_get_list (task) != list)
+        {
+          /* The item was moved to another project */
+          gtd_task_list_remove_task (gtd_task_get_list (task), task);
+          gtd_task_set_list (task, list);
+        }
 
       /* Setup the task */
-      task = gtd_task_new (component);
-      gtd_object_set_uid (GTD_OBJECT (task), uid);
       gtd_task_set_title (task, title);
-      gtd_task_set_list (task, list);
       gtd_task_set_priority (task, priority);
       gtd_task_set_complete (task, is_complete);
 
       /* Setup the parent task */
-      if (!json_object_get_null_member (object, "parent_id"))
+      if (is_new && !json_object_get_null_member (object, "parent_id"))
         {
           GtdTask *parent_task;
           guint32 parent_id;
@@ -359,49 +458,86 @@ parse_array_to_task (GtdProviderTodoist *self,
           parent_id = json_object_get_int_member (object, "parent_id");
           parent_task = g_hash_table_lookup (self->tasks, GUINT_TO_POINTER (parent_id));
 
-          gtd_task_add_subtask (parent_task, task);
+          if (parent_task)
+            gtd_task_add_subtask (parent_task, task);
         }
 
       /* Due date */
-      if (due_date)
-        gtd_task_set_due_date (task, parse_due_date (due_date));
+      due_dt = due_date ? parse_due_date (due_date) : NULL;
+      gtd_task_set_due_date (task, due_dt);
 
-      g_hash_table_insert (self->tasks, GUINT_TO_POINTER (id), task);
-      gtd_task_list_save_task (list, task);
+      if (is_new)
+        g_hash_table_insert (self->tasks, GUINT_TO_POINTER (id), task);
 
-      g_free (uid);
+      gtd_task_list_save_task (list, task);
     }
+
+  g_list_free (lists);
 }
 
-static void
+/*
+ * Returns %TRUE if the response carried any project or item,
+ * %FALSE if the delta was empty.
+ */
+static gboolean
 load_tasks (GtdProviderTodoist *self,
             JsonObject         *object)
 {
   JsonArray *projects;
   JsonArray *items;
+  guint n_changes;
+
+  projects = NULL;
+  items = NULL;
+  n_changes = 0;
+
+  if (json_object_has_member (object, "projects"))
+    projects = json_object_get_array_member (object, "projects");
+
+  if (json_object_has_member (object, "items"))
+    items = json_object_get_array_member (object, "items");
+
+  if (projects)
+    {
+      n_changes += json_array_get_length (projects);
+      parse_array_to_list (self, projects);
+    }
 
-  projects = json_object_get_array_member (object, "projects");
-  items = json_object_get_array_member (object, "items");
+  if (items)
+    {
+      n_changes += json_array_get_length (items);
+      parse_array_to_task (self, items);
+    }
 
-  parse_array_to_list (self, projects);
-  parse_array_to_task (self, items);
+  return n_changes > 0;
 }
 
+/*
+ * When @notify_user is %FALSE, errors are only logged. This is used
+ * by the periodic synchronization so that a flaky connection doesn't
+ * flood the user with notifications.
+ */
 static gboolean
 check_post_response_for_errors (RestProxyCall *call,
                                 JsonParser    *parser,
-                                const GError  *error)
+                                const GError  *error,
+                                gboolean       notify_user)
 {
   GError *parse_error;
   const gchar *payload;
   guint status_code;
   gsize payload_length;
 
+  parse_error = NULL;
   status_code = rest_proxy_call_get_status_code (call);
 
   if (error)
     {
-      emit_generic_error (error);
+      if (notify_user)
+        emit_generic_error (error);
+      else
+        g_debug ("%s: %s", G_STRFUNC, error->message);
+
       return TRUE;
     }
 
@@ -411,11 +547,19 @@ check_post_response_for_errors (RestProxyCall *call,
 
       error_message = g_strdup_printf (_("Bad status code (%d) received. Please check your connection."), status_code);
 
-      gtd_manager_emit_error_message (gtd_manager_get_default (),
-                                      _("Error loading Todoist tasks"),
-                                      error_message,
-                                      NULL,
-                                      NULL);
+      if (notify_user)
+        {
+          gtd_manager_emit_error_message (gtd_manager_get_default (),
+                                          _("Error loading Todoist tasks"),
+                                          error_message,
+                                          NULL,
+                                          NULL);
+        }
+      else
+        {
+          g_debug ("%s: %s", G_STRFUNC, error_message);
+        }
+
       g_free (error_message);
       return TRUE;
     }
@@ -425,7 +569,11 @@ check_post_response_for_errors (RestProxyCall *call,
 
   if (!json_parser_load_from_data (parser, payload, payload_length, &parse_error))
     {
-      emit_generic_error (parse_error);
+      if (notify_user)
+        emit_generic_error (parse_error);
+      else
+        g_debug ("%s: %s", G_STRFUNC, parse_error->message);
+
       g_clear_error (&parse_error);
       return TRUE;
     }
@@ -433,7 +581,180 @@ check_post_response_for_errors (RestProxyCall *call,
   return FALSE;
 }
 
+/*
+ * Periodic synchronization
+ *
+ * The provider polls Todoist with the stored sync token. The interval is
+ * short while the window is focused and the user is interacting with it,
+ * and backs off exponentially (with jitter) when the user is idle, when
+ * syncs fail or when they return no changes. Polling stops while the
+ * session is suspended.
+ */
+static gboolean
+is_user_active (GtdProviderTodoist *self)
+{
+  GtkApplication *app;
+  GtkWindow *window;
+
+  app = GTK_APPLICATION (g_application_get_default ());
+  window = app ? gtk_application_get_active_window (app) : NULL;
+
+  if (!window || !gtk_window_is_active (window))
+    return FALSE;
+
+  return g_get_monotonic_time () - self->last_activity < USER_IDLE_TIMEOUT;
+}
+
+static void
+cancel_scheduled_sync (GtdProviderTodoist *self)
+{
+  if (self->sync_timeout_id > 0)
+    {
+      g_source_remove (self->sync_timeout_id);
+      self->sync_timeout_id = 0;
+    }
+}
+
+static gboolean
+sync_timeout_cb (gpointer user_data)
+{
+  GtdProviderTodoist *self = user_data;
+
+  self->sync_timeout_id = 0;
+
+  synchronize_call (self);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+schedule_sync (GtdProviderTodoist *self)
+{
+  GtdTimer *timer;
+  guint interval;
+
+  cancel_scheduled_sync (self);
+
+  timer = gtd_manager_get_timer (gtd_manager_get_default ());
+
+  /* Resuming or finishing the running sync will schedule it again */
+  if (self->sync_in_progress || gtd_timer_get_suspended (timer))
+    return;
+
+  interval = self->sync_interval;
+
+  /* Spread backed off polls so they don't line up with other clients */
+  if (interval > SYNC_INTERVAL_ACTIVE)
+    {
+      gint jitter = interval / 10;
+
+      interval += g_random_int_range (-jitter, jitter + 1);
+    }
+
+  g_debug ("Next Todoist sync in %u seconds", interval);
+
+  self->sync_timeout_id = g_timeout_add_seconds (interval, sync_timeout_cb, self);
+}
+
+static void
+update_sync_interval (GtdProviderTodoist *self,
+                      gboolean            back_off)
+{
+  guint base_interval;
+
+  base_interval = is_user_active (self) ? SYNC_INTERVAL_ACTIVE : SYNC_INTERVAL_IDLE;
+
+  if (back_off)
+    self->sync_interval = CLAMP (self->sync_interval * 2, base_interval, SYNC_INTERVAL_MAX);
+  else
+    self->sync_interval = base_interval;
+}
+
+static gboolean
+on_window_input_event_cb (GtkWidget          *widget,
+                          GdkEvent           *event,
+                          GtdProviderTodoist *self)
+{
+  self->last_activity = g_get_monotonic_time ();
+
+  return GDK_EVENT_PROPAGATE;
+}
+
+static void
+on_window_active_changed_cb (GtkWindow          *window,
+                             GParamSpec         *pspec,
+                             GtdProviderTodoist *self)
+{
+  if (!gtk_window_is_active (window))
+    return;
+
+  self->last_activity = g_get_monotonic_time ();
+
+  /* The user is back; stop backing off and poll soon */
+  if (self->sync_interval > SYNC_INTERVAL_ACTIVE)
+    {
+      self->sync_interval = SYNC_INTERVAL_ACTIVE;
+      schedule_sync (self);
+    }
+}
+
 static void
+on_timer_suspended_changed_cb (GtdTimer           *timer,
+                               GParamSpec         *pspec,
+                               GtdProviderTodoist *self)
+{
+  if (gtd_timer_get_suspended (timer))
+    {
+      cancel_scheduled_sync (self);
+      return;
+    }
+
+  /* Catch up with whatever happened while suspended */
+  update_sync_interval (self, FALSE);
+  synchronize_call (self);
+}
+
+static void
+start_sync_scheduler (GtdProviderTodoist *self)
+{
+  GtkApplication *app;
+  GtkWindow *window;
+
+  app = GTK_APPLICATION (g_application_get_default ());
+  window = app ? gtk_application_get_active_window (app) : NULL;
+
+  if (window)
+    {
+      g_signal_connect_object (window,
+                               "notify::is-active",
+                               G_CALLBACK (on_window_active_changed_cb),
+                               self,
+                               0);
+
+      g_signal_connect_object (window,
+                               "key-press-event",
+                               G_CALLBACK (on_window_input_event_cb),
+                               self,
+                               0);
+
+      g_signal_connect_object (window,
+                               "button-press-event",
+                               G_CALLBACK (on_window_input_event_cb),
+                               self,
+                               0);
+    }
+
+  g_signal_connect_object (gtd_manager_get_timer (gtd_manager_get_default ()),
+                           "notify::suspended",
+                           G_CALLBACK (on_timer_suspended_changed_cb),
+                           self,
+                           0);
+
+  self->last_activity = g_get_monotonic_time ();
+  update_sync_interval (self, FALSE);
+}
+
+static gboolean
 post (JsonObject                 *params,
       RestProxyCallAsyncCallback  callback,
       gpointer                    user_data)
@@ -443,8 +764,10 @@ post (JsonObject                 *params,
   GList *param;
   GList *l;
   GError *error;
+  gboolean started;
 
   error = NULL;
+  started = TRUE;
   proxy = rest_proxy_new (TODOIST_URL, FALSE);
   call = rest_proxy_new_call (proxy);
   param = json_object_get_members (params);
@@ -473,6 +796,7 @@ post (JsonObject                 *params,
     {
       emit_generic_error (error);
       g_clear_error (&error);
+      started = FALSE;
       goto out;
     }
 
@@ -480,6 +804,19 @@ out:
   g_object_unref (proxy);
   g_object_unref (call);
   g_list_free (param);
+
+  return started;
+}
+
+static void
+set_lists_loaded (GtdProviderTodoist *self)
+{
+  if (self->lists_loaded)
+    return;
+
+  self->lists_loaded = TRUE;
+
+  g_signal_emit_by_name (self, "lists-loaded");
 }
 
 static void
@@ -490,11 +827,22 @@ synchronize_call_cb (RestProxyCall      *call,
 {
   JsonObject *object;
   JsonParser *parser;
+  gboolean changed;
 
   parser = json_parser_new ();
+  changed = FALSE;
 
-  if (check_post_response_for_errors (call, parser, error))
-    goto out;
+  self->sync_in_progress = FALSE;
+
+  /* Only the first failure of a streak is reported to the user */
+  if (check_post_response_for_errors (call, parser, error, !self->sync_failed))
+    {
+      self->sync_failed = TRUE;
+      update_sync_interval (self, TRUE);
+      goto out;
+    }
+
+  self->sync_failed = FALSE;
 
   object = json_node_get_object (json_parser_get_root (parser));
 
@@ -504,9 +852,15 @@ synchronize_call_cb (RestProxyCall      *call,
       self->sync_token = g_strdup (json_object_get_string_member (object, "sync_token"));
     }
 
-  load_tasks (self, object);
+  changed = load_tasks (self, object);
+
+  /* Empty deltas mean nothing is happening remotely; poll less often */
+  update_sync_interval (self, !changed);
 
 out:
+  schedule_sync (self);
+  set_lists_loaded (self);
+
   g_object_unref (parser);
 }
 
@@ -521,7 +875,7 @@ post_generic_cb (RestProxyCall      *call,
 
   parser = json_parser_new ();
 
-  if (check_post_response_for_errors (call, parser, error))
+  if (check_post_response_for_errors (call, parser, error, TRUE))
     goto out;
 
   object = json_node_get_object (json_parser_get_root (parser));
@@ -536,6 +890,79 @@ out:
   g_object_unref (parser);
 }
 
+static void
+post_task_operation_cb (RestProxyCall *call,
+                        const GError  *error,
+                        GObject       *weak_object,
+                        GTask         *operation)
+{
+  GtdProviderTodoist *self;
+  JsonObject *object;
+  JsonParser *parser;
+
+  self = g_task_get_source_object (operation);
+  parser = json_parser_new ();
+
+  if (check_post_response_for_errors (call, parser, error, TRUE))
+    {
+      g_task_return_new_error (operation,
+                               G_IO_ERROR,
+                               G_IO_ERROR_FAILED,
+                               "Todoist rejected the command");
+      goto out;
+    }
+
+  object = json_node_get_object (json_parser_get_root (parser));
+
+  if (json_object_has_member (object, "sync_token"))
+    {
+      g_clear_pointer (&self->sync_token, g_free);
+      self->sync_token = g_strdup (json_object_get_string_member (object, "sync_token"));
+    }
+
+  /*
+   * The command can't be taken back once it reached the server, so
+   * cancelling only means that the caller is not interested anymore.
+   */
+  if (!g_task_return_error_if_cancelled (operation))
+    g_task_return_boolean (operation, TRUE);
+
+out:
+  g_object_unref (parser);
+  g_object_unref (operation);
+}
+
+/* Takes ownership of @operation */
+static void
+post_task_command (GtdProviderTodoist *self,
+                   const gchar        *command,
+                   GTask              *operation)
+{
+  JsonObject *params;
+
+  if (g_task_return_error_if_cancelled (operation))
+    {
+      g_object_unref (operation);
+      return;
+    }
+
+  params = json_object_new ();
+
+  json_object_set_string_member (params, "token", self->access_token);
+  json_object_set_string_member (params, "commands", command);
+
+  if (!post (params, (RestProxyCallAsyncCallback) post_task_operation_cb, operation))
+    {
+      g_task_return_new_error (operation,
+                               G_IO_ERROR,
+                               G_IO_ERROR_FAILED,
+                               "Could not send the command to Todoist");
+      g_object_unref (operation);
+    }
+
+  json_object_unref (params);
+}
+
 static void
 synchronize_call (GtdProviderTodoist *self)
 {
@@ -544,16 +971,28 @@ synchronize_call (GtdProviderTodoist *self)
   if (!self->access_token)
     {
       emit_access_token_error ();
+      set_lists_loaded (self);
       return;
     }
 
+  if (self->sync_in_progress)
+    return;
+
+  cancel_scheduled_sync (self);
+
+  self->sync_in_progress = TRUE;
+
   params = json_object_new ();
 
   json_object_set_string_member (params, "token", self->access_token);
   json_object_set_string_member (params, "sync_token", self->sync_token);
   json_object_set_string_member (params, "resource_types", "[\"all\"]");
 
-  post (params, (RestProxyCallAsyncCallback) synchronize_call_cb, self);
+  if (!post (params, (RestProxyCallAsyncCallback) synchronize_call_cb, self))
+    {
+      self->sync_in_progress = FALSE;
+      set_lists_loaded (self);
+    }
 
   json_object_unref (params);
 }
@@ -565,34 +1004,21 @@ gtd_provider_todoist_create_task (GtdProvider *provider,
 
 }
 
-static void
-gtd_provider_todoist_update_task (GtdProvider *provider,
-                                  GtdTask     *task)
+static gchar*
+create_update_command (GtdTask *task)
 {
-  GtdProviderTodoist *self;
-  JsonObject *params;
   GtdTask *parent;
   GDateTime *due_date;
-  g_autofree gchar *command;
-  g_autofree gchar *command_uuid;
-  g_autofree gchar *due_dt;
+  g_autofree gchar *command_uuid = NULL;
+  g_autofree gchar *due_dt = NULL;
+  gchar *command;
 
-  self = GTD_PROVIDER_TODOIST (provider);
-  due_dt = command = command_uuid = NULL;
-
-  if (!self->access_token)
-    {
-      emit_access_token_error ();
-      return;
-    }
-
-  params = json_object_new ();
   parent = gtd_task_get_parent (task);
   due_date = gtd_task_get_due_date (task);
 
   if (due_date)
     {
-      g_autofree gchar *date_format;
+      g_autofree gchar *date_format = NULL;
 
       date_format = g_date_time_format (due_date, "%FT%R");
       due_dt = g_strdup_printf ("\"%s\"", date_format);
@@ -617,12 +1043,67 @@ gtd_provider_todoist_update_task (GtdProvider *provider,
                              gtd_task_get_complete (task),
                              due_dt);
 
+  g_clear_pointer (&due_date, g_date_time_unref);
+
+  return command;
+}
+
+/* A single command removes all the @n_tasks @tasks */
+static gchar*
+create_remove_command (GtdTask **tasks,
+                       guint     n_tasks)
+{
+  g_autofree gchar *command_uuid = NULL;
+  GString *ids;
+  gchar *command;
+  guint i;
+
+  ids = g_string_new (NULL);
+
+  for (i = 0; i < n_tasks; i++)
+    {
+      if (i > 0)
+        g_string_append (ids, ", ");
+
+      g_string_append (ids, gtd_object_get_uid (GTD_OBJECT (tasks[i])));
+    }
+
+  command_uuid = g_uuid_string_random ();
+  command = g_strdup_printf ("[{\"type\": \"item_delete\", \"uuid\": \"%s\", "
+                             "\"args\": {\"ids\": [%s]}}]",
+                             command_uuid,
+                             ids->str);
+
+  g_string_free (ids, TRUE);
+
+  return command;
+}
+
+static void
+gtd_provider_todoist_update_task (GtdProvider *provider,
+                                  GtdTask     *task)
+{
+  GtdProviderTodoist *self;
+  JsonObject *params;
+  g_autofree gchar *command = NULL;
+
+  self = GTD_PROVIDER_TODOIST (provider);
+
+  if (!self->access_token)
+    {
+      emit_access_token_error ();
+      return;
+    }
+
+  params = json_object_new ();
+  command = create_update_command (task);
+
   json_object_set_string_member (params, "token", self->access_token);
   json_object_set_string_member (params, "commands", command);
 
   post (params, (RestProxyCallAsyncCallback) post_generic_cb, self);
 
-  g_clear_pointer (&due_date, g_date_time_unref);
+  json_object_unref (params);
 }
 
 static void
@@ -631,11 +1112,9 @@ gtd_provider_todoist_remove_task (GtdProvider *provider,
 {
   GtdProviderTodoist *self;
   JsonObject *params;
-  g_autofree gchar *command;
-  g_autofree gchar *command_uuid;
+  g_autofree gchar *command = NULL;
 
   self = GTD_PROVIDER_TODOIST (provider);
-  command = command_uuid = NULL;
 
   if (!self->access_token)
     {
@@ -644,17 +1123,144 @@ gtd_provider_todoist_remove_task (GtdProvider *provider,
     }
 
   params = json_object_new ();
-
-  command_uuid = g_uuid_string_random ();
-  command = g_strdup_printf ("[{\"type\": \"item_delete\", \"uuid\": \"%s\", "
-                             "\"args\": {\"ids\": [%s]}}]",
-                             command_uuid,
-                             gtd_object_get_uid (GTD_OBJECT (task)));
+  command = create_remove_command (&task, 1);
 
   json_object_set_string_member (params, "token", self->access_token);
   json_object_set_string_member (params, "commands", command);
 
   post (params, (RestProxyCallAsyncCallback) post_generic_cb, self);
+
+  json_object_unref (params);
+}
+
+static GTask*
+create_task_operation (GtdProviderTodoist  *self,
+                       GtdTask             *task,
+                       gpointer             source_tag,
+                       GCancellable        *cancellable,
+                       GAsyncReadyCallback  callback,
+                       gpointer             user_data)
+{
+  GTask *operation;
+
+  operation = g_task_new (self, cancellable, callback, user_data);
+  g_task_set_source_tag (operation, source_tag);
+
+  if (task)
+    g_task_set_task_data (operation, g_object_ref (task), g_object_unref);
+
+  if (!self->access_token)
+    {
+      emit_access_token_error ();
+
+      g_task_return_new_error (operation,
+                               G_IO_ERROR,
+                               G_IO_ERROR_PERMISSION_DENIED,
+                               "No access token for the Todoist account");
+      g_clear_object (&operation);
+    }
+
+  return operation;
+}
+
+static void
+gtd_provider_todoist_update_task_async (GtdProvider         *provider,
+                                        GtdTask             *task,
+                                        GCancellable        *cancellable,
+                                        GAsyncReadyCallback  callback,
+                                        gpointer             user_data)
+{
+  GtdProviderTodoist *self;
+  g_autofree gchar *command = NULL;
+  GTask *operation;
+
+  self = GTD_PROVIDER_TODOIST (provider);
+  operation = create_task_operation (self,
+                                     task,
+                                     gtd_provider_todoist_update_task_async,
+                                     cancellable,
+                                     callback,
+                                     user_data);
+
+  if (!operation)
+    return;
+
+  command = create_update_command (task);
+
+  post_task_command (self, command, operation);
+}
+
+static void
+gtd_provider_todoist_remove_task_async (GtdProvider         *provider,
+                                        GtdTask             *task,
+                                        GCancellable        *cancellable,
+                                        GAsyncReadyCallback  callback,
+                                        gpointer             user_data)
+{
+  GtdProviderTodoist *self;
+  g_autofree gchar *command = NULL;
+  GTask *operation;
+
+  self = GTD_PROVIDER_TODOIST (provider);
+  operation = create_task_operation (self,
+                                     task,
+                                     gtd_provider_todoist_remove_task_async,
+                                     cancellable,
+                                     callback,
+                                     user_data);
+
+  if (!operation)
+    return;
+
+  command = create_remove_command (&task, 1);
+
+  post_task_command (self, command, operation);
+}
+
+static void
+gtd_provider_todoist_remove_tasks_async (GtdProvider         *provider,
+                                         GPtrArray           *tasks,
+                                         GCancellable        *cancellable,
+                                         GAsyncReadyCallback  callback,
+                                         gpointer             user_data)
+{
+  GtdProviderTodoist *self;
+  g_autofree gchar *command = NULL;
+  GTask *operation;
+
+  self = GTD_PROVIDER_TODOIST (provider);
+  operation = create_task_operation (self,
+                                     NULL,
+                                     gtd_provider_todoist_remove_tasks_async,
+                                     cancellable,
+                                     callback,
+                                     user_data);
+
+  if (!operation)
+    return;
+
+  g_task_set_task_data (operation, g_ptr_array_ref (tasks), (GDestroyNotify) g_ptr_array_unref);
+
+  if (tasks->len == 0)
+    {
+      g_task_return_boolean (operation, TRUE);
+      g_object_unref (operation);
+      return;
+    }
+
+  command = create_remove_command ((GtdTask**) tasks->pdata, tasks->len);
+
+  post_task_command (self, command, operation);
+}
+
+static gboolean
+gtd_provider_todoist_finish_task_operation (GtdProvider   *provider,
+                                            GAsyncResult  *result,
+                                            GError       **error)
+{
+  g_return_val_if_fail (g_task_is_valid (result, provider), FALSE);
+
+  return g_task_propagate_boolean (G_TASK (result), error);
 }
 
 static void
@@ -671,8 +1277,8 @@ gtd_provider_todoist_update_task_list (GtdProvider *provider,
   GtdProviderTodoist *self;
   JsonObject *params;
   GdkRGBA *list_color;
-  g_autofree gchar *command;
-  g_autofree gchar *command_uuid;
+  g_autofree gchar *command = NULL;
+  g_autofree gchar *command_uuid = NULL;
 
   self = GTD_PROVIDER_TODOIST (provider);
   command = command_uuid = NULL;
@@ -708,8 +1314,8 @@ gtd_provider_todoist_remove_task_list (GtdProvider *provider,
 {
   GtdProviderTodoist *self;
   JsonObject *params;
-  g_autofree gchar *command;
-  g_autofree gchar *command_uuid;
+  g_autofree gchar *command = NULL;
+  g_autofree gchar *command_uuid = NULL;
 
   self = GTD_PROVIDER_TODOIST (provider);
   command = command_uuid = NULL;
@@ -777,11 +1383,18 @@ gtd_provider_iface_init (GtdProviderInterface *iface)
   iface->get_name = gtd_provider_todoist_get_name;
   iface->get_description = gtd_provider_todoist_get_description;
   iface->get_enabled = gtd_provider_todoist_get_enabled;
+  iface->get_lists_loaded = gtd_provider_todoist_get_lists_loaded;
   iface->get_icon = gtd_provider_todoist_get_icon;
   iface->get_edit_panel = gtd_provider_todoist_get_edit_panel;
   iface->create_task = gtd_provider_todoist_create_task;
   iface->update_task = gtd_provider_todoist_update_task;
   iface->remove_task = gtd_provider_todoist_remove_task;
+  iface->update_task_async = gtd_provider_todoist_update_task_async;
+  iface->update_task_finish = gtd_provider_todoist_finish_task_operation;
+  iface->remove_task_async = gtd_provider_todoist_remove_task_async;
+  iface->remove_task_finish = gtd_provider_todoist_finish_task_operation;
+  iface->remove_tasks_async = gtd_provider_todoist_remove_tasks_async;
+  iface->remove_tasks_finish = gtd_provider_todoist_finish_task_operation;
   iface->create_task_list = gtd_provider_todoist_create_task_list;
   iface->update_task_list = gtd_provider_todoist_update_task_list;
   iface->remove_task_list = gtd_provider_todoist_remove_task_list;
@@ -804,6 +1417,8 @@ gtd_provider_todoist_finalize (GObject *object)
 {
   GtdProviderTodoist *self = (GtdProviderTodoist *)object;
 
+  cancel_scheduled_sync (self);
+
   g_clear_pointer (&self->lists, g_hash_table_destroy);
   g_clear_pointer (&self->tasks, g_hash_table_destroy);
   g_clear_object (&self->icon);
@@ -872,7 +1487,14 @@ gtd_provider_todoist_set_property (GObject      *object,
 
       /* Only synchronize if we have an access token */
       if (self->access_token)
-        synchronize_call (self);
+        {
+          start_sync_scheduler (self);
+          synchronize_call (self);
+        }
+      else
+        {
+          set_lists_loaded (self);
+        }
 
       break;
 
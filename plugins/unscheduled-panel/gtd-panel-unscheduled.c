@@ -0,0 +1,229 @@
+/* gtd-panel-unscheduled.c
+ *
+ * Copyright (C) 2017 Georges Basile Stavracas Neto <georges.stavracas@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtd-panel-unscheduled.h"
+
+#include <glib/gi18n.h>
+#include <gnome-todo.h>
+
+struct _GtdPanelUnscheduled
+{
+  GtkBox              parent;
+
+  GMenu              *menu;
+
+  gchar              *title;
+  GtkWidget          *view;
+
+  /* Follows the tasks without a due date */
+  GtdTaskTracker     *tracker;
+};
+
+static void          gtd_panel_iface_init                        (GtdPanelInterface  *iface);
+
+G_DEFINE_TYPE_EXTENDED (GtdPanelUnscheduled, gtd_panel_unscheduled, GTK_TYPE_BOX,
+                        0,
+                        G_IMPLEMENT_INTERFACE (GTD_TYPE_PANEL,
+                                               gtd_panel_iface_init))
+
+#define GTD_PANEL_UNSCHEDULED_NAME "unscheduled-panel"
+
+enum {
+  PROP_0,
+  PROP_MENU,
+  PROP_NAME,
+  PROP_TITLE,
+  N_PROPS
+};
+
+static void
+update_title (GtdPanelUnscheduled *panel)
+{
+  guint number_of_tasks;
+
+  number_of_tasks = gtd_task_tracker_get_n_incomplete_tasks (panel->tracker);
+
+  g_clear_pointer (&panel->title, g_free);
+
+  if (number_of_tasks == 0)
+    {
+      /* Translators: 'Unscheduled' as in 'Unscheduled tasks' */
+      panel->title = g_strdup (_("Unscheduled"));
+    }
+  else
+    {
+      /* Translators: 'Unscheduled' as in 'Unscheduled tasks' */
+      panel->title = g_strdup_printf ("%s (%d)",
+                                      _("Unscheduled"),
+                                      number_of_tasks);
+    }
+
+  g_object_notify (G_OBJECT (panel), "title");
+}
+
+static gboolean
+is_task_unscheduled (GtdTask             *task,
+                     GtdPanelUnscheduled *panel)
+{
+  g_autoptr (GDateTime) due_date = NULL;
+
+  due_date = gtd_task_get_due_date (task);
+
+  return !due_date;
+}
+
+/**********************
+ * GtdPanel iface init
+ **********************/
+static const gchar*
+gtd_panel_unscheduled_get_panel_name (GtdPanel *panel)
+{
+  return GTD_PANEL_UNSCHEDULED_NAME;
+}
+
+static const gchar*
+gtd_panel_unscheduled_get_panel_title (GtdPanel *panel)
+{
+  return GTD_PANEL_UNSCHEDULED (panel)->title;
+}
+
+static GList*
+gtd_panel_unscheduled_get_header_widgets (GtdPanel *panel)
+{
+  return NULL;
+}
+
+static const GMenu*
+gtd_panel_unscheduled_get_menu (GtdPanel *panel)
+{
+  return GTD_PANEL_UNSCHEDULED (panel)->menu;
+}
+
+static void
+gtd_panel_iface_init (GtdPanelInterface *iface)
+{
+  iface->get_panel_name = gtd_panel_unscheduled_get_panel_name;
+  iface->get_panel_title = gtd_panel_unscheduled_get_panel_title;
+  iface->get_header_widgets = gtd_panel_unscheduled_get_header_widgets;
+  iface->get_menu = gtd_panel_unscheduled_get_menu;
+}
+
+static void
+gtd_panel_unscheduled_finalize (GObject *object)
+{
+  GtdPanelUnscheduled *self = (GtdPanelUnscheduled *)object;
+
+  g_clear_object (&self->menu);
+  g_clear_pointer (&self->title, g_free);
+  g_clear_object (&self->tracker);
+
+  G_OBJECT_CLASS (gtd_panel_unscheduled_parent_class)->finalize (object);
+}
+
+static void
+gtd_panel_unscheduled_get_property (GObject    *object,
+                                    guint       prop_id,
+                                    GValue     *value,
+                                    GParamSpec *pspec)
+{
+  GtdPanelUnscheduled *self = GTD_PANEL_UNSCHEDULED (object);
+
+  switch (prop_id)
+    {
+    case PROP_MENU:
+      g_value_set_object (value, NULL);
+      break;
+
+    case PROP_NAME:
+      g_value_set_string (value, GTD_PANEL_UNSCHEDULED_NAME);
+      break;
+
+    case PROP_TITLE:
+      g_value_set_string (value, self->title);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+    }
+}
+
+static void
+gtd_panel_unscheduled_set_property (GObject      *object,
+                                    guint         prop_id,
+                                    const GValue *value,
+                                    GParamSpec   *pspec)
+{
+  G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+}
+
+static void
+gtd_panel_unscheduled_class_init (GtdPanelUnscheduledClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->finalize = gtd_panel_unscheduled_finalize;
+  object_class->get_property = gtd_panel_unscheduled_get_property;
+  object_class->set_property = gtd_panel_unscheduled_set_property;
+
+  g_object_class_override_property (object_class, PROP_MENU, "menu");
+  g_object_class_override_property (object_class, PROP_NAME, "name");
+  g_object_class_override_property (object_class, PROP_TITLE, "title");
+}
+
+static void
+gtd_panel_unscheduled_init (GtdPanelUnscheduled *self)
+{
+  /* Setup a title */
+  self->title = g_strdup (_("Unscheduled"));
+
+  /* Menu */
+  self->menu = g_menu_new ();
+  g_menu_append (self->menu,
+                 _("Clear completed tasks…"),
+                 "list.clear-completed-tasks");
+
+  /* The main view */
+  self->view = gtd_task_list_view_new ();
+  gtd_task_list_view_set_handle_subtasks (GTD_TASK_LIST_VIEW (self->view), FALSE);
+  gtd_task_list_view_set_show_list_name (GTD_TASK_LIST_VIEW (self->view), TRUE);
+
+  gtk_widget_set_hexpand (self->view, TRUE);
+  gtk_widget_set_vexpand (self->view, TRUE);
+  gtk_container_add (GTK_CONTAINER (self), self->view);
+
+  gtk_widget_show_all (GTK_WIDGET (self));
+
+  /* Track the tasks of the current and future lists */
+  self->tracker = gtd_task_tracker_new (GTD_TASK_LIST_VIEW (self->view),
+                                        (GtdTaskTrackerFilterFunc) is_task_unscheduled,
+                                        self);
+
+  g_signal_connect_object (self->tracker,
+                           "notify::n-incomplete-tasks",
+                           G_CALLBACK (update_title),
+                           self,
+                           G_CONNECT_SWAPPED);
+
+  gtd_task_tracker_start (self->tracker);
+}
+
+GtkWidget*
+gtd_panel_unscheduled_new (void)
+{
+  return g_object_new (GTD_TYPE_PANEL_UNSCHEDULED, NULL);
+}
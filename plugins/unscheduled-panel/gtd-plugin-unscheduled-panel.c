@@ -0,0 +1,166 @@
+/* gtd-plugin-unscheduled-panel.c
+ *
+ * Copyright (C) 2017 Georges Basile Stavracas Neto <georges.stavracas@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define G_LOG_DOMAIN "Unscheduled"
+
+#include "gtd-panel-unscheduled.h"
+#include "gtd-plugin-unscheduled-panel.h"
+
+#include <glib/gi18n.h>
+#include <glib-object.h>
+
+struct _GtdPluginUnscheduledPanel
+{
+  PeasExtensionBase   parent;
+
+  GList              *panels;
+};
+
+static void          gtd_activatable_iface_init                  (GtdActivatableInterface  *iface);
+
+G_DEFINE_DYNAMIC_TYPE_EXTENDED (GtdPluginUnscheduledPanel, gtd_plugin_unscheduled_panel, PEAS_TYPE_EXTENSION_BASE,
+                                0,
+                                G_IMPLEMENT_INTERFACE_DYNAMIC (GTD_TYPE_ACTIVATABLE,
+                                                               gtd_activatable_iface_init))
+
+enum {
+  PROP_0,
+  PROP_PREFERENCES_PANEL,
+  N_PROPS
+};
+
+/*
+ * GtdActivatable interface implementation
+ */
+static void
+gtd_plugin_unscheduled_panel_activate (GtdActivatable *activatable)
+{
+  GtdPluginUnscheduledPanel *self = GTD_PLUGIN_UNSCHEDULED_PANEL (activatable);
+  GtkWidget *panel;
+
+  panel = gtd_panel_unscheduled_new ();
+  self->panels = g_list_append (NULL, panel);
+
+  g_signal_emit_by_name (self, "panel-added", panel);
+}
+
+static void
+gtd_plugin_unscheduled_panel_deactivate (GtdActivatable *activatable)
+{
+  GtdPluginUnscheduledPanel *self = GTD_PLUGIN_UNSCHEDULED_PANEL (activatable);
+
+  /* The plugin manager already removed the panel */
+  g_clear_pointer (&self->panels, g_list_free);
+}
+
+static GList*
+gtd_plugin_unscheduled_panel_get_header_widgets (GtdActivatable *activatable)
+{
+  return NULL;
+}
+
+static GtkWidget*
+gtd_plugin_unscheduled_panel_get_preferences_panel (GtdActivatable *activatable)
+{
+  return NULL;
+}
+
+static GList*
+gtd_plugin_unscheduled_panel_get_panels (GtdActivatable *activatable)
+{
+  GtdPluginUnscheduledPanel *plugin = GTD_PLUGIN_UNSCHEDULED_PANEL (activatable);
+
+  return plugin->panels;
+}
+
+static GList*
+gtd_plugin_unscheduled_panel_get_providers (GtdActivatable *activatable)
+{
+  return NULL;
+}
+
+static void
+gtd_activatable_iface_init (GtdActivatableInterface *iface)
+{
+  iface->activate = gtd_plugin_unscheduled_panel_activate;
+  iface->deactivate = gtd_plugin_unscheduled_panel_deactivate;
+  iface->get_header_widgets = gtd_plugin_unscheduled_panel_get_header_widgets;
+  iface->get_preferences_panel = gtd_plugin_unscheduled_panel_get_preferences_panel;
+  iface->get_panels = gtd_plugin_unscheduled_panel_get_panels;
+  iface->get_providers = gtd_plugin_unscheduled_panel_get_providers;
+}
+
+static void
+gtd_plugin_unscheduled_panel_finalize (GObject *object)
+{
+  GtdPluginUnscheduledPanel *self = (GtdPluginUnscheduledPanel *)object;
+
+  g_list_free (self->panels);
+
+  G_OBJECT_CLASS (gtd_plugin_unscheduled_panel_parent_class)->finalize (object);
+}
+
+static void
+gtd_plugin_unscheduled_panel_get_property (GObject    *object,
+                                           guint       prop_id,
+                                           GValue     *value,
+                                           GParamSpec *pspec)
+{
+  switch (prop_id)
+    {
+    case PROP_PREFERENCES_PANEL:
+      g_value_set_object (value, NULL);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+    }
+}
+
+static void
+gtd_plugin_unscheduled_panel_class_init (GtdPluginUnscheduledPanelClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->finalize = gtd_plugin_unscheduled_panel_finalize;
+  object_class->get_property = gtd_plugin_unscheduled_panel_get_property;
+
+  g_object_class_override_property (object_class,
+                                    PROP_PREFERENCES_PANEL,
+                                    "preferences-panel");
+}
+
+static void
+gtd_plugin_unscheduled_panel_init (GtdPluginUnscheduledPanel *self)
+{
+}
+
+static void
+gtd_plugin_unscheduled_panel_class_finalize (GtdPluginUnscheduledPanelClass *klass)
+{
+}
+
+G_MODULE_EXPORT void
+gtd_plugin_unscheduled_panel_register_types (PeasObjectModule *module)
+{
+  gtd_plugin_unscheduled_panel_register_type (G_TYPE_MODULE (module));
+
+  peas_object_module_register_extension_type (module,
+                                              GTD_TYPE_ACTIVATABLE,
+                                              GTD_TYPE_PLUGIN_UNSCHEDULED_PANEL);
+}
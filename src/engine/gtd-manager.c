@@ -21,6 +21,7 @@
 #include "gtd-manager.h"
 #include "gtd-manager-protected.h"
 #include "gtd-plugin-manager.h"
+#include "gtd-snapshot.h"
 #include "gtd-task.h"
 #include "gtd-task-list.h"
 #include "gtd-timer.h"
@@ -42,6 +43,41 @@
  * To Do. This will create a #GtdNotification internally.
  */
 
+/* Maximum number of task operations running at the same time on a provider */
+#define MAX_OPERATIONS_PER_PROVIDER 4
+
+typedef enum
+{
+  TASK_OPERATION_CREATE,
+  TASK_OPERATION_UPDATE,
+  TASK_OPERATION_REMOVE,
+  TASK_OPERATION_REMOVE_MANY
+} TaskOperationType;
+
+typedef struct
+{
+  GtdManager          *manager;
+  TaskOperationType    type;
+  GtdProvider         *provider;
+  GtdTask             *task;
+  GPtrArray           *tasks; /* TASK_OPERATION_REMOVE_MANY */
+  GCancellable        *cancellable;
+} TaskOperation;
+
+typedef struct
+{
+  /* Operations waiting for a free slot, in the order they were requested */
+  GQueue              *queue;
+  GList               *running;
+  guint                n_running;
+
+  /* Tasks with an operation running, so that they're never reordered */
+  GHashTable          *busy_tasks;
+
+  /* GtdTask → TaskOperation of a queued update */
+  GHashTable          *queued_updates;
+} ProviderOperations;
+
 typedef struct
 {
   GSettings             *settings;
@@ -52,6 +88,13 @@ typedef struct
   GList                 *panels;
   GtdProvider           *default_provider;
   GtdTimer              *timer;
+
+  /* List key → GtdTaskList loaded from the snapshot */
+  GHashTable            *snapshot_lists;
+  guint                  save_snapshot_id;
+
+  /* GtdProvider → ProviderOperations */
+  GHashTable            *operations;
 } GtdManagerPrivate;
 
 struct _GtdManager
@@ -124,14 +167,91 @@ emit_show_error_message (GtdManager                *manager,
                  user_data);
 }
 
+static TaskOperation*
+task_operation_new (GtdManager        *manager,
+                    TaskOperationType  type,
+                    GtdProvider       *provider,
+                    GtdTask           *task)
+{
+  TaskOperation *operation;
+
+  operation = g_slice_new0 (TaskOperation);
+  operation->manager = manager;
+  operation->type = type;
+  operation->provider = g_object_ref (provider);
+  operation->task = g_object_ref (task);
+  operation->cancellable = g_cancellable_new ();
+
+  return operation;
+}
+
+static TaskOperation*
+task_operation_new_batch (GtdManager        *manager,
+                          TaskOperationType  type,
+                          GtdProvider       *provider,
+                          GPtrArray         *tasks)
+{
+  TaskOperation *operation;
+
+  operation = g_slice_new0 (TaskOperation);
+  operation->manager = manager;
+  operation->type = type;
+  operation->provider = g_object_ref (provider);
+  operation->tasks = g_ptr_array_ref (tasks);
+  operation->cancellable = g_cancellable_new ();
+
+  return operation;
+}
+
+static void
+task_operation_free (TaskOperation *operation)
+{
+  g_clear_object (&operation->provider);
+  g_clear_object (&operation->task);
+  g_clear_pointer (&operation->tasks, g_ptr_array_unref);
+  g_clear_object (&operation->cancellable);
+  g_slice_free (TaskOperation, operation);
+}
+
+static ProviderOperations*
+provider_operations_new (void)
+{
+  ProviderOperations *operations;
+
+  operations = g_slice_new0 (ProviderOperations);
+  operations->queue = g_queue_new ();
+  operations->busy_tasks = g_hash_table_new (g_direct_hash, g_direct_equal);
+  operations->queued_updates = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+  return operations;
+}
+
+static void
+provider_operations_free (ProviderOperations *operations)
+{
+  g_queue_free_full (operations->queue, (GDestroyNotify) task_operation_free);
+  g_list_free (operations->running);
+  g_hash_table_destroy (operations->busy_tasks);
+  g_hash_table_destroy (operations->queued_updates);
+  g_slice_free (ProviderOperations, operations);
+}
+
 static void
 gtd_manager_finalize (GObject *object)
 {
   GtdManager *self = (GtdManager *)object;
 
+  if (self->priv->save_snapshot_id > 0)
+    {
+      g_source_remove (self->priv->save_snapshot_id);
+      self->priv->save_snapshot_id = 0;
+    }
+
   g_clear_object (&self->priv->plugin_manager);
   g_clear_object (&self->priv->settings);
   g_clear_object (&self->priv->timer);
+  g_clear_pointer (&self->priv->snapshot_lists, g_hash_table_destroy);
+  g_clear_pointer (&self->priv->operations, g_hash_table_destroy);
 
   G_OBJECT_CLASS (gtd_manager_parent_class)->finalize (object);
 }
@@ -427,12 +547,517 @@ gtd_manager__default_list_changed_cb (GtdProvider *provider,
   g_object_notify (G_OBJECT (self), "default-task-list");
 }
 
+/*
+ * Snapshot
+ */
+static gboolean
+save_snapshot_cb (gpointer user_data)
+{
+  GtdManagerPrivate *priv;
+  g_autoptr (GError) error = NULL;
+  gint64 start;
+
+  priv = gtd_manager_get_instance_private (user_data);
+  start = g_get_monotonic_time ();
+
+  priv->save_snapshot_id = 0;
+
+  if (!gtd_snapshot_save (priv->tasklists, &error))
+    g_warning ("Error saving snapshot: %s", error->message);
+  else
+    g_debug ("Snapshot saved in %.3lfms", (g_get_monotonic_time () - start) / 1000.0);
+
+  return G_SOURCE_REMOVE;
+}
+
+/*
+ * Whether the providers with @provider_id, or all the providers when
+ * @provider_id is %NULL, added the lists they had at startup.
+ */
+static gboolean
+providers_lists_loaded (GtdManager  *self,
+                        const gchar *provider_id)
+{
+  GtdManagerPrivate *priv = gtd_manager_get_instance_private (self);
+  GList *l;
+
+  for (l = priv->providers; l != NULL; l = l->next)
+    {
+      if (provider_id && g_strcmp0 (gtd_provider_get_id (l->data), provider_id) != 0)
+        continue;
+
+      if (!gtd_provider_get_lists_loaded (l->data))
+        return FALSE;
+    }
+
+  return TRUE;
+}
+
+static void
+queue_save_snapshot (GtdManager *self)
+{
+  GtdManagerPrivate *priv = gtd_manager_get_instance_private (self);
+
+  /* Don't save partially loaded states */
+  if (priv->save_snapshot_id > 0 ||
+      g_hash_table_size (priv->snapshot_lists) > 0 ||
+      !gtd_object_get_ready (GTD_OBJECT (self)) ||
+      !providers_lists_loaded (self, NULL))
+    {
+      return;
+    }
+
+  priv->save_snapshot_id = g_idle_add_full (G_PRIORITY_LOW, save_snapshot_cb, self, NULL);
+}
+
+static void
+remove_snapshot_list (GtdManager  *self,
+                      const gchar *key)
+{
+  GtdManagerPrivate *priv = gtd_manager_get_instance_private (self);
+  GtdTaskList *list;
+
+  list = g_hash_table_lookup (priv->snapshot_lists, key);
+
+  if (!list)
+    return;
+
+  priv->tasklists = g_list_remove (priv->tasklists, list);
+
+  g_signal_emit (self, signals[LIST_REMOVED], 0, list);
+
+  g_hash_table_remove (priv->snapshot_lists, key);
+}
+
+/*
+ * Drops the snapshot lists of the providers with @provider_id, or of
+ * any provider when @provider_id is %NULL, that weren't replaced by a
+ * real list and aren't about to be. They don't exist anymore.
+ */
+static void
+remove_stale_snapshot_lists (GtdManager  *self,
+                             const gchar *provider_id)
+{
+  GtdManagerPrivate *priv = gtd_manager_get_instance_private (self);
+  g_autofree gchar *prefix = NULL;
+  g_autoptr (GList) keys = NULL;
+  GList *k;
+
+  if (g_hash_table_size (priv->snapshot_lists) == 0)
+    return;
+
+  /* Several providers can share an id, e.g. one per online account */
+  if (!providers_lists_loaded (self, provider_id))
+    return;
+
+  prefix = provider_id ? g_strconcat (provider_id, ":", NULL) : NULL;
+  keys = g_hash_table_get_keys (priv->snapshot_lists);
+
+  for (k = keys; k != NULL; k = k->next)
+    {
+      GtdTaskList *snapshot_list = g_hash_table_lookup (priv->snapshot_lists, k->data);
+
+      if (prefix && !g_str_has_prefix (k->data, prefix))
+        continue;
+
+      if (!g_object_get_data (G_OBJECT (snapshot_list), "gtd-pending-list"))
+        remove_snapshot_list (self, k->data);
+    }
+}
+
+static void
+load_snapshot (GtdManager *self)
+{
+  GtdManagerPrivate *priv = gtd_manager_get_instance_private (self);
+  g_autoptr (GError) error = NULL;
+  GList *lists;
+  GList *l;
+  gint64 start;
+
+  start = g_get_monotonic_time ();
+  lists = gtd_snapshot_load (&error);
+
+  if (error)
+    {
+      if (!g_error_matches (error, G_FILE_ERROR, G_FILE_ERROR_NOENT))
+        g_warning ("Error loading snapshot: %s", error->message);
+
+      return;
+    }
+
+  for (l = lists; l != NULL; l = l->next)
+    {
+      g_hash_table_insert (priv->snapshot_lists, gtd_snapshot_get_list_key (l->data), l->data);
+
+      priv->tasklists = g_list_append (priv->tasklists, l->data);
+
+      g_signal_emit (self, signals[LIST_ADDED], 0, l->data);
+    }
+
+  g_debug ("Loaded %u lists from the snapshot in %.3lfms",
+           g_list_length (lists),
+           (g_get_monotonic_time () - start) / 1000.0);
+
+  /* The hash table owns the lists */
+  g_list_free (lists);
+}
+
+/*
+ * Task operations are sent to the providers asynchronously. Each provider
+ * runs at most MAX_OPERATIONS_PER_PROVIDER of them at once, and the rest
+ * wait in a queue. Operations on the same task never overlap, so they
+ * reach the provider in the order they were requested.
+ */
+static void          dispatch_task_operations                    (GtdManager         *self,
+                                                                  GtdProvider        *provider);
+
+static gboolean
+task_operation_touches (TaskOperation *operation,
+                        GHashTable    *tasks)
+{
+  guint i;
+
+  if (operation->task)
+    return g_hash_table_contains (tasks, operation->task);
+
+  for (i = 0; i < operation->tasks->len; i++)
+    {
+      if (g_hash_table_contains (tasks, g_ptr_array_index (operation->tasks, i)))
+        return TRUE;
+    }
+
+  return FALSE;
+}
+
+static void
+task_operation_set_busy (ProviderOperations *operations,
+                         TaskOperation      *operation,
+                         gboolean            busy)
+{
+  guint i;
+
+  if (operation->task)
+    {
+      if (busy)
+        g_hash_table_add (operations->busy_tasks, operation->task);
+      else
+        g_hash_table_remove (operations->busy_tasks, operation->task);
+
+      return;
+    }
+
+  for (i = 0; i < operation->tasks->len; i++)
+    {
+      if (busy)
+        g_hash_table_add (operations->busy_tasks, g_ptr_array_index (operation->tasks, i));
+      else
+        g_hash_table_remove (operations->busy_tasks, g_ptr_array_index (operation->tasks, i));
+    }
+}
+
+static void
+drop_idle_provider_operations (GtdManager  *self,
+                               GtdProvider *provider)
+{
+  ProviderOperations *operations;
+
+  operations = g_hash_table_lookup (self->priv->operations, provider);
+
+  if (operations && operations->n_running == 0 && g_queue_is_empty (operations->queue))
+    g_hash_table_remove (self->priv->operations, provider);
+}
+
+static void
+task_operation_finished_cb (GObject      *source,
+                            GAsyncResult *result,
+                            gpointer      user_data)
+{
+  ProviderOperations *operations;
+  TaskOperation *operation;
+  GtdProvider *provider;
+  GtdManager *self;
+  GError *error;
+
+  operation = user_data;
+  provider = GTD_PROVIDER (source);
+  self = operation->manager;
+  error = NULL;
+
+  switch (operation->type)
+    {
+    case TASK_OPERATION_CREATE:
+      gtd_provider_create_task_finish (provider, result, &error);
+      break;
+
+    case TASK_OPERATION_UPDATE:
+      gtd_provider_update_task_finish (provider, result, &error);
+      break;
+
+    case TASK_OPERATION_REMOVE:
+      gtd_provider_remove_task_finish (provider, result, &error);
+      break;
+
+    case TASK_OPERATION_REMOVE_MANY:
+      gtd_provider_remove_tasks_finish (provider, result, &error);
+      break;
+    }
+
+  /* Providers notify the user about their own errors */
+  if (error)
+    {
+      g_debug ("%s: task operation on '%s' failed: %s",
+               G_STRFUNC,
+               gtd_provider_get_id (provider),
+               error->message);
+
+      g_clear_error (&error);
+    }
+
+  operations = g_hash_table_lookup (self->priv->operations, provider);
+
+  g_assert (operations != NULL);
+
+  operations->running = g_list_remove (operations->running, operation);
+  operations->n_running--;
+
+  task_operation_set_busy (operations, operation, FALSE);
+
+  task_operation_free (operation);
+
+  dispatch_task_operations (self, provider);
+}
+
+static void
+run_task_operation (ProviderOperations *operations,
+                    TaskOperation      *operation)
+{
+  task_operation_set_busy (operations, operation, TRUE);
+  operations->running = g_list_prepend (operations->running, operation);
+  operations->n_running++;
+
+  switch (operation->type)
+    {
+    case TASK_OPERATION_CREATE:
+      gtd_provider_create_task_async (operation->provider,
+                                      operation->task,
+                                      operation->cancellable,
+                                      task_operation_finished_cb,
+                                      operation);
+      break;
+
+    case TASK_OPERATION_UPDATE:
+      gtd_provider_update_task_async (operation->provider,
+                                      operation->task,
+                                      operation->cancellable,
+                                      task_operation_finished_cb,
+                                      operation);
+      break;
+
+    case TASK_OPERATION_REMOVE:
+      gtd_provider_remove_task_async (operation->provider,
+                                      operation->task,
+                                      operation->cancellable,
+                                      task_operation_finished_cb,
+                                      operation);
+      break;
+
+    case TASK_OPERATION_REMOVE_MANY:
+      gtd_provider_remove_tasks_async (operation->provider,
+                                       operation->tasks,
+                                       operation->cancellable,
+                                       task_operation_finished_cb,
+                                       operation);
+      break;
+    }
+}
+
+static void
+dispatch_task_operations (GtdManager  *self,
+                          GtdProvider *provider)
+{
+  ProviderOperations *operations;
+  GHashTable *blocked_tasks;
+  GList *l;
+
+  operations = g_hash_table_lookup (self->priv->operations, provider);
+
+  if (!operations)
+    return;
+
+  /* Tasks of waiting batches, which later operations must not overtake */
+  blocked_tasks = NULL;
+  l = operations->queue->head;
+
+  while (l && operations->n_running < MAX_OPERATIONS_PER_PROVIDER)
+    {
+      TaskOperation *operation;
+      GList *next;
+
+      operation = l->data;
+      next = l->next;
+
+      /* Wait until the running operation on this task finishes */
+      if (!task_operation_touches (operation, operations->busy_tasks) &&
+          (!blocked_tasks || !task_operation_touches (operation, blocked_tasks)))
+        {
+          g_queue_delete_link (operations->queue, l);
+
+          if (operation->type == TASK_OPERATION_UPDATE)
+            g_hash_table_remove (operations->queued_updates, operation->task);
+
+          run_task_operation (operations, operation);
+        }
+      else if (operation->tasks)
+        {
+          guint i;
+
+          if (!blocked_tasks)
+            blocked_tasks = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+          for (i = 0; i < operation->tasks->len; i++)
+            g_hash_table_add (blocked_tasks, g_ptr_array_index (operation->tasks, i));
+        }
+
+      l = next;
+    }
+
+  g_clear_pointer (&blocked_tasks, g_hash_table_destroy);
+
+  drop_idle_provider_operations (self, provider);
+}
+
+static ProviderOperations*
+ensure_provider_operations (GtdManager  *self,
+                            GtdProvider *provider)
+{
+  ProviderOperations *operations;
+
+  operations = g_hash_table_lookup (self->priv->operations, provider);
+
+  if (!operations)
+    {
+      operations = provider_operations_new ();
+      g_hash_table_insert (self->priv->operations, provider, operations);
+    }
+
+  return operations;
+}
+
+static void
+drop_queued_update (ProviderOperations *operations,
+                    GtdTask            *task)
+{
+  TaskOperation *operation;
+
+  operation = g_hash_table_lookup (operations->queued_updates, task);
+
+  if (!operation)
+    return;
+
+  g_queue_remove (operations->queue, operation);
+  g_hash_table_remove (operations->queued_updates, task);
+  task_operation_free (operation);
+}
+
+static void
+queue_task_operation (GtdManager        *self,
+                      TaskOperationType  type,
+                      GtdTask           *task)
+{
+  ProviderOperations *operations;
+  TaskOperation *operation;
+  GtdTaskList *list;
+  GtdProvider *provider;
+
+  list = gtd_task_get_list (task);
+
+  /* Task does not have parent list, nothing we can do */
+  if (!list)
+    return;
+
+  provider = gtd_task_list_get_provider (list);
+  operations = ensure_provider_operations (self, provider);
+
+  operation = g_hash_table_lookup (operations->queued_updates, task);
+
+  /* A queued update sends the state of the task at the time it runs */
+  if (type == TASK_OPERATION_UPDATE && operation)
+    return;
+
+  /* ... and there's no point in sending it if the task is being removed */
+  if (type == TASK_OPERATION_REMOVE)
+    drop_queued_update (operations, task);
+
+  operation = task_operation_new (self, type, provider, task);
+
+  g_queue_push_tail (operations->queue, operation);
+
+  if (type == TASK_OPERATION_UPDATE)
+    g_hash_table_insert (operations->queued_updates, task, operation);
+
+  dispatch_task_operations (self, provider);
+}
+
+/* All the @tasks belong to @provider */
+static void
+queue_remove_tasks_operation (GtdManager  *self,
+                              GtdProvider *provider,
+                              GPtrArray   *tasks)
+{
+  ProviderOperations *operations;
+  guint i;
+
+  operations = ensure_provider_operations (self, provider);
+
+  for (i = 0; i < tasks->len; i++)
+    drop_queued_update (operations, g_ptr_array_index (tasks, i));
+
+  g_queue_push_tail (operations->queue,
+                     task_operation_new_batch (self, TASK_OPERATION_REMOVE_MANY, provider, tasks));
+
+  dispatch_task_operations (self, provider);
+}
+
+static void
+cancel_task_operations (GtdManager  *self,
+                        GtdProvider *provider)
+{
+  ProviderOperations *operations;
+  GList *l;
+
+  operations = g_hash_table_lookup (self->priv->operations, provider);
+
+  if (!operations)
+    return;
+
+  g_debug ("Cancelling %u running and %u queued task operations of '%s'",
+           operations->n_running,
+           g_queue_get_length (operations->queue),
+           gtd_provider_get_id (provider));
+
+  /* Running operations are dropped when they finish */
+  for (l = operations->running; l != NULL; l = l->next)
+    {
+      TaskOperation *operation = l->data;
+
+      g_cancellable_cancel (operation->cancellable);
+    }
+
+  g_queue_foreach (operations->queue, (GFunc) task_operation_free, NULL);
+  g_queue_clear (operations->queue);
+  g_hash_table_remove_all (operations->queued_updates);
+
+  drop_idle_provider_operations (self, provider);
+}
+
 static void
 gtd_manager__task_list_modified (GtdTaskList *list,
                                  GtdTask     *task,
                                  GtdManager  *self)
 {
   g_signal_emit (self, signals[LIST_CHANGED], 0, list);
+
+  queue_save_snapshot (self);
 }
 
 static void
@@ -459,12 +1084,53 @@ gtd_manager__panel_removed (GtdPluginManager *plugin_manager,
   g_signal_emit (self, signals[PANEL_REMOVED], 0, panel);
 }
 
+static void
+gtd_manager__list_added (GtdProvider *provider,
+                         GtdTaskList *list,
+                         GtdManager  *self);
+
+static void
+gtd_manager__list_ready_changed (GtdTaskList *list,
+                                 GParamSpec  *pspec,
+                                 GtdManager  *self)
+{
+  if (!gtd_object_get_ready (GTD_OBJECT (list)))
+    return;
+
+  g_signal_handlers_disconnect_by_func (list, gtd_manager__list_ready_changed, self);
+
+  gtd_manager__list_added (gtd_task_list_get_provider (list), list, self);
+}
+
 static void
 gtd_manager__list_added (GtdProvider *provider,
                          GtdTaskList *list,
                          GtdManager  *self)
 {
   GtdManagerPrivate *priv = gtd_manager_get_instance_private (self);
+  g_autofree gchar *key = NULL;
+
+  /*
+   * If this list was loaded from the snapshot, keep showing the snapshot
+   * until the real list finishes loading, and then replace it.
+   */
+  key = gtd_snapshot_get_list_key (list);
+
+  if (g_hash_table_contains (priv->snapshot_lists, key))
+    {
+      if (!gtd_object_get_ready (GTD_OBJECT (list)))
+        {
+          g_object_set_data (g_hash_table_lookup (priv->snapshot_lists, key), "gtd-pending-list", list);
+
+          g_signal_connect (list,
+                            "notify::ready",
+                            G_CALLBACK (gtd_manager__list_ready_changed),
+                            self);
+          return;
+        }
+
+      remove_snapshot_list (self, key);
+    }
 
   priv->tasklists = g_list_append (priv->tasklists, list);
 
@@ -484,6 +1150,8 @@ gtd_manager__list_added (GtdProvider *provider,
                     self);
 
   g_signal_emit (self, signals[LIST_ADDED], 0, list);
+
+  queue_save_snapshot (self);
 }
 
 static void
@@ -492,6 +1160,8 @@ gtd_manager__list_changed (GtdProvider *provider,
                            GtdManager  *self)
 {
   g_signal_emit (self, signals[LIST_CHANGED], 0, list);
+
+  queue_save_snapshot (self);
 }
 
 static void
@@ -504,6 +1174,22 @@ gtd_manager__list_removed (GtdProvider *provider,
   if (!list)
       return;
 
+  g_signal_handlers_disconnect_by_func (list,
+                                        gtd_manager__list_ready_changed,
+                                        self);
+
+  /* The list might still be waiting to replace its snapshot */
+  if (!g_list_find (priv->tasklists, list))
+    {
+      g_autofree gchar *key = gtd_snapshot_get_list_key (list);
+      GtdTaskList *snapshot_list = g_hash_table_lookup (priv->snapshot_lists, key);
+
+      if (snapshot_list && g_object_get_data (G_OBJECT (snapshot_list), "gtd-pending-list") == list)
+        remove_snapshot_list (self, key);
+
+      return;
+    }
+
   priv->tasklists = g_list_remove (priv->tasklists, list);
 
   g_signal_handlers_disconnect_by_func (list,
@@ -511,6 +1197,43 @@ gtd_manager__list_removed (GtdProvider *provider,
                                         self);
 
   g_signal_emit (self, signals[LIST_REMOVED], 0, list);
+
+  queue_save_snapshot (self);
+}
+
+/*
+ * The manager is ready when every plugin is loaded, and every provider
+ * added the lists it had at startup, with their tasks. Lists and tasks
+ * are added as each provider loads them, so the UI is usable before that.
+ */
+static void
+update_ready (GtdManager *self)
+{
+  GtdManagerPrivate *priv = gtd_manager_get_instance_private (self);
+  gboolean ready;
+
+  ready = gtd_object_get_ready (GTD_OBJECT (priv->plugin_manager)) &&
+          providers_lists_loaded (self, NULL);
+
+  gtd_object_set_ready (GTD_OBJECT (self), ready);
+
+  if (!ready)
+    return;
+
+  /* Lists of providers that are gone since the last session */
+  remove_stale_snapshot_lists (self, NULL);
+
+  queue_save_snapshot (self);
+}
+
+static void
+gtd_manager__provider_lists_loaded (GtdProvider *provider,
+                                    GtdManager  *self)
+{
+  g_debug ("Provider '%s' finished loading", gtd_provider_get_id (provider));
+
+  remove_stale_snapshot_lists (self, gtd_provider_get_id (provider));
+  update_ready (self);
 }
 
 static void
@@ -545,6 +1268,16 @@ gtd_manager__provider_added (GtdPluginManager *plugin_manager,
                     G_CALLBACK (gtd_manager__list_removed),
                     self);
 
+  g_signal_connect (provider,
+                    "lists-loaded",
+                    G_CALLBACK (gtd_manager__provider_lists_loaded),
+                    self);
+
+  if (gtd_provider_get_lists_loaded (provider))
+    remove_stale_snapshot_lists (self, gtd_provider_get_id (provider));
+
+  update_ready (self);
+
   /* If we just added the default provider, update the property */
   check_provider_is_default (self, provider);
 
@@ -562,6 +1295,8 @@ gtd_manager__provider_removed (GtdPluginManager *plugin_manager,
 
   priv->providers = g_list_remove (priv->providers, provider);
 
+  cancel_task_operations (self, provider);
+
   /* Remove lists */
   lists = gtd_provider_get_task_lists (provider);
 
@@ -586,6 +1321,12 @@ gtd_manager__provider_removed (GtdPluginManager *plugin_manager,
                                         gtd_manager__list_removed,
                                         self);
 
+  g_signal_handlers_disconnect_by_func (provider,
+                                        gtd_manager__provider_lists_loaded,
+                                        self);
+
+  update_ready (self);
+
   g_signal_emit (self, signals[PROVIDER_REMOVED], 0, provider);
 }
 
@@ -596,6 +1337,16 @@ gtd_manager_init (GtdManager *self)
   self->priv->settings = g_settings_new ("org.gnome.todo");
   self->priv->plugin_manager = gtd_plugin_manager_new ();
   self->priv->timer = gtd_timer_new ();
+  self->priv->snapshot_lists = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_object_unref);
+  self->priv->operations = g_hash_table_new_full (g_direct_hash,
+                                                  g_direct_equal,
+                                                  NULL,
+                                                  (GDestroyNotify) provider_operations_free);
+
+  g_signal_connect_swapped (self->priv->plugin_manager,
+                            "notify::ready",
+                            G_CALLBACK (update_ready),
+                            self);
 }
 
 /**
@@ -626,22 +1377,17 @@ gtd_manager_new (void)
  * @manager: a #GtdManager
  * @task: a #GtdTask
  *
- * Ask for @task's parent list source to create @task.
+ * Ask for @task's parent list source to create @task. The operation
+ * is queued and sent to the provider asynchronously.
  */
 void
 gtd_manager_create_task (GtdManager *manager,
                          GtdTask    *task)
 {
-  GtdTaskList *list;
-  GtdProvider *provider;
-
   g_return_if_fail (GTD_IS_MANAGER (manager));
   g_return_if_fail (GTD_IS_TASK (task));
 
-  list = gtd_task_get_list (task);
-  provider = gtd_task_list_get_provider (list);
-
-  gtd_provider_create_task (provider, task);
+  queue_task_operation (manager, TASK_OPERATION_CREATE, task);
 }
 
 /**
@@ -649,22 +1395,77 @@ gtd_manager_create_task (GtdManager *manager,
  * @manager: a #GtdManager
  * @task: a #GtdTask
  *
- * Ask for @task's parent list source to remove @task.
+ * Ask for @task's parent list source to remove @task. The operation
+ * is queued and sent to the provider asynchronously.
  */
 void
 gtd_manager_remove_task (GtdManager *manager,
                          GtdTask    *task)
 {
-  GtdTaskList *list;
-  GtdProvider *provider;
-
   g_return_if_fail (GTD_IS_MANAGER (manager));
   g_return_if_fail (GTD_IS_TASK (task));
 
-  list = gtd_task_get_list (task);
-  provider = gtd_task_list_get_provider (list);
+  queue_task_operation (manager, TASK_OPERATION_REMOVE, task);
+}
+
+/**
+ * gtd_manager_remove_tasks:
+ * @manager: a #GtdManager
+ * @tasks: (element-type Gtd.Task): the tasks to remove
+ *
+ * Removes all the @tasks at once. The tasks are grouped by provider,
+ * and each provider receives a single operation removing all of its
+ * tasks, instead of one operation per task.
+ */
+void
+gtd_manager_remove_tasks (GtdManager *manager,
+                          GPtrArray  *tasks)
+{
+  g_autoptr (GHashTable) batches = NULL;
+  GHashTableIter iter;
+  gpointer provider, batch;
+  guint i;
+
+  g_return_if_fail (GTD_IS_MANAGER (manager));
+  g_return_if_fail (tasks != NULL);
+
+  /* GtdProvider → GPtrArray of its tasks */
+  batches = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, (GDestroyNotify) g_ptr_array_unref);
+
+  for (i = 0; i < tasks->len; i++)
+    {
+      GtdTask *task;
+      GtdTaskList *list;
+
+      task = g_ptr_array_index (tasks, i);
+      list = gtd_task_get_list (task);
+
+      /* Task does not have parent list, nothing we can do */
+      if (!list)
+        continue;
 
-  gtd_provider_remove_task (provider, task);
+      provider = gtd_task_list_get_provider (list);
+      batch = g_hash_table_lookup (batches, provider);
+
+      if (!batch)
+        {
+          batch = g_ptr_array_new_with_free_func (g_object_unref);
+          g_hash_table_insert (batches, provider, batch);
+        }
+
+      g_ptr_array_add (batch, g_object_ref (task));
+    }
+
+  g_hash_table_iter_init (&iter, batches);
+
+  while (g_hash_table_iter_next (&iter, &provider, &batch))
+    {
+      g_debug ("Removing %u tasks from '%s'",
+               ((GPtrArray*) batch)->len,
+               gtd_provider_get_id (provider));
+
+      queue_remove_tasks_operation (manager, provider, batch);
+    }
 }
 
 /**
@@ -672,27 +1473,17 @@ gtd_manager_remove_task (GtdManager *manager,
  * @manager: a #GtdManager
  * @task: a #GtdTask
  *
- * Ask for @task's parent list source to update @task.
+ * Ask for @task's parent list source to update @task. The operation
+ * is queued and sent to the provider asynchronously.
  */
 void
 gtd_manager_update_task (GtdManager *manager,
                          GtdTask    *task)
 {
-  GtdTaskList *list;
-  GtdProvider *provider;
-
   g_return_if_fail (GTD_IS_MANAGER (manager));
   g_return_if_fail (GTD_IS_TASK (task));
 
-  list = gtd_task_get_list (task);
-
-  /* Task does not have parent list, nothing we can do */
-  if (!list)
-      return;
-
-  provider = gtd_task_list_get_provider (list);
-
-  gtd_provider_update_task (provider, task);
+  queue_task_operation (manager, TASK_OPERATION_UPDATE, task);
 }
 
 /**
@@ -1018,6 +1809,9 @@ gtd_manager_load_plugins (GtdManager *manager)
 {
   GtdManagerPrivate *priv = gtd_manager_get_instance_private (manager);
 
+  /* Show the lists from the last session while the providers load */
+  load_snapshot (manager);
+
   g_signal_connect (priv->plugin_manager,
                     "panel-registered",
                     G_CALLBACK (gtd_manager__panel_added),
@@ -62,6 +62,9 @@ void                    gtd_manager_create_task           (GtdManager
 void                    gtd_manager_remove_task           (GtdManager                *manager,
                                                            GtdTask                   *task);
 
+void                    gtd_manager_remove_tasks          (GtdManager                *manager,
+                                                           GPtrArray                 *tasks);
+
 void                    gtd_manager_update_task           (GtdManager                *manager,
                                                            GtdTask                   *task);
 
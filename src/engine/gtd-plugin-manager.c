@@ -24,11 +24,31 @@
 
 #include <libpeas/peas.h>
 
+/*
+ * Plugins are loaded and activated from a low priority idle, one at a time,
+ * so that the window gets drawn before any of them. Panel plugins build
+ * their panels on activation. The time spent on each plugin is recorded so
+ * it can be shown in the plugin dialog.
+ */
+typedef struct
+{
+  gint64              load_start;
+  gint64              load_time;
+  gint64              activation_time;
+  gboolean            activated;
+} PluginTiming;
+
 struct _GtdPluginManager
 {
   GtdObject           parent;
 
   GHashTable         *info_to_extension;
+
+  /* PeasPluginInfo → PluginTiming */
+  GHashTable         *timings;
+
+  GQueue             *pending_plugins;
+  guint               load_plugins_id;
 };
 
 G_DEFINE_TYPE (GtdPluginManager, gtd_plugin_manager, GTD_TYPE_OBJECT)
@@ -43,6 +63,7 @@ enum
 {
   PANEL_REGISTERED,
   PANEL_UNREGISTERED,
+  PLUGIN_ACTIVATED,
   PLUGIN_LOADED,
   PLUGIN_UNLOADED,
   PROVIDER_REGISTERED,
@@ -57,7 +78,15 @@ gtd_plugin_manager_finalize (GObject *object)
 {
   GtdPluginManager *self = (GtdPluginManager *)object;
 
+  if (self->load_plugins_id > 0)
+    {
+      g_source_remove (self->load_plugins_id);
+      self->load_plugins_id = 0;
+    }
+
+  g_clear_pointer (&self->pending_plugins, g_queue_free);
   g_clear_pointer (&self->info_to_extension, g_hash_table_destroy);
+  g_clear_pointer (&self->timings, g_hash_table_destroy);
 
   G_OBJECT_CLASS (gtd_plugin_manager_parent_class)->finalize (object);
 }
@@ -91,6 +120,18 @@ gtd_plugin_manager_class_init (GtdPluginManagerClass *klass)
                                               1,
                                               GTD_TYPE_PANEL);
 
+  signals[PLUGIN_ACTIVATED] = g_signal_new ("plugin-activated",
+                                            GTD_TYPE_PLUGIN_MANAGER,
+                                            G_SIGNAL_RUN_FIRST,
+                                            0,
+                                            NULL,
+                                            NULL,
+                                            NULL,
+                                            G_TYPE_NONE,
+                                            2,
+                                            PEAS_TYPE_PLUGIN_INFO,
+                                            GTD_TYPE_ACTIVATABLE);
+
   signals[PLUGIN_LOADED] = g_signal_new ("plugin-loaded",
                                          GTD_TYPE_PLUGIN_MANAGER,
                                          G_SIGNAL_RUN_FIRST,
@@ -170,6 +211,51 @@ on_provider_removed (GtdActivatable   *activatable,
   g_signal_emit_by_name (self, "provider-unregistered", provider);
 }
 
+static PluginTiming*
+get_timing (GtdPluginManager *self,
+            PeasPluginInfo   *info)
+{
+  PluginTiming *timing;
+
+  timing = g_hash_table_lookup (self->timings, info);
+
+  if (!timing)
+    {
+      timing = g_new0 (PluginTiming, 1);
+      g_hash_table_insert (self->timings, info, timing);
+    }
+
+  return timing;
+}
+
+static void
+activate_plugin (GtdPluginManager *self,
+                 PeasPluginInfo   *info,
+                 GtdActivatable   *activatable)
+{
+  PluginTiming *timing;
+  gint64 start;
+
+  timing = get_timing (self, info);
+
+  if (timing->activated)
+    return;
+
+  start = g_get_monotonic_time ();
+
+  gtd_activatable_activate (activatable);
+
+  timing->activated = TRUE;
+  timing->activation_time = g_get_monotonic_time () - start;
+
+  g_debug ("Plugin '%s' activated in %.3lfms (loaded in %.3lfms)",
+           peas_plugin_info_get_module_name (info),
+           timing->activation_time / 1000.0,
+           timing->load_time / 1000.0);
+
+  g_signal_emit (self, signals[PLUGIN_ACTIVATED], 0, info, activatable);
+}
+
 static void
 on_plugin_unloaded (PeasEngine       *engine,
                     PeasPluginInfo   *info,
@@ -197,8 +283,11 @@ on_plugin_unloaded (PeasEngine       *engine,
   for (l = extension_providers; l != NULL; l = l->next)
     on_provider_removed (activatable, l->data, self);
 
-  /* Deactivates the extension */
-  gtd_activatable_deactivate (activatable);
+  /* Deactivates the extension, if it was ever activated */
+  if (get_timing (self, info)->activated)
+    gtd_activatable_deactivate (activatable);
+
+  g_hash_table_remove (self->timings, info);
 
   /* Emit the signal */
   g_signal_emit (self, signals[PLUGIN_UNLOADED], 0, info, activatable);
@@ -226,6 +315,14 @@ on_plugin_unloaded (PeasEngine       *engine,
   g_clear_object (&activatable);
 }
 
+static void
+on_plugin_load_started (PeasEngine       *engine,
+                        PeasPluginInfo   *info,
+                        GtdPluginManager *self)
+{
+  get_timing (self, info)->load_start = g_get_monotonic_time ();
+}
+
 static void
 on_plugin_loaded (PeasEngine       *engine,
                   PeasPluginInfo   *info,
@@ -235,6 +332,7 @@ on_plugin_loaded (PeasEngine       *engine,
     {
       GtdActivatable *activatable;
       PeasExtension *extension;
+      PluginTiming *timing;
       const GList *l;
 
       /*
@@ -281,11 +379,13 @@ on_plugin_loaded (PeasEngine       *engine,
                         G_CALLBACK (on_panel_removed),
                         self);
 
-      /* Activate extension */
-      gtd_activatable_activate (activatable);
+      timing = get_timing (self, info);
+      timing->load_time = g_get_monotonic_time () - timing->load_start;
 
       /* Emit the signal */
       g_signal_emit (self, signals[PLUGIN_LOADED], 0, info, extension);
+
+      activate_plugin (self, info, activatable);
     }
 }
 
@@ -329,6 +429,11 @@ setup_engine (GtdPluginManager *self)
   g_free (plugin_dir);
 
   /* Hear about loaded plugins */
+  g_signal_connect (engine,
+                    "load-plugin",
+                    G_CALLBACK (on_plugin_load_started),
+                    self);
+
   g_signal_connect_after (engine,
                           "load-plugin",
                           G_CALLBACK (on_plugin_loaded),
@@ -344,6 +449,8 @@ static void
 gtd_plugin_manager_init (GtdPluginManager *self)
 {
   self->info_to_extension = g_hash_table_new (g_direct_hash, g_direct_equal);
+  self->timings = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, g_free);
+  self->pending_plugins = g_queue_new ();
 
   gtd_object_set_ready (GTD_OBJECT (self), FALSE);
 
@@ -358,20 +465,82 @@ gtd_plugin_manager_new (void)
   return g_object_new (GTD_TYPE_PLUGIN_MANAGER, NULL);
 }
 
+static gboolean
+load_next_plugin_cb (gpointer user_data)
+{
+  GtdPluginManager *self;
+  PeasPluginInfo *info;
+  PeasEngine *engine;
+  GSettings *settings;
+
+  self = GTD_PLUGIN_MANAGER (user_data);
+  engine = peas_engine_get_default ();
+  info = g_queue_pop_head (self->pending_plugins);
+
+  if (info)
+    peas_engine_load_plugin (engine, info);
+
+  if (!g_queue_is_empty (self->pending_plugins))
+    return G_SOURCE_CONTINUE;
+
+  /* Every plugin is loaded, now keep the settings in sync */
+  settings = gtd_manager_get_settings (gtd_manager_get_default ());
+
+  g_settings_bind (settings,
+                   "active-extensions",
+                   engine,
+                   "loaded-plugins",
+                   G_SETTINGS_BIND_DEFAULT);
+
+  self->load_plugins_id = 0;
+
+  gtd_object_set_ready (GTD_OBJECT (self), TRUE);
+
+  return G_SOURCE_REMOVE;
+}
+
+/**
+ * gtd_plugin_manager_load_plugins:
+ * @self: a #GtdPluginManager
+ *
+ * Queues the builtin and the enabled plugins for loading. They are
+ * loaded one per main loop iteration, with low priority, so that the
+ * window can be drawn before any plugin is loaded.
+ */
 void
 gtd_plugin_manager_load_plugins (GtdPluginManager *self)
 {
+  g_auto (GStrv) active_extensions = NULL;
   PeasEngine *engine;
   GSettings *settings;
+  const GList *l;
+
+  g_return_if_fail (GTD_IS_PLUGIN_MANAGER (self));
+
+  if (self->load_plugins_id > 0)
+    return;
 
   engine = peas_engine_get_default ();
   settings = gtd_manager_get_settings (gtd_manager_get_default ());
+  active_extensions = g_settings_get_strv (settings, "active-extensions");
 
-  g_settings_bind (settings,
-		   "active-extensions",
-		   engine,
-		   "loaded-plugins",
-		   G_SETTINGS_BIND_DEFAULT);
+  for (l = peas_engine_get_plugin_list (engine); l != NULL; l = l->next)
+    {
+      PeasPluginInfo *info = l->data;
+
+      if (peas_plugin_info_is_builtin (info) ||
+          g_strv_contains ((const gchar * const *) active_extensions, peas_plugin_info_get_module_name (info)))
+        {
+          g_queue_push_tail (self->pending_plugins, info);
+        }
+    }
+
+  gtd_object_set_ready (GTD_OBJECT (self), FALSE);
+
+  self->load_plugins_id = g_idle_add_full (G_PRIORITY_LOW,
+                                           load_next_plugin_cb,
+                                           self,
+                                           NULL);
 }
 
 GtdActivatable*
@@ -390,3 +559,30 @@ gtd_plugin_manager_get_loaded_plugins (GtdPluginManager *self)
 
   return g_hash_table_get_values (self->info_to_extension);
 }
+
+/**
+ * gtd_plugin_manager_get_activation_time:
+ * @self: a #GtdPluginManager
+ * @info: a #PeasPluginInfo
+ *
+ * Retrieves the time, in microseconds, spent loading and activating the
+ * plugin described by @info.
+ *
+ * Returns: the activation time of the plugin, or -1 if it is not
+ * activated.
+ */
+gint64
+gtd_plugin_manager_get_activation_time (GtdPluginManager *self,
+                                        PeasPluginInfo   *info)
+{
+  PluginTiming *timing;
+
+  g_return_val_if_fail (GTD_IS_PLUGIN_MANAGER (self), -1);
+
+  timing = g_hash_table_lookup (self->timings, info);
+
+  if (!timing || !timing->activated)
+    return -1;
+
+  return timing->load_time + timing->activation_time;
+}
@@ -40,6 +40,9 @@ GtdActivatable*      gtd_plugin_manager_get_plugin               (GtdPluginManag
 
 GList*               gtd_plugin_manager_get_loaded_plugins       (GtdPluginManager   *self);
 
+gint64               gtd_plugin_manager_get_activation_time      (GtdPluginManager   *self,
+                                                                  PeasPluginInfo     *info);
+
 G_END_DECLS
 
 #endif /* GTD_PLUGIN_MANAGER_H */
@@ -0,0 +1,694 @@
+/* gtd-snapshot.c
+ *
+ * Copyright (C) 2017 Georges Basile Stavracas Neto <georges.stavracas@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define G_LOG_DOMAIN "Snapshot"
+
+#include "interfaces/gtd-provider.h"
+#include "gtd-manager.h"
+#include "gtd-snapshot.h"
+#include "gtd-task.h"
+#include "gtd-task-list.h"
+
+#include <errno.h>
+#include <glib/gi18n.h>
+#include <glib/gstdio.h>
+
+/*
+ * The snapshot is a serialized GVariant with every list and task known
+ * when it was written, grouped by provider. GVariant's serialized form
+ * can be used directly from a mapped file, so loading the snapshot only
+ * costs creating the objects.
+ *
+ * Lists loaded from the snapshot belong to a GtdSnapshotProvider, which
+ * mimics the real provider until it finishes loading and the manager
+ * swaps the lists. Changes to these lists are refused.
+ *
+ * Bump SNAPSHOT_VERSION whenever the format changes. Snapshots with a
+ * different version are ignored.
+ */
+
+#define SNAPSHOT_VERSION 1
+
+#define TASK_FORMAT      "(ssssbix)"
+#define LIST_FORMAT      "(ss(dddd)ba" TASK_FORMAT ")"
+#define PROVIDER_FORMAT  "(ssssa" LIST_FORMAT ")"
+#define SNAPSHOT_FORMAT  "(ua" PROVIDER_FORMAT ")"
+
+
+/*
+ * GtdSnapshotProvider
+ */
+
+#define GTD_TYPE_SNAPSHOT_PROVIDER (gtd_snapshot_provider_get_type())
+
+G_DECLARE_FINAL_TYPE (GtdSnapshotProvider, gtd_snapshot_provider, GTD, SNAPSHOT_PROVIDER, GtdObject)
+
+struct _GtdSnapshotProvider
+{
+  GtdObject           parent;
+
+  gchar              *id;
+  gchar              *name;
+  gchar              *description;
+  GIcon              *icon;
+
+  GList              *lists;
+};
+
+static void          gtd_provider_iface_init                     (GtdProviderInterface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (GtdSnapshotProvider, gtd_snapshot_provider, GTD_TYPE_OBJECT,
+                         G_IMPLEMENT_INTERFACE (GTD_TYPE_PROVIDER,
+                                                gtd_provider_iface_init))
+
+enum {
+  PROP_0,
+  PROP_DEFAULT_TASKLIST,
+  PROP_DESCRIPTION,
+  PROP_ENABLED,
+  PROP_ICON,
+  PROP_ID,
+  PROP_NAME,
+  LAST_PROP
+};
+
+static void
+refuse_change (GtdSnapshotProvider *self)
+{
+  gtd_manager_emit_error_message (gtd_manager_get_default (),
+                                  _("Changes can't be saved yet"),
+                                  _("Please wait until your tasks finish loading"),
+                                  NULL,
+                                  NULL);
+}
+
+static const gchar*
+gtd_snapshot_provider_get_id (GtdProvider *provider)
+{
+  return GTD_SNAPSHOT_PROVIDER (provider)->id;
+}
+
+static const gchar*
+gtd_snapshot_provider_get_name (GtdProvider *provider)
+{
+  return GTD_SNAPSHOT_PROVIDER (provider)->name;
+}
+
+static const gchar*
+gtd_snapshot_provider_get_description (GtdProvider *provider)
+{
+  return GTD_SNAPSHOT_PROVIDER (provider)->description;
+}
+
+static gboolean
+gtd_snapshot_provider_get_enabled (GtdProvider *provider)
+{
+  return TRUE;
+}
+
+static GIcon*
+gtd_snapshot_provider_get_icon (GtdProvider *provider)
+{
+  return GTD_SNAPSHOT_PROVIDER (provider)->icon;
+}
+
+static const GtkWidget*
+gtd_snapshot_provider_get_edit_panel (GtdProvider *provider)
+{
+  return NULL;
+}
+
+static void
+gtd_snapshot_provider_refuse_task (GtdProvider *provider,
+                                   GtdTask     *task)
+{
+  refuse_change (GTD_SNAPSHOT_PROVIDER (provider));
+}
+
+static void
+gtd_snapshot_provider_refuse_task_list (GtdProvider *provider,
+                                        GtdTaskList *list)
+{
+  refuse_change (GTD_SNAPSHOT_PROVIDER (provider));
+}
+
+static GList*
+gtd_snapshot_provider_get_task_lists (GtdProvider *provider)
+{
+  return GTD_SNAPSHOT_PROVIDER (provider)->lists;
+}
+
+static GtdTaskList*
+gtd_snapshot_provider_get_default_task_list (GtdProvider *provider)
+{
+  return NULL;
+}
+
+static void
+gtd_snapshot_provider_set_default_task_list (GtdProvider *provider,
+                                             GtdTaskList *list)
+{
+}
+
+static void
+gtd_provider_iface_init (GtdProviderInterface *iface)
+{
+  iface->get_id = gtd_snapshot_provider_get_id;
+  iface->get_name = gtd_snapshot_provider_get_name;
+  iface->get_description = gtd_snapshot_provider_get_description;
+  iface->get_enabled = gtd_snapshot_provider_get_enabled;
+  iface->get_icon = gtd_snapshot_provider_get_icon;
+  iface->get_edit_panel = gtd_snapshot_provider_get_edit_panel;
+  iface->create_task = gtd_snapshot_provider_refuse_task;
+  iface->update_task = gtd_snapshot_provider_refuse_task;
+  iface->remove_task = gtd_snapshot_provider_refuse_task;
+  iface->create_task_list = gtd_snapshot_provider_refuse_task_list;
+  iface->update_task_list = gtd_snapshot_provider_refuse_task_list;
+  iface->remove_task_list = gtd_snapshot_provider_refuse_task_list;
+  iface->get_task_lists = gtd_snapshot_provider_get_task_lists;
+  iface->get_default_task_list = gtd_snapshot_provider_get_default_task_list;
+  iface->set_default_task_list = gtd_snapshot_provider_set_default_task_list;
+}
+
+static void
+gtd_snapshot_provider_finalize (GObject *object)
+{
+  GtdSnapshotProvider *self = (GtdSnapshotProvider *)object;
+
+  g_clear_pointer (&self->lists, g_list_free);
+  g_clear_pointer (&self->id, g_free);
+  g_clear_pointer (&self->name, g_free);
+  g_clear_pointer (&self->description, g_free);
+  g_clear_object (&self->icon);
+
+  G_OBJECT_CLASS (gtd_snapshot_provider_parent_class)->finalize (object);
+}
+
+static void
+gtd_snapshot_provider_get_property (GObject    *object,
+                                    guint       prop_id,
+                                    GValue     *value,
+                                    GParamSpec *pspec)
+{
+  GtdSnapshotProvider *self = GTD_SNAPSHOT_PROVIDER (object);
+
+  switch (prop_id)
+    {
+    case PROP_DEFAULT_TASKLIST:
+      g_value_set_object (value, NULL);
+      break;
+
+    case PROP_DESCRIPTION:
+      g_value_set_string (value, self->description);
+      break;
+
+    case PROP_ENABLED:
+      g_value_set_boolean (value, TRUE);
+      break;
+
+    case PROP_ICON:
+      g_value_set_object (value, self->icon);
+      break;
+
+    case PROP_ID:
+      g_value_set_string (value, self->id);
+      break;
+
+    case PROP_NAME:
+      g_value_set_string (value, self->name);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+    }
+}
+
+static void
+gtd_snapshot_provider_set_property (GObject      *object,
+                                    guint         prop_id,
+                                    const GValue *value,
+                                    GParamSpec   *pspec)
+{
+  switch (prop_id)
+    {
+    case PROP_DEFAULT_TASKLIST:
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+    }
+}
+
+static void
+gtd_snapshot_provider_class_init (GtdSnapshotProviderClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->finalize = gtd_snapshot_provider_finalize;
+  object_class->get_property = gtd_snapshot_provider_get_property;
+  object_class->set_property = gtd_snapshot_provider_set_property;
+
+  g_object_class_override_property (object_class, PROP_DEFAULT_TASKLIST, "default-task-list");
+  g_object_class_override_property (object_class, PROP_DESCRIPTION, "description");
+  g_object_class_override_property (object_class, PROP_ENABLED, "enabled");
+  g_object_class_override_property (object_class, PROP_ICON, "icon");
+  g_object_class_override_property (object_class, PROP_ID, "id");
+  g_object_class_override_property (object_class, PROP_NAME, "name");
+}
+
+static void
+gtd_snapshot_provider_init (GtdSnapshotProvider *self)
+{
+}
+
+
+/*
+ * Serialization
+ */
+
+static const gchar*
+get_list_id (GtdTaskList *list)
+{
+  const gchar *uid = gtd_object_get_uid (GTD_OBJECT (list));
+
+  return uid ? uid : gtd_task_list_get_name (list);
+}
+
+static gchar*
+get_snapshot_path (void)
+{
+  return g_build_filename (g_get_user_cache_dir (),
+                           "gnome-todo",
+                           "snapshot.gvariant",
+                           NULL);
+}
+
+static GVariant*
+serialize_task (GtdTask *task)
+{
+  g_autoptr (GDateTime) due_date = NULL;
+  GtdTask *parent;
+
+  due_date = gtd_task_get_due_date (task);
+  parent = gtd_task_get_parent (task);
+
+  return g_variant_new (TASK_FORMAT,
+                        gtd_object_get_uid (GTD_OBJECT (task)),
+                        parent ? gtd_object_get_uid (GTD_OBJECT (parent)) : "",
+                        gtd_task_get_title (task) ? gtd_task_get_title (task) : "",
+                        gtd_task_get_description (task) ? gtd_task_get_description (task) : "",
+                        gtd_task_get_complete (task),
+                        gtd_task_get_priority (task),
+                        due_date ? g_date_time_to_unix (due_date) : G_MININT64);
+}
+
+static GVariant*
+serialize_list (GtdTaskList *list)
+{
+  GVariantBuilder tasks;
+  GVariant *variant;
+  GdkRGBA *color;
+  GList *list_tasks;
+  GList *l;
+
+  color = gtd_task_list_get_color (list);
+  list_tasks = gtd_task_list_get_tasks (list);
+
+  g_variant_builder_init (&tasks, G_VARIANT_TYPE ("a" TASK_FORMAT));
+
+  for (l = list_tasks; l != NULL; l = l->next)
+    g_variant_builder_add_value (&tasks, serialize_task (l->data));
+
+  g_list_free (list_tasks);
+
+  variant = g_variant_new ("(ss(dddd)b@a" TASK_FORMAT ")",
+                           get_list_id (list),
+                           gtd_task_list_get_name (list) ? gtd_task_list_get_name (list) : "",
+                           color->red,
+                           color->green,
+                           color->blue,
+                           color->alpha,
+                           gtd_task_list_is_removable (list),
+                           g_variant_builder_end (&tasks));
+
+  gdk_rgba_free (color);
+
+  return variant;
+}
+
+/**
+ * gtd_snapshot_save:
+ * @lists: (element-type GtdTaskList): the lists to save
+ * @error: (nullable): return location for a #GError
+ *
+ * Serializes @lists and their tasks, and atomically replaces the
+ * snapshot on disk. Lists that were themselves loaded from the
+ * snapshot are skipped.
+ *
+ * Returns: %TRUE if the snapshot was written, %FALSE otherwise.
+ */
+gboolean
+gtd_snapshot_save (GList   *lists,
+                   GError **error)
+{
+  g_autoptr (GHashTable) providers = NULL;
+  g_autoptr (GVariant) snapshot = NULL;
+  g_autofree gchar *path = NULL;
+  g_autofree gchar *dir = NULL;
+  GVariantBuilder builder;
+  GHashTableIter iter;
+  gpointer provider;
+  gpointer provider_lists;
+  GList *l;
+
+  providers = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, (GDestroyNotify) g_ptr_array_unref);
+
+  /* Group the lists by provider */
+  for (l = lists; l != NULL; l = l->next)
+    {
+      GtdProvider *list_provider;
+      GPtrArray *array;
+
+      if (gtd_snapshot_is_snapshot_list (l->data))
+        continue;
+
+      list_provider = gtd_task_list_get_provider (l->data);
+
+      if (!list_provider)
+        continue;
+
+      array = g_hash_table_lookup (providers, list_provider);
+
+      if (!array)
+        {
+          array = g_ptr_array_new ();
+          g_hash_table_insert (providers, list_provider, array);
+        }
+
+      g_ptr_array_add (array, l->data);
+    }
+
+  g_variant_builder_init (&builder, G_VARIANT_TYPE ("a" PROVIDER_FORMAT));
+  g_hash_table_iter_init (&iter, providers);
+
+  while (g_hash_table_iter_next (&iter, &provider, &provider_lists))
+    {
+      g_autofree gchar *icon = NULL;
+      GVariantBuilder list_builder;
+      GPtrArray *array;
+      guint i;
+
+      array = provider_lists;
+
+      if (gtd_provider_get_icon (provider))
+        icon = g_icon_to_string (gtd_provider_get_icon (provider));
+
+      g_variant_builder_init (&list_builder, G_VARIANT_TYPE ("a" LIST_FORMAT));
+
+      for (i = 0; i < array->len; i++)
+        g_variant_builder_add_value (&list_builder, serialize_list (g_ptr_array_index (array, i)));
+
+      g_variant_builder_add (&builder,
+                             "(ssss@a" LIST_FORMAT ")",
+                             gtd_provider_get_id (provider),
+                             gtd_provider_get_name (provider) ? gtd_provider_get_name (provider) : "",
+                             gtd_provider_get_description (provider) ? gtd_provider_get_description (provider) : "",
+                             icon ? icon : "",
+                             g_variant_builder_end (&list_builder));
+    }
+
+  snapshot = g_variant_ref_sink (g_variant_new ("(u@a" PROVIDER_FORMAT ")",
+                                                SNAPSHOT_VERSION,
+                                                g_variant_builder_end (&builder)));
+
+  path = get_snapshot_path ();
+  dir = g_path_get_dirname (path);
+
+  if (g_mkdir_with_parents (dir, 0700) < 0)
+    {
+      g_set_error (error,
+                   G_FILE_ERROR,
+                   g_file_error_from_errno (errno),
+                   "Error creating %s: %s",
+                   dir,
+                   g_strerror (errno));
+      return FALSE;
+    }
+
+  /* g_file_set_contents() writes to a temporary file and renames it */
+  return g_file_set_contents (path,
+                              g_variant_get_data (snapshot),
+                              g_variant_get_size (snapshot),
+                              error);
+}
+
+static GtdTaskList*
+load_list (GtdSnapshotProvider *provider,
+           GVariant            *variant)
+{
+  g_autoptr (GHashTable) uid_to_task = NULL;
+  g_autoptr (GPtrArray) parent_uids = NULL;
+  g_autoptr (GPtrArray) tasks = NULL;
+  g_autoptr (GVariant) tasks_variant = NULL;
+  GtdTaskList *list;
+  const gchar *uid;
+  const gchar *name;
+  gboolean removable;
+  GVariantIter iter;
+  GdkRGBA color;
+  GVariant *task_variant;
+  guint i;
+
+  g_variant_get (variant,
+                 "(&s&s(dddd)b@a" TASK_FORMAT ")",
+                 &uid,
+                 &name,
+                 &color.red,
+                 &color.green,
+                 &color.blue,
+                 &color.alpha,
+                 &removable,
+                 &tasks_variant);
+
+  list = gtd_task_list_new (GTD_PROVIDER (provider));
+  gtd_object_set_uid (GTD_OBJECT (list), uid);
+  gtd_task_list_set_name (list, name);
+  gtd_task_list_set_color (list, &color);
+  gtd_task_list_set_is_removable (list, removable);
+
+  uid_to_task = g_hash_table_new (g_str_hash, g_str_equal);
+  tasks = g_ptr_array_new ();
+  parent_uids = g_ptr_array_new_with_free_func (g_free);
+
+  g_variant_iter_init (&iter, tasks_variant);
+
+  while ((task_variant = g_variant_iter_next_value (&iter)) != NULL)
+    {
+      ECalComponent *component;
+      const gchar *task_uid;
+      const gchar *parent_uid;
+      const gchar *title;
+      const gchar *description;
+      gboolean complete;
+      gint64 due_date;
+      gint priority;
+      GtdTask *task;
+
+      g_variant_get (task_variant,
+                     "(&s&s&s&sbix)",
+                     &task_uid,
+                     &parent_uid,
+                     &title,
+                     &description,
+                     &complete,
+                     &priority,
+                     &due_date);
+
+      /* The task takes ownership of the component */
+      component = e_cal_component_new ();
+      e_cal_component_set_new_vtype (component, E_CAL_COMPONENT_TODO);
+      e_cal_component_set_uid (component, task_uid);
+
+      task = gtd_task_new (component);
+      gtd_task_set_title (task, title);
+      gtd_task_set_priority (task, priority);
+      gtd_task_set_complete (task, complete);
+      gtd_task_set_list (task, list);
+
+      if (*description)
+        gtd_task_set_description (task, description);
+
+      if (due_date != G_MININT64)
+        {
+          g_autoptr (GDateTime) dt = g_date_time_new_from_unix_local (due_date);
+          gtd_task_set_due_date (task, dt);
+        }
+
+      g_hash_table_insert (uid_to_task, (gpointer) gtd_object_get_uid (GTD_OBJECT (task)), task);
+      g_ptr_array_add (parent_uids, g_strdup (parent_uid));
+      g_ptr_array_add (tasks, task);
+
+      g_variant_unref (task_variant);
+    }
+
+  /* Now that every task exists, rebuild the hierarchy */
+  for (i = 0; i < tasks->len; i++)
+    {
+      GtdTask *parent;
+
+      parent = g_hash_table_lookup (uid_to_task, g_ptr_array_index (parent_uids, i));
+
+      if (parent)
+        gtd_task_add_subtask (parent, g_ptr_array_index (tasks, i));
+    }
+
+  for (i = 0; i < tasks->len; i++)
+    gtd_task_list_save_task (list, g_ptr_array_index (tasks, i));
+
+  /* Only lists that are loaded from the snapshot have this set */
+  g_object_set_data (G_OBJECT (list), "gtd-snapshot-list", GINT_TO_POINTER (TRUE));
+
+  return list;
+}
+
+/**
+ * gtd_snapshot_load:
+ * @error: (nullable): return location for a #GError
+ *
+ * Loads the lists and tasks from the snapshot on disk. The returned lists
+ * belong to placeholder providers that refuse every change, and must be
+ * replaced by the real lists once their providers are loaded.
+ *
+ * Returns: (transfer full) (element-type GtdTaskList) (nullable): the
+ * lists in the snapshot.
+ */
+GList*
+gtd_snapshot_load (GError **error)
+{
+  g_autoptr (GMappedFile) file = NULL;
+  g_autoptr (GVariant) snapshot = NULL;
+  g_autoptr (GVariant) providers = NULL;
+  g_autoptr (GBytes) bytes = NULL;
+  g_autofree gchar *path = NULL;
+  GVariantIter iter;
+  GVariant *provider_variant;
+  GList *lists;
+  guint32 version;
+
+  path = get_snapshot_path ();
+  file = g_mapped_file_new (path, FALSE, error);
+
+  if (!file)
+    return NULL;
+
+  bytes = g_mapped_file_get_bytes (file);
+
+  /* The data isn't trusted, so GVariant validates it while reading */
+  snapshot = g_variant_ref_sink (g_variant_new_from_bytes (G_VARIANT_TYPE (SNAPSHOT_FORMAT), bytes, FALSE));
+
+  g_variant_get (snapshot, "(u@a" PROVIDER_FORMAT ")", &version, &providers);
+
+  if (version != SNAPSHOT_VERSION)
+    {
+      g_debug ("Ignoring snapshot with version %u", version);
+      return NULL;
+    }
+
+  lists = NULL;
+
+  g_variant_iter_init (&iter, providers);
+
+  while ((provider_variant = g_variant_iter_next_value (&iter)) != NULL)
+    {
+      g_autoptr (GVariant) lists_variant = NULL;
+      GtdSnapshotProvider *provider;
+      const gchar *icon;
+      GVariantIter list_iter;
+      GVariant *list_variant;
+
+      provider = g_object_new (GTD_TYPE_SNAPSHOT_PROVIDER, NULL);
+
+      g_variant_get (provider_variant,
+                     "(sss&s@a" LIST_FORMAT ")",
+                     &provider->id,
+                     &provider->name,
+                     &provider->description,
+                     &icon,
+                     &lists_variant);
+
+      if (*icon)
+        provider->icon = g_icon_new_for_string (icon, NULL);
+
+      g_variant_iter_init (&list_iter, lists_variant);
+
+      while ((list_variant = g_variant_iter_next_value (&list_iter)) != NULL)
+        {
+          GtdTaskList *list = load_list (provider, list_variant);
+
+          provider->lists = g_list_prepend (provider->lists, list);
+          lists = g_list_prepend (lists, list);
+
+          g_variant_unref (list_variant);
+        }
+
+      provider->lists = g_list_reverse (provider->lists);
+
+      /* The lists keep the provider alive */
+      g_object_unref (provider);
+      g_variant_unref (provider_variant);
+    }
+
+  return g_list_reverse (lists);
+}
+
+/**
+ * gtd_snapshot_is_snapshot_list:
+ * @list: a #GtdTaskList
+ *
+ * Checks whether @list was loaded from the snapshot.
+ *
+ * Returns: %TRUE if @list is a placeholder loaded from the snapshot
+ */
+gboolean
+gtd_snapshot_is_snapshot_list (GtdTaskList *list)
+{
+  return g_object_get_data (G_OBJECT (list), "gtd-snapshot-list") != NULL;
+}
+
+/**
+ * gtd_snapshot_get_list_key:
+ * @list: a #GtdTaskList
+ *
+ * Retrieves the key that identifies @list across launches. Lists loaded
+ * from the snapshot have the same key as the list they were saved from.
+ *
+ * Returns: (transfer full): the key of @list
+ */
+gchar*
+gtd_snapshot_get_list_key (GtdTaskList *list)
+{
+  GtdProvider *provider;
+  const gchar *uid;
+
+  provider = gtd_task_list_get_provider (list);
+  uid = gtd_object_get_uid (GTD_OBJECT (list));
+
+  return g_strdup_printf ("%s:%s",
+                          provider ? gtd_provider_get_id (provider) : "",
+                          uid ? uid : gtd_task_list_get_name (list));
+}
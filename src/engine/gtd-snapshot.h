@@ -0,0 +1,39 @@
+/* gtd-snapshot.h
+ *
+ * Copyright (C) 2017 Georges Basile Stavracas Neto <georges.stavracas@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GTD_SNAPSHOT_H
+#define GTD_SNAPSHOT_H
+
+#include "gtd-types.h"
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+gboolean             gtd_snapshot_save                           (GList              *lists,
+                                                                  GError            **error);
+
+GList*               gtd_snapshot_load                           (GError            **error);
+
+gboolean             gtd_snapshot_is_snapshot_list               (GtdTaskList        *list);
+
+gchar*               gtd_snapshot_get_list_key                   (GtdTaskList        *list);
+
+G_END_DECLS
+
+#endif /* GTD_SNAPSHOT_H */
@@ -29,6 +29,8 @@
 #include "gtd-task.h"
 #include "gtd-task-list.h"
 #include "gtd-task-list-view.h"
+#include "gtd-task-tracker.h"
+#include "gtd-timer.h"
 #include "gtd-window.h"
 #include "gtd-types.h"
 
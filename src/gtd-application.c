@@ -40,6 +40,9 @@ typedef struct
   GtkWidget      *window;
   GtkWidget      *plugin_dialog;
   GtkWidget      *initial_setup;
+
+  gint64          startup_time;
+  gboolean        plugins_loaded;
 } GtdApplicationPrivate;
 
 struct _GtdApplication
@@ -70,6 +73,8 @@ static void           gtd_application_quit                        (GSimpleAction
                                                                    GVariant             *parameter,
                                                                    gpointer              user_data);
 
+static void           run_window                                  (GtdApplication       *application);
+
 G_DEFINE_TYPE_WITH_PRIVATE (GtdApplication, gtd_application, GTK_TYPE_APPLICATION)
 
 static const GActionEntry gtd_application_entries[] = {
@@ -85,10 +90,7 @@ gtd_application_activate_action (GSimpleAction *simple,
                                  GVariant      *parameter,
                                  gpointer       user_data)
 {
-  GtdApplicationPrivate *priv = GTD_APPLICATION (user_data)->priv;
-
-  gtk_widget_show (priv->window);
-  gtk_window_present (GTK_WINDOW (priv->window));
+  run_window (GTD_APPLICATION (user_data));
 }
 
 static void
@@ -184,6 +186,37 @@ gtd_application_new (void)
                        NULL);
 }
 
+static gboolean
+window_first_draw_cb (GtkWidget      *window,
+                      cairo_t        *cr,
+                      GtdApplication *application)
+{
+  GtdApplicationPrivate *priv = application->priv;
+
+  g_signal_handlers_disconnect_by_func (window, window_first_draw_cb, application);
+
+  g_debug ("Time to first paint: %.3lfms",
+           (g_get_monotonic_time () - priv->startup_time) / 1000.0);
+
+  return GDK_EVENT_PROPAGATE;
+}
+
+static void
+manager_ready_changed_cb (GtdManager     *manager,
+                          GParamSpec     *pspec,
+                          GtdApplication *application)
+{
+  GtdApplicationPrivate *priv = application->priv;
+
+  if (!gtd_object_get_ready (GTD_OBJECT (manager)))
+    return;
+
+  g_signal_handlers_disconnect_by_func (manager, manager_ready_changed_cb, application);
+
+  g_debug ("Time to fully loaded: %.3lfms",
+           (g_get_monotonic_time () - priv->startup_time) / 1000.0);
+}
+
 static void
 run_window (GtdApplication *application)
 {
@@ -195,6 +228,23 @@ run_window (GtdApplication *application)
 
   gtk_widget_show (priv->window);
   gtk_window_present (GTK_WINDOW (priv->window));
+
+  /*
+   * Load the plugins only after the window is shown. They are loaded
+   * with low priority, so the window is drawn first, with the lists of
+   * the last session, and tasks show up as each provider loads them.
+   */
+  if (priv->plugins_loaded)
+    return;
+
+  priv->plugins_loaded = TRUE;
+
+  g_signal_connect (priv->manager,
+                    "notify::ready",
+                    G_CALLBACK (manager_ready_changed_cb),
+                    application);
+
+  gtd_manager_load_plugins (priv->manager);
 }
 
 /*
@@ -262,6 +312,7 @@ gtd_application_startup (GApplication *application)
   g_autofree gchar *theme_name, *theme_uri;
 
   priv = GTD_APPLICATION (application)->priv;
+  priv->startup_time = g_get_monotonic_time ();
 
   /* add actions */
   g_action_map_add_action_entries (G_ACTION_MAP (application),
@@ -278,6 +329,11 @@ gtd_application_startup (GApplication *application)
   gtk_window_set_default_icon_name ("org.gnome.Todo");
   priv->window = gtd_window_new (GTD_APPLICATION (application));
 
+  g_signal_connect_after (priv->window,
+                          "draw",
+                          G_CALLBACK (window_first_draw_cb),
+                          application);
+
   /* CSS provider */
   css_provider = gtk_css_provider_new ();
   gtk_style_context_add_provider_for_screen (gdk_screen_get_default (),
@@ -297,9 +353,6 @@ gtd_application_startup (GApplication *application)
   priv->plugin_dialog = gtd_plugin_dialog_new ();
 
   gtk_window_set_transient_for (GTK_WINDOW (priv->plugin_dialog), GTK_WINDOW (priv->window));
-
-  /* Load the plugins */
-  gtd_manager_load_plugins (priv->manager);
 }
 
 static gboolean
@@ -0,0 +1,153 @@
+/* gtd-color-style.c
+ *
+ * Copyright (C) 2017 Georges Basile Stavracas Neto <georges.stavracas@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define G_LOG_DOMAIN "ColorStyle"
+
+#include "gtd-color-style.h"
+
+/*
+ * Every list color is styled through a single stylesheet installed on
+ * the default screen. The first time a color is seen, a style class is
+ * generated for it and its rule is appended to the stylesheet; widgets
+ * showing that color then only toggle the class, which is much cheaper
+ * than parsing CSS and restyling a private provider per widget.
+ *
+ * New rules are accumulated and the stylesheet is reloaded once, right
+ * before the next frame, so loading many lists costs a single reload.
+ */
+
+#define COLOR_TEMPLATE ".%s { background-color: %s; }\n"
+
+static GtkCssProvider *provider = NULL;
+static GHashTable *color_classes = NULL;
+static GString *stylesheet = NULL;
+static guint reload_id = 0;
+
+static GQuark applied_class_quark = 0;
+
+static gboolean
+reload_stylesheet_cb (gpointer user_data)
+{
+  g_debug ("Reloading stylesheet with %u colors", g_hash_table_size (color_classes));
+
+  gtk_css_provider_load_from_data (provider, stylesheet->str, stylesheet->len, NULL);
+
+  reload_id = 0;
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+ensure_provider (void)
+{
+  if (provider)
+    return;
+
+  provider = gtk_css_provider_new ();
+  color_classes = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  stylesheet = g_string_new ("");
+  applied_class_quark = g_quark_from_static_string ("gtd-color-style-class");
+
+  gtk_style_context_add_provider_for_screen (gdk_screen_get_default (),
+                                             GTK_STYLE_PROVIDER (provider),
+                                             GTK_STYLE_PROVIDER_PRIORITY_APPLICATION + 2);
+}
+
+/**
+ * gtd_color_style_get_class:
+ * @color: a #GdkRGBA
+ *
+ * Retrieves the style class that sets the background of a widget
+ * to @color. The rule is added to the shared stylesheet the first
+ * time @color is requested.
+ *
+ * Returns: (transfer none): the interned style class for @color.
+ */
+const gchar*
+gtd_color_style_get_class (const GdkRGBA *color)
+{
+  g_autofree gchar *color_str = NULL;
+  gchar *class_name;
+  gchar *key;
+
+  g_return_val_if_fail (color != NULL, NULL);
+
+  ensure_provider ();
+
+  color_str = gdk_rgba_to_string (color);
+  class_name = g_hash_table_lookup (color_classes, color_str);
+
+  if (class_name)
+    return class_name;
+
+  key = g_strdup_printf ("list-color-%02x%02x%02x%02x",
+                         (guint) (CLAMP (color->red, 0.0, 1.0) * 255 + 0.5),
+                         (guint) (CLAMP (color->green, 0.0, 1.0) * 255 + 0.5),
+                         (guint) (CLAMP (color->blue, 0.0, 1.0) * 255 + 0.5),
+                         (guint) (CLAMP (color->alpha, 0.0, 1.0) * 255 + 0.5));
+
+  /* Intern the class, so the same pointer can be used by every widget */
+  class_name = (gchar*) g_intern_string (key);
+  g_free (key);
+
+  g_string_append_printf (stylesheet, COLOR_TEMPLATE, class_name, color_str);
+
+  g_hash_table_insert (color_classes, g_steal_pointer (&color_str), class_name);
+
+  if (reload_id == 0)
+    reload_id = g_idle_add_full (G_PRIORITY_HIGH_IDLE, reload_stylesheet_cb, NULL, NULL);
+
+  return class_name;
+}
+
+/**
+ * gtd_color_style_apply:
+ * @widget: a #GtkWidget
+ * @color: (nullable): a #GdkRGBA, or %NULL
+ *
+ * Makes @widget use @color as its background color, replacing the
+ * color class previously applied by this function. Passing %NULL
+ * only removes the previous class.
+ */
+void
+gtd_color_style_apply (GtkWidget     *widget,
+                       const GdkRGBA *color)
+{
+  GtkStyleContext *context;
+  const gchar *old_class;
+  const gchar *new_class;
+
+  g_return_if_fail (GTK_IS_WIDGET (widget));
+
+  ensure_provider ();
+
+  context = gtk_widget_get_style_context (widget);
+  old_class = g_object_get_qdata (G_OBJECT (widget), applied_class_quark);
+  new_class = color ? gtd_color_style_get_class (color) : NULL;
+
+  if (old_class == new_class)
+    return;
+
+  if (old_class)
+    gtk_style_context_remove_class (context, old_class);
+
+  if (new_class)
+    gtk_style_context_add_class (context, new_class);
+
+  g_object_set_qdata (G_OBJECT (widget), applied_class_quark, (gpointer) new_class);
+}
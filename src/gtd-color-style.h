@@ -0,0 +1,33 @@
+/* gtd-color-style.h
+ *
+ * Copyright (C) 2017 Georges Basile Stavracas Neto <georges.stavracas@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GTD_COLOR_STYLE_H
+#define GTD_COLOR_STYLE_H
+
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+const gchar*         gtd_color_style_get_class                   (const GdkRGBA      *color);
+
+void                 gtd_color_style_apply                       (GtkWidget          *widget,
+                                                                  const GdkRGBA      *color);
+
+G_END_DECLS
+
+#endif /* GTD_COLOR_STYLE_H */
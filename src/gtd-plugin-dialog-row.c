@@ -17,7 +17,10 @@
  */
 
 #include "gtd-activatable.h"
+#include "gtd-manager.h"
+#include "gtd-manager-protected.h"
 #include "gtd-plugin-dialog-row.h"
+#include "gtd-plugin-manager.h"
 
 #include <glib/gi18n.h>
 
@@ -25,6 +28,7 @@ struct _GtdPluginDialogRow
 {
   GtkListBoxRow       parent;
 
+  GtkWidget          *activation_time_label;
   GtkWidget          *description_label;
   GtkWidget          *error_image;
   GtkWidget          *icon_image;
@@ -54,6 +58,39 @@ enum
 
 static guint signals[NUM_SIGNALS] = { 0, };
 
+static void
+update_activation_time (GtdPluginDialogRow *row)
+{
+  GtdPluginManager *plugin_manager;
+  g_autofree gchar *text = NULL;
+  gint64 activation_time;
+
+  plugin_manager = gtd_manager_get_plugin_manager (gtd_manager_get_default ());
+  activation_time = gtd_plugin_manager_get_activation_time (plugin_manager, row->info);
+
+  if (activation_time >= 0)
+    {
+      /* Translators: the activation time of the plugin, in milliseconds */
+      text = g_strdup_printf (_("Activated in %.1f ms"), activation_time / 1000.0);
+    }
+  else if (row->plugin)
+    {
+      text = g_strdup (_("Activated when first used"));
+    }
+
+  gtk_label_set_label (GTK_LABEL (row->activation_time_label), text);
+  gtk_widget_set_visible (row->activation_time_label, text != NULL);
+}
+
+static void
+plugin_activated_cb (GtdPluginDialogRow *row,
+                     PeasPluginInfo     *info,
+                     GtdActivatable     *activatable)
+{
+  if (info == row->info)
+    update_activation_time (row);
+}
+
 static void
 preferences_button_clicked (GtdPluginDialogRow *row)
 {
@@ -134,6 +171,14 @@ gtd_plugin_dialog_row_constructed (GObject *object)
   gtk_image_set_from_icon_name (GTK_IMAGE (self->icon_image),
                                 peas_plugin_info_get_icon_name (self->info),
                                 GTK_ICON_SIZE_DND);
+
+  update_activation_time (self);
+
+  g_signal_connect_object (gtd_manager_get_plugin_manager (gtd_manager_get_default ()),
+                           "plugin-activated",
+                           G_CALLBACK (plugin_activated_cb),
+                           self,
+                           G_CONNECT_SWAPPED);
 }
 
 static void
@@ -224,6 +269,7 @@ gtd_plugin_dialog_row_class_init (GtdPluginDialogRowClass *klass)
 
   gtk_widget_class_set_template_from_resource (widget_class, "/org/gnome/todo/ui/plugin-row.ui");
 
+  gtk_widget_class_bind_template_child (widget_class, GtdPluginDialogRow, activation_time_label);
   gtk_widget_class_bind_template_child (widget_class, GtdPluginDialogRow, description_label);
   gtk_widget_class_bind_template_child (widget_class, GtdPluginDialogRow, error_image);
   gtk_widget_class_bind_template_child (widget_class, GtdPluginDialogRow, icon_image);
@@ -293,6 +339,9 @@ gtd_plugin_dialog_row_set_plugin (GtdPluginDialogRow *row,
                                          loaded_switch_changed,
                                          row);
 
+      if (row->info)
+        update_activation_time (row);
+
       g_object_notify (G_OBJECT (row), "plugin");
     }
 }
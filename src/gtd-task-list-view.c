@@ -17,6 +17,7 @@
  */
 
 #include "gtd-arrow-frame.h"
+#include "gtd-color-style.h"
 #include "gtd-dnd-row.h"
 #include "gtd-edit-pane.h"
 #include "gtd-empty-list-widget.h"
@@ -79,21 +80,38 @@ typedef struct
 
   /* internal */
   gboolean               can_toggle;
-  gint                   complete_tasks;
+  gint                   done_label_count;
   gboolean               show_completed : 1;
   gboolean               show_due_date : 1;
   gboolean               show_list_name : 1;
   gboolean               handle_subtasks : 1;
+  gboolean               compact_rows : 1;
+  gboolean               clearing_completed : 1;
   GList                 *list;
   GtdTaskList           *task_list;
   GDateTime             *default_date;
 
-  /* DnD autoscroll */
-  guint                  scroll_timeout_id;
-  gboolean               scroll_up : 1;
+  /* Tasks in the view, and how many of them are complete */
+  GHashTable            *tasks;
+  guint                  complete_tasks;
+  guint                  incomplete_tasks;
+
+  /* Tasks whose rows are added in chunks */
+  GQueue                *pending_queue;
+  GHashTable            *pending_tasks;
+  GList                 *incoming_tasks;
+  guint                  populate_id;
+
+  /* DnD autoscroll and row geometry, valid while dragging */
+  guint                  autoscroll_id;
+  gint64                 autoscroll_last_frame;
+  gdouble                autoscroll_velocity;
+  GArray                *dnd_geometry;
+  gint                   dnd_row_height;
+  gint                   dnd_row_index;
+  gboolean               dnd_geometry_valid : 1;
 
   /* color provider */
-  GtkCssProvider        *color_provider;
   GdkRGBA               *color;
 
   /* action */
@@ -120,12 +138,35 @@ struct _GtdTaskListView
   GtdTaskListViewPrivate *priv;
 };
 
-#define COLOR_TEMPLATE "viewport {background-color: %s;}"
 #define LUMINANCE(c)   (0.299 * c->red + 0.587 * c->green + 0.114 * c->blue)
 
 #define TASK_REMOVED_NOTIFICATION_ID             "task-removed-id"
 
-#define DND_SCROLL_OFFSET                        24 // px
+/* Lists with more tasks than this use compact rows */
+#define COMPACT_ROWS_THRESHOLD                   50
+
+/*
+ * When a list is set, the rows that fill the first screen are added
+ * right away, and the others in slices of at most POPULATE_BUDGET_US
+ * that run between frames.
+ */
+#define POPULATE_BUDGET_US                       4000
+#define POPULATE_MIN_FIRST_ROWS                  20
+#define POPULATE_ESTIMATED_ROW_HEIGHT            40
+
+/*
+ * While dragging, the list scrolls when the pointer is less than
+ * DND_SCROLL_OFFSET away from the edges, faster the closer it gets.
+ */
+#define DND_SCROLL_OFFSET                        48 // px
+#define DND_SCROLL_MAX_VELOCITY                  960 // px/s
+
+typedef struct
+{
+  GtkListBoxRow         *row;
+  gint                   y;
+  gint                   height;
+} DndRowGeometry;
 
 /* prototypes */
 static void             gtd_task_list_view__clear_completed_tasks    (GSimpleAction     *simple,
@@ -144,6 +185,10 @@ static void             task_completed_cb                            (GtdTask
                                                                       GParamSpec        *pspec,
                                                                       GtdTaskListView   *self);
 
+static void             stop_autoscroll                              (GtdTaskListView   *self);
+
+static void             invalidate_dnd_geometry                      (GtdTaskListView   *self);
+
 G_DEFINE_TYPE_WITH_PRIVATE (GtdTaskListView, gtd_task_list_view, GTK_TYPE_OVERLAY)
 
 static const GActionEntry gtd_task_list_view_entries[] = {
@@ -156,6 +201,12 @@ typedef struct
   GtdTask         *task;
 } RemoveTaskData;
 
+typedef struct
+{
+  GtdTaskListView *view;
+  GPtrArray       *tasks;
+} ClearCompletedData;
+
 enum {
   PROP_0,
   PROP_COLOR,
@@ -343,6 +394,38 @@ undo_remove_task_action (GtdNotification *notification,
   g_free (data);
 }
 
+static void
+clear_completed_data_free (ClearCompletedData *data)
+{
+  g_ptr_array_unref (data->tasks);
+  g_free (data);
+}
+
+static void
+clear_completed_action (GtdNotification *notification,
+                        gpointer         user_data)
+{
+  ClearCompletedData *data = user_data;
+
+  /* One removal per provider for the whole batch */
+  gtd_manager_remove_tasks (gtd_manager_get_default (), data->tasks);
+
+  clear_completed_data_free (data);
+}
+
+static void
+undo_clear_completed_action (GtdNotification *notification,
+                             gpointer         user_data)
+{
+  ClearCompletedData *data = user_data;
+  guint i;
+
+  for (i = 0; i < data->tasks->len; i++)
+    real_save_task (data->view, g_ptr_array_index (data->tasks, i));
+
+  clear_completed_data_free (data);
+}
+
 /*
  * Default sorting functions
  */
@@ -459,7 +542,7 @@ internal_compare_task_rows (GtdTaskListView *self,
                                 row1_task,
                                 GTK_LIST_BOX_ROW (row2),
                                 row2_task,
-                                self->priv->header_user_data);
+                                self->priv->sort_user_data);
 }
 
 static gint
@@ -538,65 +621,25 @@ update_font_color (GtdTaskListView *view)
     }
 }
 
-static void
-gtd_task_list_view__clear_completed_tasks (GSimpleAction *simple,
-                                           GVariant      *parameter,
-                                           gpointer       user_data)
+static inline guint
+get_n_visible_tasks (GtdTaskListView *view)
 {
-  GtdTaskListView *view;
-  GList *tasks;
-  GList *l;
-
-  view = GTD_TASK_LIST_VIEW (user_data);
-  tasks = gtd_task_list_view_get_list (view);
-
-  for (l = tasks; l != NULL; l = l->next)
-    {
-      if (gtd_task_get_complete (l->data))
-        {
-          GtdTaskList *list;
-
-          list = gtd_task_get_list (l->data);
-
-          gtd_task_list_remove_task (list, l->data);
-          gtd_manager_remove_task (gtd_manager_get_default (), l->data);
-        }
-    }
+  GtdTaskListViewPrivate *priv = view->priv;
 
-  gtd_task_list_view__update_done_label (view);
+  if (priv->show_completed)
+    return priv->incomplete_tasks + priv->complete_tasks;
 
-  g_list_free (tasks);
+  return priv->incomplete_tasks;
 }
 
 static void
 gtd_task_list_view__update_empty_state (GtdTaskListView *view)
 {
-  GtdTaskListViewPrivate *priv;
-  gboolean is_empty;
-  GList *tasks;
-  GList *l;
-
   g_return_if_fail (GTD_IS_TASK_LIST_VIEW (view));
 
-  priv = view->priv;
-  is_empty = TRUE;
-  tasks = gtd_task_list_view_get_list (view);
-
-  for (l = tasks; l != NULL; l = l->next)
-    {
-      if (!gtd_task_get_complete (l->data) ||
-          (priv->show_completed && gtd_task_get_complete (l->data)))
-        {
-          is_empty = FALSE;
-          break;
-        }
-    }
-
-  gtk_widget_set_visible (view->priv->empty_box, is_empty);
+  gtk_widget_set_visible (view->priv->empty_box, get_n_visible_tasks (view) == 0);
   gtd_empty_list_widget_set_is_empty (GTD_EMPTY_LIST_WIDGET (view->priv->empty_box),
                                       view->priv->complete_tasks == 0);
-
-  g_list_free (tasks);
 }
 
 static gboolean
@@ -740,34 +783,23 @@ static void
 gtd_task_list_view__color_changed (GtdTaskListView *self)
 {
   GtdTaskListViewPrivate *priv = GTD_TASK_LIST_VIEW (self)->priv;
-  gchar *color_str;
-  gchar *parsed_css;
 
-  /* Add the color to provider */
   if (priv->color)
     {
-      color_str = gdk_rgba_to_string (priv->color);
+      gtd_color_style_apply (priv->viewport, priv->color);
     }
-  else
+  else if (priv->task_list)
     {
       GdkRGBA *color;
 
       color = gtd_task_list_get_color (GTD_TASK_LIST (priv->task_list));
-      color_str = gdk_rgba_to_string (color);
+
+      gtd_color_style_apply (priv->viewport, color);
 
       gdk_rgba_free (color);
     }
 
-  parsed_css = g_strdup_printf (COLOR_TEMPLATE, color_str);
-
-  gtk_css_provider_load_from_data (priv->color_provider,
-                                   parsed_css,
-                                   -1,
-                                   NULL);
-
   update_font_color (self);
-
-  g_free (color_str);
 }
 
 static void
@@ -779,13 +811,19 @@ gtd_task_list_view__update_done_label (GtdTaskListView *view)
 
   gtk_revealer_set_reveal_child (GTK_REVEALER (view->priv->revealer), view->priv->complete_tasks > 0);
 
+  /* Only reformat the label when the count actually changed */
+  if (view->priv->done_label_count == (gint) view->priv->complete_tasks)
+    return;
+
+  view->priv->done_label_count = view->priv->complete_tasks;
+
   if (view->priv->complete_tasks == 0)
     {
       new_label = g_strdup_printf ("%s", _("Done"));
     }
   else
     {
-      new_label = g_strdup_printf ("%s (%d)",
+      new_label = g_strdup_printf ("%s (%u)",
                                    _("Done"),
                                    view->priv->complete_tasks);
     }
@@ -908,7 +946,10 @@ insert_task (GtdTaskListView *self,
   GtdTaskListViewPrivate *priv = self->priv;
   GtkWidget *new_row;
 
-  new_row = gtd_task_row_new (task);
+  if (priv->compact_rows)
+    new_row = gtd_task_row_new_compact (task);
+  else
+    new_row = gtd_task_row_new (task);
 
   g_object_bind_property (self,
                           "handle-subtasks",
@@ -933,6 +974,8 @@ insert_task (GtdTaskListView *self,
                        new_row,
                        0);
 
+  invalidate_dnd_geometry (self);
+
   /*
    * Setup a sizegroup to let all the tasklist labels have
    * the same width.
@@ -965,6 +1008,10 @@ remove_task (GtdTaskListView *view,
   GList *children;
   GList *l;
 
+  /* Tasks that are still waiting don't have a row yet */
+  if (g_hash_table_remove (priv->pending_tasks, task))
+    return;
+
   gtd_arrow_frame_set_row (view->priv->arrow_frame, NULL);
 
   children = gtk_container_get_children (GTK_CONTAINER (view->priv->listbox));
@@ -977,13 +1024,6 @@ remove_task (GtdTaskListView *view,
       if (l->data != priv->new_task_row &&
           gtd_task_row_get_task (l->data) == task)
         {
-          if (gtd_task_get_complete (task))
-            priv->complete_tasks--;
-
-          g_signal_handlers_disconnect_by_func (task,
-                                                task_completed_cb,
-                                                view);
-
           destroy_task_row (view, l->data);
           break;
         }
@@ -995,41 +1035,405 @@ remove_task (GtdTaskListView *view,
   g_list_free (children);
 }
 
-static inline gboolean
-has_complete_parent (GtdTask *task)
+/*
+ * The view follows the completion of the tasks it holds, and keeps
+ * the counters below in sync with them, so the "Done" label and the
+ * empty state never need to walk the list.
+ */
+static gboolean
+track_task (GtdTaskListView *view,
+            GtdTask         *task)
+{
+  GtdTaskListViewPrivate *priv = view->priv;
+
+  if (!g_hash_table_add (priv->tasks, task))
+    return FALSE;
+
+  if (gtd_task_get_complete (task))
+    priv->complete_tasks++;
+  else
+    priv->incomplete_tasks++;
+
+  g_signal_connect (task,
+                    "notify::complete",
+                    G_CALLBACK (task_completed_cb),
+                    view);
+
+  return TRUE;
+}
+
+static gboolean
+untrack_task (GtdTaskListView *view,
+              GtdTask         *task)
+{
+  GtdTaskListViewPrivate *priv = view->priv;
+
+  if (!g_hash_table_remove (priv->tasks, task))
+    return FALSE;
+
+  if (gtd_task_get_complete (task))
+    priv->complete_tasks--;
+  else
+    priv->incomplete_tasks--;
+
+  g_signal_handlers_disconnect_by_func (task,
+                                        task_completed_cb,
+                                        view);
+
+  return TRUE;
+}
+
+static inline gboolean
+has_complete_parent (GtdTask *task)
+{
+  GtdTask *parent = gtd_task_get_parent (task);
+
+  while (parent)
+    {
+      if (gtd_task_get_complete (parent))
+        return TRUE;
+
+      parent = gtd_task_get_parent (parent);
+    }
+
+  return FALSE;
+}
+
+static gboolean
+add_task_row (GtdTaskListView *view,
+              GtdTask         *task)
+{
+  GtdTaskListViewPrivate *priv = view->priv;
+
+  /* The row is added now, so don't add it again later */
+  g_hash_table_remove (priv->pending_tasks, task);
+
+  if (!priv->show_completed &&
+      (gtd_task_get_complete (task) || has_complete_parent (task)))
+    {
+      return FALSE;
+    }
+
+  insert_task (view, task);
+
+  return TRUE;
+}
+
+static void
+gtd_task_list_view__add_task (GtdTaskListView *view,
+                              GtdTask         *task)
+{
+  g_return_if_fail (GTD_IS_TASK_LIST_VIEW (view));
+  g_return_if_fail (GTD_IS_TASK (task));
+
+  if (!add_task_row (view, task))
+    return;
+
+  /* Check if it should show the empty state */
+  gtd_task_list_view__update_empty_state (view);
+}
+
+/*
+ * Clearing completed tasks is done as a single transaction: all the rows
+ * go away at once, without animations, the counters are updated once at
+ * the end, and the removal is sent to the providers in one batch when the
+ * notification is dismissed.
+ */
+static void
+gtd_task_list_view__clear_completed_tasks (GSimpleAction *simple,
+                                           GVariant      *parameter,
+                                           gpointer       user_data)
+{
+  GtdTaskListViewPrivate *priv;
+  g_autoptr (GHashTable) cleared = NULL;
+  GtdNotification *notification;
+  ClearCompletedData *data;
+  GtdTaskListView *view;
+  GList *children;
+  GList *tasks;
+  GList *l;
+  gchar *text;
+  guint i;
+
+  view = GTD_TASK_LIST_VIEW (user_data);
+  priv = view->priv;
+  tasks = gtd_task_list_view_get_list (view);
+  cleared = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+  data = g_new0 (ClearCompletedData, 1);
+  data->view = view;
+  data->tasks = g_ptr_array_new_with_free_func (g_object_unref);
+
+  for (l = tasks; l != NULL; l = l->next)
+    {
+      if (gtd_task_get_complete (l->data) && g_hash_table_add (cleared, l->data))
+        g_ptr_array_add (data->tasks, g_object_ref (l->data));
+    }
+
+  g_list_free (tasks);
+
+  if (data->tasks->len == 0)
+    {
+      clear_completed_data_free (data);
+      return;
+    }
+
+  /* Don't point at rows that are about to be destroyed */
+  gtd_dnd_row_set_row_above (GTD_DND_ROW (priv->dnd_row), NULL);
+  gtd_arrow_frame_set_row (priv->arrow_frame, NULL);
+
+  if (g_hash_table_contains (cleared, gtd_edit_pane_get_task (priv->edit_pane)))
+    {
+      gtk_revealer_set_reveal_child (priv->edit_revealer, FALSE);
+      gtd_edit_pane_set_task (priv->edit_pane, NULL);
+    }
+
+  /* Destroy the rows in a single pass */
+  children = gtk_container_get_children (GTK_CONTAINER (priv->listbox));
+
+  for (l = children; l != NULL; l = l->next)
+    {
+      if (!GTD_IS_TASK_ROW (l->data))
+        continue;
+
+      if (!g_hash_table_contains (cleared, gtd_task_row_get_task (l->data)))
+        continue;
+
+      g_signal_handlers_disconnect_by_func (l->data, task_row_entered_cb, view);
+      g_signal_handlers_disconnect_by_func (l->data, task_row_exited_cb, view);
+
+      if (l->data == priv->active_row)
+        set_active_row (view, NULL);
+
+      gtk_widget_destroy (l->data);
+    }
+
+  g_list_free (children);
+
+  /* The rows are gone already, so ::task-removed has nothing left to do */
+  priv->clearing_completed = TRUE;
+
+  for (i = 0; i < data->tasks->len; i++)
+    {
+      GtdTask *task;
+      GtdTaskList *list;
+
+      task = g_ptr_array_index (data->tasks, i);
+      list = gtd_task_get_list (task);
+
+      g_hash_table_remove (priv->pending_tasks, task);
+
+      gtd_task_list_remove_task (list, task);
+
+      if (priv->task_list != list && priv->task_list)
+        gtd_task_list_remove_task (priv->task_list, task);
+
+      untrack_task (view, task);
+    }
+
+  priv->clearing_completed = FALSE;
+
+  gtd_task_list_view__update_done_label (view);
+  gtd_task_list_view__update_empty_state (view);
+
+  /* Notify about the removal */
+  text = g_strdup_printf (ngettext ("%u completed task removed",
+                                    "%u completed tasks removed",
+                                    data->tasks->len),
+                          data->tasks->len);
+
+  notification = gtd_notification_new (text, 7500.0);
+
+  gtd_notification_set_primary_action (notification,
+                                       (GtdNotificationActionFunc) clear_completed_action,
+                                       data);
+
+  gtd_notification_set_secondary_action (notification,
+                                         _("Undo"),
+                                         (GtdNotificationActionFunc) undo_clear_completed_action,
+                                         data);
+
+  gtd_window_notify (GTD_WINDOW (gtk_widget_get_toplevel (GTK_WIDGET (view))), notification);
+
+  g_free (text);
+}
+
+/*
+ * Chunked population
+ *
+ * Tasks set with gtd_task_list_view_set_list() are queued in the order
+ * their rows will have, so the first screen is filled first. Tasks added
+ * one by one with gtd_task_list_view_add_task() are collected, and merged
+ * into the queue in a single pass by the idle. Tasks that leave the view,
+ * or get a row by other means, are dropped from the pending set, and their
+ * stale entries in the queue are skipped.
+ */
+
+static gint
+compare_pending_tasks (gconstpointer a,
+                       gconstpointer b,
+                       gpointer      user_data)
+{
+  GtdTaskListViewPrivate *priv = GTD_TASK_LIST_VIEW (user_data)->priv;
+
+  if (priv->sort_func)
+    return priv->sort_func (NULL, (GtdTask*) a, NULL, (GtdTask*) b, priv->sort_user_data);
+
+  return gtd_task_compare ((GtdTask*) a, (GtdTask*) b);
+}
+
+/* Returns whether there are tasks left */
+static gboolean
+populate_pending_tasks (GtdTaskListView *self,
+                        gint64           budget,
+                        guint            min_rows)
+{
+  GtdTaskListViewPrivate *priv = self->priv;
+  gint64 deadline;
+  guint n_rows;
+
+  deadline = g_get_monotonic_time () + budget;
+  n_rows = 0;
+
+  while (!g_queue_is_empty (priv->pending_queue))
+    {
+      GtdTask *task = g_queue_pop_head (priv->pending_queue);
+
+      if (!g_hash_table_contains (priv->pending_tasks, task))
+        continue;
+
+      n_rows += add_task_row (self, task);
+
+      if (n_rows >= min_rows && g_get_monotonic_time () >= deadline)
+        break;
+    }
+
+  return !g_queue_is_empty (priv->pending_queue);
+}
+
+static gboolean
+populate_idle_cb (gpointer user_data)
+{
+  GtdTaskListView *self = GTD_TASK_LIST_VIEW (user_data);
+
+  if (self->priv->incoming_tasks)
+    queue_pending_tasks (self, g_steal_pointer (&self->priv->incoming_tasks));
+
+  if (populate_pending_tasks (self, POPULATE_BUDGET_US, 0))
+    return G_SOURCE_CONTINUE;
+
+  g_debug ("Finished adding rows");
+
+  self->priv->populate_id = 0;
+
+  return G_SOURCE_REMOVE;
+}
+
+/*
+ * Merges @tasks into the pending queue, which is kept sorted. Stale entries
+ * are dropped on the way, they may point to finalized tasks.
+ */
+static void
+queue_pending_tasks (GtdTaskListView *self,
+                     GList           *tasks)
+{
+  GtdTaskListViewPrivate *priv = self->priv;
+  GList *link;
+  GList *next;
+  GList *l;
+
+  for (l = tasks; l != NULL; l = next)
+    {
+      next = l->next;
+
+      if (!g_hash_table_contains (priv->pending_tasks, l->data))
+        tasks = g_list_delete_link (tasks, l);
+    }
+
+  tasks = g_list_sort_with_data (tasks, compare_pending_tasks, self);
+  link = priv->pending_queue->head;
+
+  for (l = tasks; l != NULL; l = l->next)
+    {
+      while (link)
+        {
+          next = link->next;
+
+          if (!g_hash_table_contains (priv->pending_tasks, link->data))
+            g_queue_delete_link (priv->pending_queue, link);
+          else if (compare_pending_tasks (link->data, l->data, self) > 0)
+            break;
+
+          link = next;
+        }
+
+      if (link)
+        g_queue_insert_before (priv->pending_queue, link, l->data);
+      else
+        g_queue_push_tail (priv->pending_queue, l->data);
+    }
+
+  g_list_free (tasks);
+}
+
+/* Takes ownership of @tasks, which must already be tracked and pending */
+static void
+start_population (GtdTaskListView *self,
+                  GList           *tasks)
 {
-  GtdTask *parent = gtd_task_get_parent (task);
+  GtdTaskListViewPrivate *priv = self->priv;
+  gboolean fill_first_screen;
 
-  while (parent)
+  /*
+   * Tracked tasks that aren't pending already have a row, or are hidden. The
+   * first screen is only filled synchronously when nothing is shown yet and
+   * no population is running; otherwise the new rows go through the idle.
+   */
+  fill_first_screen = priv->populate_id == 0 &&
+                      g_hash_table_size (priv->tasks) == g_hash_table_size (priv->pending_tasks);
+
+  queue_pending_tasks (self, g_list_concat (tasks, g_steal_pointer (&priv->incoming_tasks)));
+
+  if (fill_first_screen)
     {
-      if (gtd_task_get_complete (parent))
-        return TRUE;
+      guint n_first_rows;
 
-      parent = gtd_task_get_parent (parent);
+      n_first_rows = gtk_widget_get_allocated_height (priv->scrolled_window) / POPULATE_ESTIMATED_ROW_HEIGHT + 1;
+      n_first_rows = MAX (n_first_rows, POPULATE_MIN_FIRST_ROWS);
+
+      if (!populate_pending_tasks (self, 0, n_first_rows))
+        return;
     }
 
-  return FALSE;
+  if (g_hash_table_size (priv->pending_tasks) == 0)
+    return;
+
+  g_debug ("Adding %u remaining rows in chunks", g_hash_table_size (priv->pending_tasks));
+
+  /* The other rows are added in slices, without blocking the frames */
+  if (priv->populate_id == 0)
+    {
+      priv->populate_id = g_idle_add_full (GDK_PRIORITY_REDRAW + 10,
+                                           populate_idle_cb,
+                                           self,
+                                           NULL);
+    }
 }
 
 static void
-gtd_task_list_view__add_task (GtdTaskListView *view,
-                              GtdTask         *task)
+cancel_population (GtdTaskListView *self)
 {
-  GtdTaskListViewPrivate *priv = view->priv;
-
-  g_return_if_fail (GTD_IS_TASK_LIST_VIEW (view));
-  g_return_if_fail (GTD_IS_TASK (task));
+  GtdTaskListViewPrivate *priv = self->priv;
 
-  if (!priv->show_completed &&
-      (gtd_task_get_complete (task) || has_complete_parent (task)))
+  if (priv->populate_id > 0)
     {
-      return;
+      g_source_remove (priv->populate_id);
+      priv->populate_id = 0;
     }
 
-  insert_task (view, task);
-
-  /* Check if it should show the empty state */
-  gtd_task_list_view__update_empty_state (view);
+  g_queue_clear (priv->pending_queue);
+  g_hash_table_remove_all (priv->pending_tasks);
+  g_clear_pointer (&priv->incoming_tasks, g_list_free);
 }
 
 static void
@@ -1064,15 +1468,16 @@ static void
 gtd_task_list_view__remove_task (GtdTaskListView *view,
                                  GtdTask         *task)
 {
+  /* Clearing completed tasks updates everything at once */
+  if (view->priv->clearing_completed)
+    return;
+
   /* Remove the correspondent row */
   gtd_task_list_view__remove_row_for_task (view, task);
 
   /* Update the "Done" label */
-  if (gtd_task_get_complete (task))
-    {
-      view->priv->complete_tasks--;
-      gtd_task_list_view__update_done_label (view);
-    }
+  if (untrack_task (view, task))
+    gtd_task_list_view__update_done_label (view);
 
   /* Check if it should show the empty state */
   gtd_task_list_view__update_empty_state (view);
@@ -1108,9 +1513,15 @@ task_completed_cb (GtdTask         *task,
   real_save_task (self, task);
 
   if (task_complete)
-    priv->complete_tasks++;
+    {
+      priv->complete_tasks++;
+      priv->incomplete_tasks--;
+    }
   else
-    priv->complete_tasks--;
+    {
+      priv->complete_tasks--;
+      priv->incomplete_tasks++;
+    }
 
   /*
    * If we're editing the task and it get completed, hide the edit
@@ -1145,16 +1556,17 @@ gtd_task_list_view__task_added (GtdTaskList     *list,
 {
   GtdTaskListViewPrivate *priv = gtd_task_list_view_get_instance_private (self);
 
+  if (!track_task (self, task))
+    return;
+
   /* Add the new task to the list */
   gtd_task_list_view__add_task (self, task);
 
   /* Also add to the list of current tasks */
   priv->list = g_list_prepend (priv->list, task);
 
-  g_signal_connect (task,
-                    "notify::complete",
-                    G_CALLBACK (task_completed_cb),
-                    self);
+  gtd_task_list_view__update_done_label (self);
+  gtd_task_list_view__update_empty_state (self);
 }
 
 static void
@@ -1198,6 +1610,29 @@ gtd_task_list_view__create_task (GtdTaskRow  *row,
   gtd_manager_create_task (gtd_manager_get_default (), task);
 }
 
+static void
+gtd_task_list_view_dispose (GObject *object)
+{
+  GtdTaskListView *self = GTD_TASK_LIST_VIEW (object);
+  GHashTableIter iter;
+  gpointer task;
+
+  cancel_population (self);
+  stop_autoscroll (self);
+
+  /* Stop following the completion of the tasks */
+  g_hash_table_iter_init (&iter, self->priv->tasks);
+
+  while (g_hash_table_iter_next (&iter, &task, NULL))
+    g_signal_handlers_disconnect_by_func (task, task_completed_cb, self);
+
+  g_hash_table_remove_all (self->priv->tasks);
+  self->priv->complete_tasks = 0;
+  self->priv->incomplete_tasks = 0;
+
+  G_OBJECT_CLASS (gtd_task_list_view_parent_class)->dispose (object);
+}
+
 static void
 gtd_task_list_view_finalize (GObject *object)
 {
@@ -1205,6 +1640,10 @@ gtd_task_list_view_finalize (GObject *object)
 
   g_clear_pointer (&priv->default_date, g_date_time_unref);
   g_clear_pointer (&priv->list, g_list_free);
+  g_clear_pointer (&priv->pending_queue, g_queue_free);
+  g_clear_pointer (&priv->pending_tasks, g_hash_table_destroy);
+  g_clear_pointer (&priv->tasks, g_hash_table_destroy);
+  g_clear_pointer (&priv->dnd_geometry, g_array_unref);
 
   G_OBJECT_CLASS (gtd_task_list_view_parent_class)->finalize (object);
 }
@@ -1302,13 +1741,6 @@ gtd_task_list_view_constructed (GObject *object)
                                    G_N_ELEMENTS (gtd_task_list_view_entries),
                                    object);
 
-  /* css provider */
-  self->priv->color_provider = gtk_css_provider_new ();
-
-  gtk_style_context_add_provider (gtk_widget_get_style_context (self->priv->viewport),
-                                  GTK_STYLE_PROVIDER (self->priv->color_provider),
-                                  GTK_STYLE_PROVIDER_PRIORITY_APPLICATION + 2);
-
   /* show a nifty separator between lines */
   gtk_list_box_set_sort_func (self->priv->listbox,
                               (GtkListBoxSortFunc) gtd_task_list_view__listbox_sort_func,
@@ -1319,68 +1751,237 @@ gtd_task_list_view_constructed (GObject *object)
 /*
  * Listbox Drag n' Drop functions
  */
-static inline gboolean
-scroll_to_dnd (gpointer user_data)
+static gboolean
+autoscroll_tick_cb (GtkWidget     *widget,
+                    GdkFrameClock *frame_clock,
+                    gpointer       user_data)
 {
   GtdTaskListViewPrivate *priv;
   GtkAdjustment *vadjustment;
-  gint value;
+  gint64 frame_time;
+  gdouble value;
+
+  priv = GTD_TASK_LIST_VIEW (widget)->priv;
+  frame_time = gdk_frame_clock_get_frame_time (frame_clock);
+
+  /* The first frame only sets the time reference */
+  if (priv->autoscroll_last_frame == 0)
+    {
+      priv->autoscroll_last_frame = frame_time;
+      return G_SOURCE_CONTINUE;
+    }
 
-  priv = gtd_task_list_view_get_instance_private (user_data);
   vadjustment = gtk_scrolled_window_get_vadjustment (GTK_SCROLLED_WINDOW (priv->scrolled_window));
-  value = gtk_adjustment_get_value (vadjustment) + (priv->scroll_up ? -6 : 6);
+  value = gtk_adjustment_get_value (vadjustment);
+  value += priv->autoscroll_velocity * (frame_time - priv->autoscroll_last_frame) / G_USEC_PER_SEC;
+
+  priv->autoscroll_last_frame = frame_time;
 
   gtk_adjustment_set_value (vadjustment,
-                            CLAMP (value, 0, gtk_adjustment_get_upper (vadjustment)));
+                            CLAMP (value,
+                                   gtk_adjustment_get_lower (vadjustment),
+                                   gtk_adjustment_get_upper (vadjustment) - gtk_adjustment_get_page_size (vadjustment)));
 
   return G_SOURCE_CONTINUE;
 }
 
 static void
-check_dnd_scroll (GtdTaskListView *self,
-                  gboolean         should_cancel,
-                  gint             y)
+stop_autoscroll (GtdTaskListView *self)
 {
-  GtdTaskListViewPrivate *priv = gtd_task_list_view_get_instance_private (self);
-  gint current_y, height;
+  GtdTaskListViewPrivate *priv = self->priv;
 
-  if (should_cancel)
+  if (priv->autoscroll_id > 0)
     {
-      if (priv->scroll_timeout_id > 0)
-        {
-          g_source_remove (priv->scroll_timeout_id);
-          priv->scroll_timeout_id = 0;
-        }
-
-      return;
+      gtk_widget_remove_tick_callback (GTK_WIDGET (self), priv->autoscroll_id);
+      priv->autoscroll_id = 0;
     }
 
+  priv->autoscroll_velocity = 0.0;
+}
+
+static void
+check_dnd_scroll (GtdTaskListView *self,
+                  gint             y)
+{
+  GtdTaskListViewPrivate *priv = self->priv;
+  gdouble distance;
+  gint current_y, height;
+
   height = gtk_widget_get_allocated_height (priv->scrolled_window);
   gtk_widget_translate_coordinates (GTK_WIDGET (priv->listbox),
                                     priv->scrolled_window,
                                     0, y,
                                     NULL, &current_y);
 
-  if (current_y < DND_SCROLL_OFFSET || current_y > height - DND_SCROLL_OFFSET)
+  /* How deep into the top (negative) or bottom (positive) edge the pointer is */
+  if (current_y < DND_SCROLL_OFFSET)
+    distance = current_y - DND_SCROLL_OFFSET;
+  else if (current_y > height - DND_SCROLL_OFFSET)
+    distance = current_y - (height - DND_SCROLL_OFFSET);
+  else
+    distance = 0.0;
+
+  if (distance == 0.0)
     {
-      if (priv->scroll_timeout_id > 0)
-        return;
+      stop_autoscroll (self);
+      return;
+    }
+
+  priv->autoscroll_velocity = CLAMP (distance / DND_SCROLL_OFFSET, -1.0, 1.0) * DND_SCROLL_MAX_VELOCITY;
 
-      /* Start the autoscroll */
-      priv->scroll_up = current_y < DND_SCROLL_OFFSET;
-      priv->scroll_timeout_id = g_timeout_add (25,
-                                               scroll_to_dnd,
-                                               self);
+  if (priv->autoscroll_id == 0)
+    {
+      priv->autoscroll_last_frame = 0;
+      priv->autoscroll_id = gtk_widget_add_tick_callback (GTK_WIDGET (self),
+                                                          autoscroll_tick_cb,
+                                                          NULL,
+                                                          NULL);
     }
-  else
+}
+
+/*
+ * The geometry of the visible task rows is gathered when a drag enters
+ * the list, and reused by every motion event until task rows are added
+ * or removed. It is laid out as if the DnD row wasn't there, so moving
+ * the DnD row around doesn't change it; the pointer is moved into these
+ * coordinates instead, see get_dnd_geometry_y().
+ */
+static void
+invalidate_dnd_geometry (GtdTaskListView *self)
+{
+  self->priv->dnd_geometry_valid = FALSE;
+}
+
+static void
+listbox_remove_cb (GtdTaskListView *self,
+                   GtkWidget       *widget)
+{
+  if (GTD_IS_TASK_ROW (widget))
+    invalidate_dnd_geometry (self);
+}
+
+static void
+ensure_dnd_geometry (GtdTaskListView *self)
+{
+  GtdTaskListViewPrivate *priv = self->priv;
+  GList *children, *l;
+  gint y;
+
+  if (priv->dnd_geometry_valid)
+    return;
+
+  g_array_set_size (priv->dnd_geometry, 0);
+  priv->dnd_row_index = -1;
+  y = 0;
+
+  gtk_widget_get_preferred_height (priv->dnd_row, NULL, &priv->dnd_row_height);
+
+  /*
+   * Children are already in the listbox's sort order. Only their heights
+   * are used, since the positions of the rows below the row being dragged,
+   * which is hidden, aren't updated until the listbox is allocated again.
+   */
+  children = gtk_container_get_children (GTK_CONTAINER (priv->listbox));
+
+  for (l = children; l != NULL; l = l->next)
     {
-      if (priv->scroll_timeout_id == 0)
-        return;
+      DndRowGeometry geometry;
+      GtkWidget *header;
+
+      if (l->data == (gpointer) priv->dnd_row || !gtk_widget_get_visible (l->data))
+        continue;
 
-      /* Cancel the autoscroll */
-      g_source_remove (priv->scroll_timeout_id);
-      priv->scroll_timeout_id = 0;
+      header = gtk_list_box_row_get_header (l->data);
+
+      if (header && gtk_widget_get_visible (header))
+        y += gtk_widget_get_allocated_height (header);
+
+      geometry.row = l->data;
+      geometry.y = y;
+      geometry.height = gtk_widget_get_allocated_height (l->data);
+
+      y += geometry.height;
+
+      /* The new task row only takes space */
+      if (GTD_IS_TASK_ROW (l->data))
+        g_array_append_val (priv->dnd_geometry, geometry);
+    }
+
+  g_list_free (children);
+
+  priv->dnd_geometry_valid = TRUE;
+}
+
+/* Moves @y, relative to the listbox, into the coordinates of the geometry */
+static gint
+get_dnd_geometry_y (GtdTaskListView *self,
+                    gint             y)
+{
+  GtdTaskListViewPrivate *priv = self->priv;
+  GtkListBoxRow *row_above;
+  DndRowGeometry *geometry;
+  gint dnd_row_y;
+  guint i;
+
+  if (!gtk_widget_get_visible (priv->dnd_row))
+    return y;
+
+  row_above = gtd_dnd_row_get_row_above (GTD_DND_ROW (priv->dnd_row));
+
+  /* Without a row above, the DnD row is the first one */
+  if (!row_above)
+    return y >= priv->dnd_row_height ? y - priv->dnd_row_height : y;
+
+  /* Most of the time, the DnD row is still where the last motion put it */
+  i = priv->dnd_row_index;
+
+  if (i >= priv->dnd_geometry->len || g_array_index (priv->dnd_geometry, DndRowGeometry, i).row != row_above)
+    {
+      for (i = 0; i < priv->dnd_geometry->len; i++)
+        {
+          if (g_array_index (priv->dnd_geometry, DndRowGeometry, i).row == row_above)
+            break;
+        }
+
+      if (i == priv->dnd_geometry->len)
+        return y;
+    }
+
+  geometry = &g_array_index (priv->dnd_geometry, DndRowGeometry, i);
+  dnd_row_y = geometry->y + geometry->height;
+
+  return y >= dnd_row_y + priv->dnd_row_height ? y - priv->dnd_row_height : y;
+}
+
+static void
+clear_dnd_geometry (GtdTaskListView *self)
+{
+  g_array_set_size (self->priv->dnd_geometry, 0);
+  self->priv->dnd_geometry_valid = FALSE;
+}
+
+/* Index of the last task row that starts at or above @y, or -1 */
+static gint
+find_dnd_geometry_index (GtdTaskListView *self,
+                         gint             y)
+{
+  GArray *geometry = self->priv->dnd_geometry;
+  gint low, high;
+
+  low = 0;
+  high = geometry->len;
+
+  while (low < high)
+    {
+      gint middle = low + (high - low) / 2;
+
+      if (g_array_index (geometry, DndRowGeometry, middle).y <= y)
+        low = middle + 1;
+      else
+        high = middle;
     }
+
+  return low - 1;
 }
 
 static void
@@ -1395,7 +1996,8 @@ listbox_drag_leave (GtkListBox      *listbox,
 
   gtk_widget_set_visible (priv->dnd_row, FALSE);
 
-  check_dnd_scroll (self, TRUE, -1);
+  stop_autoscroll (self);
+  clear_dnd_geometry (self);
 
   gtk_list_box_invalidate_sort (listbox);
 }
@@ -1410,9 +2012,9 @@ listbox_drag_motion (GtkListBox      *listbox,
 {
   GtdTaskListViewPrivate *priv;
   GtkListBoxRow *hovered_row;
-  GtkListBoxRow *task_row;
   GtkListBoxRow *row_above_dnd;
-  gint row_x, row_y, row_height;
+  gint geometry_y;
+  gint row_index;
 
   priv = gtd_task_list_view_get_instance_private (self);
   hovered_row = gtk_list_box_get_row_at_y (listbox, y);
@@ -1437,49 +2039,30 @@ listbox_drag_motion (GtkListBox      *listbox,
   if (GTD_IS_DND_ROW (hovered_row))
     goto success;
 
-  row_above_dnd = NULL;
-  task_row = hovered_row;
-  row_height = gtk_widget_get_allocated_height (GTK_WIDGET (hovered_row));
-  gtk_widget_translate_coordinates (GTK_WIDGET (listbox),
-                                    GTK_WIDGET (hovered_row),
-                                    x, y,
-                                    &row_x, &row_y);
+  ensure_dnd_geometry (self);
+
+  geometry_y = get_dnd_geometry_y (self, y);
+  row_index = find_dnd_geometry_index (self, geometry_y);
 
   gtk_widget_show (priv->dnd_row);
 
   /*
    * If the pointer if in the top part of the row, move the DnD row to
    * the previous row. Also, when hovering the new task row, only show
-   * the dnd row over it (never below).
+   * the dnd row over it (never below) - the closest task row above it
+   * is already the one found by the lookup.
    */
-  if (row_y < row_height / 2 || GTD_IS_NEW_TASK_ROW (task_row))
+  if (row_index >= 0 && GTD_IS_TASK_ROW (hovered_row))
     {
-      gint row_index, i;
-
-      row_index = gtk_list_box_row_get_index (hovered_row);
-
-      /* Search for a valid task row */
-      for (i = row_index - 1; i >= 0; i--)
-        {
-          GtkListBoxRow *aux;
+      DndRowGeometry *geometry = &g_array_index (priv->dnd_geometry, DndRowGeometry, row_index);
 
-          aux = gtk_list_box_get_row_at_index (GTK_LIST_BOX (priv->listbox), i);
-
-          /* Skip DnD, New task and hidden rows */
-          if (!GTD_IS_TASK_ROW (aux) || (aux && !gtk_widget_get_visible (GTK_WIDGET (aux))))
-            {
-              continue;
-            }
+      if (geometry_y - geometry->y < geometry->height / 2)
+        row_index--;
+    }
 
-          row_above_dnd = aux;
+  priv->dnd_row_index = row_index;
 
-          break;
-        }
-    }
-  else
-    {
-      row_above_dnd = task_row;
-    }
+  row_above_dnd = row_index >= 0 ? g_array_index (priv->dnd_geometry, DndRowGeometry, row_index).row : NULL;
 
   /* Check if we're not trying to add a subtask */
   if (row_above_dnd)
@@ -1516,7 +2099,7 @@ success:
                            y,
                            time);
 
-  check_dnd_scroll (self, FALSE, y);
+  check_dnd_scroll (self, y);
 
   gdk_drag_status (context, GDK_ACTION_COPY, time);
 
@@ -1544,7 +2127,8 @@ listbox_drag_drop (GtkWidget       *widget,
                          y,
                          time);
 
-  check_dnd_scroll (self, TRUE, -1);
+  stop_autoscroll (self);
+  clear_dnd_geometry (self);
 
   return TRUE;
 }
@@ -1577,6 +2161,7 @@ gtd_task_list_view_class_init (GtdTaskListViewClass *klass)
   GObjectClass *object_class = G_OBJECT_CLASS (klass);
   GtkWidgetClass *widget_class = GTK_WIDGET_CLASS (klass);
 
+  object_class->dispose = gtd_task_list_view_dispose;
   object_class->finalize = gtd_task_list_view_finalize;
   object_class->constructed = gtd_task_list_view_constructed;
   object_class->get_property = gtd_task_list_view_get_property;
@@ -1709,9 +2294,19 @@ gtd_task_list_view_init (GtdTaskListView *self)
   self->priv->can_toggle = TRUE;
   self->priv->handle_subtasks = TRUE;
   self->priv->show_due_date = TRUE;
+  self->priv->pending_queue = g_queue_new ();
+  self->priv->pending_tasks = g_hash_table_new (g_direct_hash, g_direct_equal);
+  self->priv->tasks = g_hash_table_new (g_direct_hash, g_direct_equal);
+  self->priv->done_label_count = -1;
+  self->priv->dnd_geometry = g_array_new (FALSE, FALSE, sizeof (DndRowGeometry));
 
   gtk_widget_init_template (GTK_WIDGET (self));
 
+  g_signal_connect_swapped (self->priv->listbox,
+                            "remove",
+                            G_CALLBACK (listbox_remove_cb),
+                            self);
+
   set_active_row (self, GTK_WIDGET (self->priv->new_task_row));
 
   gtk_drag_dest_set (GTK_WIDGET (self->priv->listbox),
@@ -1770,7 +2365,9 @@ gtd_task_list_view_set_list (GtdTaskListView *view,
                              GList           *list)
 {
   GtdTaskListViewPrivate *priv;
+  g_autoptr (GHashTable) new_tasks = NULL;
   GList *l, *old_list;
+  GList *added = NULL;
 
   g_return_if_fail (GTD_IS_TASK_LIST_VIEW (view));
 
@@ -1780,39 +2377,129 @@ gtd_task_list_view_set_list (GtdTaskListView *view,
   /* Reset the DnD parent row */
   gtd_dnd_row_set_row_above (GTD_DND_ROW (priv->dnd_row), NULL);
 
-  /* Remove the tasks that are in the current list, but not in the new list */
+  priv->compact_rows = g_list_length (list) > COMPACT_ROWS_THRESHOLD;
+
+  new_tasks = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+  for (l = list; l != NULL; l = l->next)
+    g_hash_table_add (new_tasks, l->data);
+
+  /*
+   * Remove the tasks that are in the current list, but not in the new list.
+   * This also drops them if they are still waiting to be added, which is
+   * what happens when switching lists before the previous one is complete.
+   */
   for (l = old_list; l != NULL; l = l->next)
     {
-      if (!g_list_find (list, l->data))
-        remove_task (view, l->data);
+      if (g_hash_table_contains (new_tasks, l->data))
+        continue;
+
+      remove_task (view, l->data);
+      untrack_task (view, l->data);
     }
 
-  /* Add the tasks that are in the new list, but not in the current list */
+  /* Queue the tasks that are in the new list, but not in the current list */
   for (l = list; l != NULL; l = l->next)
     {
-      if (g_list_find (old_list, l->data))
+      if (!track_task (view, l->data))
         continue;
 
-      gtd_task_list_view__add_task (view, l->data);
-
-      g_signal_connect (l->data,
-                        "notify::complete",
-                        G_CALLBACK (task_completed_cb),
-                        view);
+      added = g_list_prepend (added, l->data);
+      g_hash_table_add (priv->pending_tasks, l->data);
     }
 
+  start_population (view, added);
+
   g_list_free (old_list);
   priv->list = g_list_copy (list);
 
-  /* Update the completed tasks counter */
-  priv->complete_tasks = 0;
+  gtd_task_list_view__update_done_label (view);
 
-  for (l = list; l != NULL; l = l->next)
-    priv->complete_tasks += gtd_task_get_complete (l->data);
+  /* Check if it should show the empty state */
+  gtd_task_list_view__update_empty_state (view);
+}
+
+/**
+ * gtd_task_list_view_add_task:
+ * @view: a #GtdTaskListView
+ * @task: a #GtdTask
+ *
+ * Adds @task to the tasks shown by @view. Unlike gtd_task_list_view_set_list(),
+ * the cost doesn't depend on the number of tasks already in @view. The row
+ * of @task is created shortly after, together with the rows of the other
+ * tasks added meanwhile.
+ */
+void
+gtd_task_list_view_add_task (GtdTaskListView *view,
+                             GtdTask         *task)
+{
+  GtdTaskListViewPrivate *priv;
+
+  g_return_if_fail (GTD_IS_TASK_LIST_VIEW (view));
+  g_return_if_fail (GTD_IS_TASK (task));
+
+  priv = view->priv;
+
+  if (!track_task (view, task))
+    return;
+
+  priv->list = g_list_prepend (priv->list, task);
+  priv->compact_rows = g_hash_table_size (priv->tasks) > COMPACT_ROWS_THRESHOLD;
+
+  g_hash_table_add (priv->pending_tasks, task);
+  priv->incoming_tasks = g_list_prepend (priv->incoming_tasks, task);
+
+  if (priv->populate_id == 0)
+    {
+      priv->populate_id = g_idle_add_full (GDK_PRIORITY_REDRAW + 10,
+                                           populate_idle_cb,
+                                           view,
+                                           NULL);
+    }
 
   gtd_task_list_view__update_done_label (view);
+  gtd_task_list_view__update_empty_state (view);
+}
 
-  /* Check if it should show the empty state */
+/**
+ * gtd_task_list_view_remove_task:
+ * @view: a #GtdTaskListView
+ * @task: a #GtdTask
+ *
+ * Removes @task from the tasks shown by @view. The task itself is not
+ * removed from its list.
+ */
+void
+gtd_task_list_view_remove_task (GtdTaskListView *view,
+                                GtdTask         *task)
+{
+  GtdTaskListViewPrivate *priv;
+
+  g_return_if_fail (GTD_IS_TASK_LIST_VIEW (view));
+  g_return_if_fail (GTD_IS_TASK (task));
+
+  priv = view->priv;
+
+  if (!untrack_task (view, task))
+    return;
+
+  priv->list = g_list_remove (priv->list, task);
+
+  /* Tasks that are still waiting don't have a row yet */
+  if (!g_hash_table_remove (priv->pending_tasks, task) && !priv->clearing_completed)
+    gtd_task_list_view__remove_row_for_task (view, task);
+
+  if (task == gtd_edit_pane_get_task (priv->edit_pane))
+    {
+      gtk_revealer_set_reveal_child (priv->edit_revealer, FALSE);
+      gtd_edit_pane_set_task (priv->edit_pane, NULL);
+    }
+
+  /* Clearing completed tasks updates everything at once */
+  if (priv->clearing_completed)
+    return;
+
+  gtd_task_list_view__update_done_label (view);
   gtd_task_list_view__update_empty_state (view);
 }
 
@@ -1877,9 +2564,6 @@ gtd_task_list_view_set_task_list (GtdTaskListView *view,
                                   GtdTaskList     *list)
 {
   GtdTaskListViewPrivate *priv = view->priv;
-  GdkRGBA *color;
-  gchar *color_str;
-  gchar *parsed_css;
   GList *task_list;
 
   g_return_if_fail (GTD_IS_TASK_LIST_VIEW (view));
@@ -1911,24 +2595,7 @@ gtd_task_list_view_set_task_list (GtdTaskListView *view,
       return;
     }
 
-  /* Add the color to provider */
-  color = gtd_task_list_get_color (list);
-  color_str = gdk_rgba_to_string (color);
-
-  parsed_css = g_strdup_printf (COLOR_TEMPLATE, color_str);
-
-  g_debug ("setting style for provider: %s", parsed_css);
-
-  gtk_css_provider_load_from_data (priv->color_provider,
-                                   parsed_css,
-                                   -1,
-                                   NULL);
-
-  g_free (parsed_css);
-  gdk_rgba_free (color);
-  g_free (color_str);
-
-  update_font_color (view);
+  gtd_task_list_view__color_changed (view);
 
   /* Add the tasks from the list */
   task_list = gtd_task_list_get_tasks (list);
@@ -1955,6 +2622,10 @@ gtd_task_list_view_set_task_list (GtdTaskListView *view,
                             G_CALLBACK (gtk_list_box_invalidate_sort),
                             priv->listbox);
 
+  /* Older completed tasks may not be loaded yet */
+  if (priv->show_completed)
+    gtd_task_list_load_completed_tasks (list);
+
   set_active_row (view, GTK_WIDGET (priv->new_task_row));
 }
 
@@ -2129,6 +2800,10 @@ gtd_task_list_view_set_show_completed (GtdTaskListView *view,
             }
 
             g_list_free (list_of_tasks);
+
+          /* Older completed tasks are added through ::task-added when loaded */
+          if (priv->task_list)
+            gtd_task_list_load_completed_tasks (priv->task_list);
         }
       else
         {
@@ -2229,7 +2904,7 @@ gtd_task_list_view_set_sort_func (GtdTaskListView         *view,
   if (func)
     {
       priv->sort_func = func;
-      priv->header_user_data = user_data;
+      priv->sort_user_data = user_data;
 
       gtk_list_box_set_sort_func (priv->listbox,
                                   (GtkListBoxSortFunc) internal_sort_func,
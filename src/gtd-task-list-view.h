@@ -47,13 +47,14 @@ typedef void (*GtdTaskListViewHeaderFunc) (GtkListBoxRow        *row,
 
 /**
  * GtdTaskListViewSortFunc:
- * @row1: the current #GtkListBoxRow
+ * @row1: (nullable): the current #GtkListBoxRow
  * @row1_task: the #GtdTask that @row represents
- * @row2: the #GtkListBoxRow before @row
+ * @row2: (nullable): the #GtkListBoxRow before @row
  * @row2_task: the #GtdTask that @before represents
  * @user_data: (closure): user data
  *
- * The sorting function called on every task.
+ * The sorting function called on every task. The rows are %NULL
+ * when tasks are sorted before their rows are created.
  */
 typedef gint (*GtdTaskListViewSortFunc)   (GtkListBoxRow        *row1,
                                            GtdTask              *row1_task,
@@ -68,6 +69,12 @@ GList*                    gtd_task_list_view_get_list           (GtdTaskListView
 void                      gtd_task_list_view_set_list           (GtdTaskListView        *view,
                                                                  GList                  *list);
 
+void                      gtd_task_list_view_add_task           (GtdTaskListView        *view,
+                                                                 GtdTask                *task);
+
+void                      gtd_task_list_view_remove_task        (GtdTaskListView        *view,
+                                                                 GtdTask                *task);
+
 GtdTaskList*              gtd_task_list_view_get_task_list      (GtdTaskListView        *view);
 
 void                      gtd_task_list_view_set_task_list      (GtdTaskListView        *view,
@@ -50,6 +50,7 @@ typedef struct
   GPtrArray           *pending_subtasks;
 
   gchar               *name;
+  guint                generation;
   gboolean             removable : 1;
 } GtdTaskListPrivate;
 
@@ -160,11 +161,30 @@ process_pending_subtasks (GtdTaskList *self,
   e_cal_component_free_id (id);
 }
 
+static gboolean
+uid_points_to_task (gpointer key,
+                    gpointer value,
+                    gpointer user_data)
+{
+  return value == user_data;
+}
+
 static void
 task_changed_cb (GtdTask     *task,
                  GParamSpec  *pspec,
                  GtdTaskList *self)
 {
+  GtdTaskListPrivate *priv = gtd_task_list_get_instance_private (self);
+
+  priv->generation++;
+
+  /* Keep the task reachable by its new UID, e.g. after it's created */
+  if (g_strcmp0 (g_param_spec_get_name (pspec), "uid") == 0)
+    {
+      g_hash_table_foreach_remove (priv->uid_to_task, uid_points_to_task, task);
+      g_hash_table_insert (priv->uid_to_task, g_strdup (gtd_object_get_uid (GTD_OBJECT (task))), task);
+    }
+
   g_signal_emit (self, signals[TASK_UPDATED], 0, task);
 }
 
@@ -456,6 +476,7 @@ gtd_task_list_set_color (GtdTaskList   *list,
     {
       g_clear_pointer (&priv->color, gdk_rgba_free);
       priv->color = gdk_rgba_copy (color);
+      priv->generation++;
 
       g_object_notify (G_OBJECT (list), "color");
     }
@@ -571,6 +592,28 @@ gtd_task_list_get_tasks (GtdTaskList *list)
   return g_list_copy (priv->tasks);
 }
 
+/**
+ * gtd_task_list_get_generation:
+ * @list: a #GtdTaskList
+ *
+ * Retrieves a counter that changes whenever the tasks of @list, or
+ * any of their properties, change. It can be used to tell whether
+ * something derived from the tasks needs to be built again.
+ *
+ * Returns: the current generation of @list
+ */
+guint
+gtd_task_list_get_generation (GtdTaskList *list)
+{
+  GtdTaskListPrivate *priv;
+
+  g_return_val_if_fail (GTD_IS_TASK_LIST (list), 0);
+
+  priv = gtd_task_list_get_instance_private (list);
+
+  return priv->generation;
+}
+
 /**
  * gtd_task_list_save_task:
  * @list: a #GtdTaskList
@@ -588,6 +631,7 @@ gtd_task_list_save_task (GtdTaskList *list,
   g_assert (GTD_IS_TASK (task));
 
   priv = gtd_task_list_get_instance_private (list);
+  priv->generation++;
 
   if (gtd_task_list_contains (list, task))
     {
@@ -642,6 +686,7 @@ gtd_task_list_remove_task (GtdTaskList *list,
                                         list);
 
   priv->tasks = g_list_remove (priv->tasks, task);
+  priv->generation++;
 
   g_hash_table_remove (priv->uid_to_task, gtd_object_get_uid (GTD_OBJECT (task)));
 
@@ -671,6 +716,28 @@ gtd_task_list_contains (GtdTaskList *list,
   return g_list_find (priv->tasks, task) != NULL;
 }
 
+/**
+ * gtd_task_list_get_task_by_id:
+ * @list: a #GtdTaskList
+ * @id: the unique identifier of the task
+ *
+ * Retrieves the task of @list whose component UID is @id.
+ *
+ * Returns: (transfer none)(nullable): a #GtdTask, or %NULL
+ */
+GtdTask*
+gtd_task_list_get_task_by_id (GtdTaskList *list,
+                              const gchar *id)
+{
+  GtdTaskListPrivate *priv;
+
+  g_return_val_if_fail (GTD_IS_TASK_LIST (list), NULL);
+
+  priv = gtd_task_list_get_instance_private (list);
+
+  return g_hash_table_lookup (priv->uid_to_task, id);
+}
+
 /**
  * gtd_task_list_get_is_removable:
  * @list: a #GtdTaskList
@@ -715,3 +782,23 @@ gtd_task_list_set_is_removable (GtdTaskList *list,
       g_object_notify (G_OBJECT (list), "is-removable");
     }
 }
+
+/**
+ * gtd_task_list_load_completed_tasks:
+ * @list: a #GtdTaskList
+ *
+ * Asks @list to load the completed tasks it may have skipped when
+ * loading. Providers are allowed to load only recently completed
+ * tasks at first; older ones are added to @list afterwards through
+ * the usual #GtdTaskList::task-added signal.
+ *
+ * Lists that always load all of their tasks do nothing.
+ */
+void
+gtd_task_list_load_completed_tasks (GtdTaskList *list)
+{
+  g_return_if_fail (GTD_IS_TASK_LIST (list));
+
+  if (GTD_TASK_LIST_GET_CLASS (list)->load_completed_tasks)
+    GTD_TASK_LIST_GET_CLASS (list)->load_completed_tasks (list);
+}
@@ -44,7 +44,9 @@ struct _GtdTaskListClass
   void                  (*task_removed)                         (GtdTaskList            *list,
                                                                  GtdTask                *task);
 
-  gpointer              padding[10];
+  void                  (*load_completed_tasks)                 (GtdTaskList            *list);
+
+  gpointer              padding[9];
 };
 
 GtdTaskList*            gtd_task_list_new                       (GtdProvider            *provider);
@@ -71,6 +73,8 @@ void                    gtd_task_list_set_provider              (GtdTaskList
 
 GList*                  gtd_task_list_get_tasks                 (GtdTaskList            *list);
 
+guint                   gtd_task_list_get_generation            (GtdTaskList            *list);
+
 void                    gtd_task_list_save_task                 (GtdTaskList            *list,
                                                                  GtdTask                *task);
 
@@ -80,6 +84,11 @@ void                    gtd_task_list_remove_task               (GtdTaskList
 gboolean                gtd_task_list_contains                  (GtdTaskList            *list,
                                                                  GtdTask                *task);
 
+GtdTask*                gtd_task_list_get_task_by_id            (GtdTaskList            *list,
+                                                                 const gchar            *id);
+
+void                    gtd_task_list_load_completed_tasks      (GtdTaskList            *list);
+
 G_END_DECLS
 
 #endif /* GTD_TASK_LIST_H */
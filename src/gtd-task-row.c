@@ -16,15 +16,25 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "gtd-manager.h"
 #include "gtd-provider.h"
 #include "gtd-task-row.h"
 #include "gtd-task.h"
 #include "gtd-task-list.h"
 #include "gtd-task-list-view.h"
+#include "gtd-timer.h"
 
 #include <glib/gi18n.h>
 #include <gtk/gtk.h>
 
+/* Parts of a compact row that react to the pointer, see gtd_task_row__draw_compact() */
+typedef enum
+{
+  HIT_AREA_NONE,
+  HIT_AREA_DND,
+  HIT_AREA_CHECK
+} HitArea;
+
 struct _GtdTaskRow
 {
   GtkListBoxRow      parent;
@@ -58,11 +68,46 @@ struct _GtdTaskRow
   gint                       destroy_row_timeout_id;
 
   gboolean                   active;
+
+  /* compact mode */
+  gboolean                   compact;
+  gboolean                   inflated;
+  gboolean                   dragging;
+  GdkWindow                 *event_window;
+  HitArea                    pressed_area;
+  HitArea                    hovered_area;
+  guint                      deflate_idle_id;
+  GPtrArray                 *bindings;
+  gboolean                   show_due_date;
+  gboolean                   show_list_name;
+  PangoLayout               *title_layout;
+  PangoLayout               *date_layout;
+  PangoLayout               *list_layout;
+  GtkSizeGroup              *name_group;
+
+  /* Day of the due date label, see due_date_day */
+  guint                      date_day;
+
+  /* Layouts were built for this style_serial */
+  guint                      style_serial;
 };
 
 #define PRIORITY_ICON_SIZE         8
 #define DND_ICON_SCALE             0.85
 
+/*
+ * Geometry of the template, mirrored by compact rows so both kinds
+ * of rows line up.
+ */
+#define ROW_BORDER                 6
+#define ROW_MARGIN                 18
+#define ROW_SPACING                12
+#define DND_ICON_SIZE              12
+#define DATE_MARGIN                6
+#define DEPTH_INDENT               32
+#define LIST_NAME_MAX_CHARS        18
+#define DIM_LABEL_OPACITY          0.55
+
 G_DEFINE_TYPE (GtdTaskRow, gtd_task_row, GTK_TYPE_LIST_BOX_ROW)
 
 enum {
@@ -73,6 +118,7 @@ enum {
 
 enum {
   PROP_0,
+  PROP_COMPACT,
   PROP_HANDLE_SUBTASKS,
   PROP_TASK,
   LAST_PROP
@@ -87,17 +133,27 @@ typedef enum
 
 static guint signals[NUM_SIGNALS] = { 0, };
 
+static void          queue_deflate                               (GtdTaskRow         *self);
+static void          update_event_window                         (GtdTaskRow         *self);
+
 static void
-set_dnd_cursor (GtkWidget  *widget,
+set_dnd_cursor (GtdTaskRow *self,
                 CursorType  type)
 {
   GdkDisplay *display;
   GdkCursor *cursor;
+  GdkWindow *window;
+
+  /* Compact rows receive the pointer in their own input window */
+  if (self->inflated)
+    window = gtk_widget_get_window (self->dnd_event_box);
+  else
+    window = self->event_window;
 
-  if (!gtk_widget_get_realized (widget))
+  if (!window)
     return;
 
-  display = gtk_widget_get_display (widget);
+  display = gdk_window_get_display (window);
 
   switch (type)
     {
@@ -117,7 +173,7 @@ set_dnd_cursor (GtkWidget  *widget,
       cursor = NULL;
     }
 
-  gdk_window_set_cursor (gtk_widget_get_window (widget), cursor);
+  gdk_window_set_cursor (window, cursor);
   gdk_display_flush (display);
 
   g_clear_object (&cursor);
@@ -132,12 +188,20 @@ get_dnd_icon (GtdTaskRow *self)
   gint real_x;
 
   widget = GTK_WIDGET (self);
-  gtk_widget_translate_coordinates (self->dnd_event_box,
-                                    gtk_widget_get_parent (widget),
-                                    0,
-                                    0,
-                                    &real_x,
-                                    NULL);
+
+  if (self->inflated)
+    {
+      gtk_widget_translate_coordinates (self->dnd_event_box,
+                                        gtk_widget_get_parent (widget),
+                                        0,
+                                        0,
+                                        &real_x,
+                                        NULL);
+    }
+  else
+    {
+      gdk_window_get_position (self->event_window, &real_x, NULL);
+    }
 
   /* Make it transparent */
   surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32,
@@ -161,7 +225,7 @@ mouse_out_event (GtkWidget  *widget,
                  GdkEvent   *event,
                  GtdTaskRow *self)
 {
-  set_dnd_cursor (widget, CURSOR_NONE);
+  set_dnd_cursor (self, CURSOR_NONE);
 
   return GDK_EVENT_STOP;
 }
@@ -171,7 +235,7 @@ mouse_over_event (GtkWidget  *widget,
                   GdkEvent   *event,
                   GtdTaskRow *self)
 {
-  set_dnd_cursor (widget, CURSOR_GRAB);
+  set_dnd_cursor (self, CURSOR_GRAB);
 
   return GDK_EVENT_STOP;
 }
@@ -196,7 +260,8 @@ drag_begin_cb (GtkWidget      *widget,
 
   surface = get_dnd_icon (self);
 
-  set_dnd_cursor (widget, CURSOR_GRABBING);
+  self->dragging = TRUE;
+  set_dnd_cursor (self, CURSOR_GRABBING);
 
   gtk_drag_set_icon_surface (context, surface);
 
@@ -216,6 +281,17 @@ drag_failed_cb (GtkWidget	*widget,
   return FALSE;
 }
 
+static void
+drag_end_cb (GtkWidget      *widget,
+             GdkDragContext *context,
+             GtdTaskRow     *self)
+{
+  self->dragging = FALSE;
+  set_dnd_cursor (self, CURSOR_NONE);
+
+  queue_deflate (self);
+}
+
 static void
 gtd_task_row__priority_changed_cb (GtdTaskRow *row,
                                    GParamSpec *spec,
@@ -269,6 +345,9 @@ complete_changed_cb (GtdTaskRow *self,
     gtk_style_context_add_class (context, "complete");
   else
     gtk_style_context_remove_class (context, "complete");
+
+  /* Compact rows strike the title through themselves */
+  g_clear_object (&self->title_layout);
 }
 
 static void
@@ -315,23 +394,22 @@ depth_changed_cb (GtdTaskRow *self,
                   GParamSpec *pspec,
                   GtdTask    *task)
 {
+  if (!self->inflated)
+    {
+      update_event_window (self);
+      gtk_widget_queue_draw (GTK_WIDGET (self));
+      return;
+    }
+
   gtk_widget_set_margin_start (self->dnd_box,
-                               self->handle_subtasks ? 32 * gtd_task_get_depth (task) : 0);
+                               self->handle_subtasks ? DEPTH_INDENT * gtd_task_get_depth (task) : 0);
 }
 
-static gboolean
-gtd_task_row__date_changed_binding (GBinding     *binding,
-                                    const GValue *from_value,
-                                    GValue       *to_value,
-                                    gpointer      user_data)
+static gchar*
+format_due_date (GDateTime *dt)
 {
-  GDateTime *dt;
   gchar *new_label = NULL;
 
-  g_return_val_if_fail (GTD_IS_TASK_ROW (user_data), FALSE);
-
-  dt = g_value_get_boxed (from_value);
-
   if (dt)
     {
       GDateTime *today = g_date_time_new_now_local ();
@@ -374,11 +452,715 @@ gtd_task_row__date_changed_binding (GBinding     *binding,
       new_label = g_strdup (_("No date set"));
     }
 
-  g_value_set_string (to_value, new_label);
+  return new_label;
+}
+
+/*
+ * Due date labels
+ *
+ * Labels are relative to today, so each date is formatted once per day
+ * and the label is shared by all the rows. When the day changes, only
+ * the mapped rows are refreshed right away; the others catch up when
+ * they are mapped again.
+ */
+static GHashTable *due_date_labels = NULL;
+static GHashTable *mapped_rows = NULL;
+static guint due_date_day = 1;
+
+static void          update_due_date                             (GtdTaskRow         *self);
+
+static void
+due_date_day_changed_cb (GtdTimer *timer)
+{
+  GHashTableIter iter;
+  gpointer row;
+
+  g_hash_table_remove_all (due_date_labels);
+  due_date_day++;
+
+  g_hash_table_iter_init (&iter, mapped_rows);
+
+  while (g_hash_table_iter_next (&iter, &row, NULL))
+    update_due_date (row);
+}
+
+static void
+ensure_due_date_labels (void)
+{
+  if (due_date_labels)
+    return;
+
+  /* Date, as YYYYMMDD → label */
+  due_date_labels = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, g_free);
+  mapped_rows = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+  g_signal_connect (gtd_manager_get_timer (gtd_manager_get_default ()),
+                    "update",
+                    G_CALLBACK (due_date_day_changed_cb),
+                    NULL);
+}
+
+static const gchar*
+get_due_date_label (GDateTime *dt)
+{
+  gchar *label;
+  guint key;
+
+  if (!dt)
+    return _("No date set");
+
+  ensure_due_date_labels ();
+
+  key = g_date_time_get_year (dt) * 10000 +
+        g_date_time_get_month (dt) * 100 +
+        g_date_time_get_day_of_month (dt);
+
+  label = g_hash_table_lookup (due_date_labels, GUINT_TO_POINTER (key));
+
+  if (!label)
+    {
+      label = format_due_date (dt);
+      g_hash_table_insert (due_date_labels, GUINT_TO_POINTER (key), label);
+    }
+
+  return label;
+}
+
+static void
+update_due_date (GtdTaskRow *self)
+{
+  g_autoptr (GDateTime) dt = NULL;
+
+  if (!self->task)
+    return;
+
+  self->date_day = due_date_day;
+
+  /* Compact rows build the layout again when drawn */
+  if (!self->inflated)
+    {
+      g_clear_object (&self->date_layout);
+      gtk_widget_queue_draw (GTK_WIDGET (self));
+      return;
+    }
+
+  dt = gtd_task_get_due_date (self->task);
+
+  gtk_label_set_label (self->task_date_label, get_due_date_label (dt));
+}
+
+/*
+ * Compact rows
+ *
+ * Building the template of every row is expensive for long lists, so
+ * compact rows start without any child widget and draw the check, the
+ * title, the due date and the list name themselves, from layouts that
+ * are only rebuilt when the task changes. A single ::notify handler on
+ * the task keeps them up to date.
+ *
+ * Clicking the check and dragging the DnD icon are handled by an input
+ * window over them, so the template is only built, and the task bound
+ * to it, the first time the row is focused or edited. Once the focus
+ * leaves the row, unless it is still being edited or dragged, the
+ * widgets are hidden and unbound from the task, and the row draws
+ * itself again.
+ */
+
+/*
+ * Shared by all compact rows, and dropped when the theme or the fonts
+ * change. Rows drop their own layouts when they see a new style_serial.
+ */
+static GtkStyleContext *check_context = NULL;
+static GtkSettings *style_settings = NULL;
+static gint title_height = 0;
+static guint style_serial = 1;
+
+static void
+shared_style_changed_cb (GtkSettings *settings,
+                         GParamSpec  *pspec,
+                         gpointer     user_data)
+{
+  g_clear_object (&check_context);
+  title_height = 0;
+  style_serial++;
+}
+
+static void
+ensure_shared_style (GtkWidget *widget)
+{
+  GtkSettings *settings;
+
+  settings = gtk_widget_get_settings (widget);
+
+  if (settings == style_settings)
+    return;
+
+  if (style_settings)
+    g_signal_handlers_disconnect_by_func (style_settings, shared_style_changed_cb, NULL);
+
+  /* Settings belong to the screen, and live as long as it */
+  style_settings = settings;
+
+  g_signal_connect (settings, "notify::gtk-theme-name", G_CALLBACK (shared_style_changed_cb), NULL);
+  g_signal_connect (settings, "notify::gtk-font-name", G_CALLBACK (shared_style_changed_cb), NULL);
+  g_signal_connect (settings, "notify::gtk-application-prefer-dark-theme", G_CALLBACK (shared_style_changed_cb), NULL);
+
+  shared_style_changed_cb (settings, NULL, NULL);
+}
+
+static GtkStyleContext*
+get_check_style_context (GtkWidget *widget)
+{
+  ensure_shared_style (widget);
+
+  if (!check_context)
+    {
+      GtkWidgetPath *path;
+
+      /* A neutral path, so no row's classes leak into the others */
+      path = gtk_widget_path_new ();
+
+      gtk_widget_path_append_type (path, GTK_TYPE_WINDOW);
+      gtk_widget_path_iter_set_object_name (path, -1, "window");
+      gtk_widget_path_append_type (path, GTK_TYPE_LIST_BOX);
+      gtk_widget_path_iter_set_object_name (path, -1, "list");
+      gtk_widget_path_append_type (path, GTD_TYPE_TASK_ROW);
+      gtk_widget_path_iter_set_object_name (path, -1, "taskrow");
+      gtk_widget_path_append_type (path, GTK_TYPE_CHECK_BUTTON);
+      gtk_widget_path_iter_set_object_name (path, -1, "checkbutton");
+      gtk_widget_path_append_type (path, GTK_TYPE_CHECK_BUTTON);
+      gtk_widget_path_iter_set_object_name (path, -1, "check");
+
+      check_context = gtk_style_context_new ();
+      gtk_style_context_set_path (check_context, path);
+      gtk_style_context_set_screen (check_context, gtk_widget_get_screen (widget));
+
+      gtk_widget_path_unref (path);
+    }
+
+  return check_context;
+}
+
+static gint
+get_check_size (GtkStyleContext *context)
+{
+  gint size = 0;
+
+  gtk_style_context_get (context,
+                         gtk_style_context_get_state (context),
+                         "min-width", &size,
+                         NULL);
+
+  return size > 0 ? size : 16;
+}
+
+/* The title is shown in a stack together with an entry, which sets the row height */
+static gint
+get_title_height (GtkWidget *widget)
+{
+  ensure_shared_style (widget);
+
+  if (title_height == 0)
+    {
+      GtkWidget *entry;
+
+      entry = g_object_ref_sink (gtk_entry_new ());
+      gtk_widget_get_preferred_height (entry, NULL, &title_height);
+
+      gtk_widget_destroy (entry);
+      g_object_unref (entry);
+    }
+
+  return title_height;
+}
+
+static PangoLayout*
+get_title_layout (GtdTaskRow *self)
+{
+  if (!self->title_layout)
+    {
+      self->title_layout = gtk_widget_create_pango_layout (GTK_WIDGET (self), gtd_task_get_title (self->task));
+      pango_layout_set_ellipsize (self->title_layout, PANGO_ELLIPSIZE_END);
+
+      if (gtd_task_get_complete (self->task))
+        {
+          PangoAttrList *attrs;
+
+          attrs = pango_attr_list_new ();
+          pango_attr_list_insert (attrs, pango_attr_strikethrough_new (TRUE));
+
+          pango_layout_set_attributes (self->title_layout, attrs);
+
+          pango_attr_list_unref (attrs);
+        }
+    }
+
+  return self->title_layout;
+}
+
+static PangoLayout*
+get_date_layout (GtdTaskRow *self)
+{
+  if (!self->date_layout)
+    {
+      g_autoptr (GDateTime) dt = NULL;
+
+      dt = gtd_task_get_due_date (self->task);
+
+      self->date_layout = gtk_widget_create_pango_layout (GTK_WIDGET (self), get_due_date_label (dt));
+      self->date_day = due_date_day;
+    }
+
+  return self->date_layout;
+}
+
+static PangoLayout*
+get_list_layout (GtdTaskRow *self)
+{
+  if (!self->list_layout)
+    {
+      PangoFontMetrics *metrics;
+      PangoContext *context;
+
+      self->list_layout = gtk_widget_create_pango_layout (GTK_WIDGET (self),
+                                                          gtd_task_list_get_name (gtd_task_get_list (self->task)));
+
+      context = gtk_widget_get_pango_context (GTK_WIDGET (self));
+      metrics = pango_context_get_metrics (context,
+                                           pango_context_get_font_description (context),
+                                           pango_context_get_language (context));
+
+      pango_layout_set_width (self->list_layout,
+                              LIST_NAME_MAX_CHARS * pango_font_metrics_get_approximate_char_width (metrics));
+      pango_layout_set_ellipsize (self->list_layout, PANGO_ELLIPSIZE_MIDDLE);
+
+      pango_font_metrics_unref (metrics);
+    }
+
+  return self->list_layout;
+}
+
+/* Left edge of the DnD icon, or of the check when there is no DnD icon */
+static gint
+get_content_x (GtdTaskRow *self)
+{
+  gint x;
+
+  x = ROW_MARGIN + ROW_BORDER;
+
+  if (self->handle_subtasks && self->task)
+    x += DEPTH_INDENT * gtd_task_get_depth (self->task);
+
+  return x;
+}
+
+static gint
+get_check_x (GtdTaskRow *self)
+{
+  gint x;
+
+  x = get_content_x (self);
+
+  if (self->handle_subtasks)
+    x += DND_ICON_SIZE + ROW_SPACING;
+
+  return x;
+}
+
+/* The input window covers the DnD icon and the check */
+static void
+update_event_window (GtdTaskRow *self)
+{
+  GtkAllocation allocation;
+  gint check_size;
+  gint x;
+
+  if (!self->event_window)
+    return;
+
+  gtk_widget_get_allocation (GTK_WIDGET (self), &allocation);
+
+  check_size = get_check_size (get_check_style_context (GTK_WIDGET (self)));
+  x = get_content_x (self) - ROW_SPACING / 2;
+
+  gdk_window_move_resize (self->event_window,
+                          allocation.x + x,
+                          allocation.y,
+                          get_check_x (self) + check_size + ROW_SPACING / 2 - x,
+                          allocation.height);
+}
+
+/* @x and @y are relative to the input window */
+static HitArea
+get_hit_area (GtdTaskRow *self,
+              gdouble     x,
+              gdouble     y)
+{
+  if (x < 0 || x >= gdk_window_get_width (self->event_window) ||
+      y < 0 || y >= gdk_window_get_height (self->event_window))
+    {
+      return HIT_AREA_NONE;
+    }
+
+  x += get_content_x (self) - ROW_SPACING / 2;
+
+  if (self->handle_subtasks && x < get_check_x (self) - ROW_SPACING / 2)
+    return HIT_AREA_DND;
+
+  return HIT_AREA_CHECK;
+}
+
+static void
+clear_layouts (GtdTaskRow *self)
+{
+  g_clear_object (&self->title_layout);
+  g_clear_object (&self->date_layout);
+  g_clear_object (&self->list_layout);
+}
+
+static void
+render_dim_layout (GtkStyleContext *context,
+                   cairo_t         *cr,
+                   gdouble          x,
+                   gdouble          y,
+                   PangoLayout     *layout)
+{
+  cairo_push_group (cr);
+  gtk_render_layout (context, cr, x, y, layout);
+  cairo_pop_group_to_source (cr);
+  cairo_paint_with_alpha (cr, DIM_LABEL_OPACITY);
+}
+
+static void
+render_dnd_icon (GtdTaskRow *self,
+                 cairo_t    *cr,
+                 gdouble     x,
+                 gdouble     y)
+{
+  GtkStyleContext *context;
+  cairo_surface_t *surface;
+  GtkIconInfo *info;
+  GtkWidget *widget;
+  GdkPixbuf *pixbuf;
+  gint scale;
+
+  widget = GTK_WIDGET (self);
+  context = gtk_widget_get_style_context (widget);
+  scale = gtk_widget_get_scale_factor (widget);
+
+  /* The icon theme caches the lookup and the recolored icon */
+  info = gtk_icon_theme_lookup_icon_for_scale (gtk_icon_theme_get_for_screen (gtk_widget_get_screen (widget)),
+                                               "open-menu-symbolic",
+                                               DND_ICON_SIZE,
+                                               scale,
+                                               0);
+
+  if (!info)
+    return;
+
+  pixbuf = gtk_icon_info_load_symbolic_for_context (info, context, NULL, NULL);
+
+  g_object_unref (info);
+
+  if (!pixbuf)
+    return;
+
+  surface = gdk_cairo_surface_create_from_pixbuf (pixbuf, scale, gtk_widget_get_window (widget));
+
+  cairo_push_group (cr);
+  gtk_render_icon_surface (context, cr, surface, x, y);
+  cairo_pop_group_to_source (cr);
+  cairo_paint_with_alpha (cr, DIM_LABEL_OPACITY);
+
+  cairo_surface_destroy (surface);
+  g_object_unref (pixbuf);
+}
+
+static void
+gtd_task_row__draw_compact (GtdTaskRow *self,
+                            cairo_t    *cr)
+{
+  GtkStyleContext *check_context;
+  GtkStyleContext *context;
+  PangoRectangle extents;
+  PangoLayout *layout;
+  GtkWidget *widget;
+  gint check_size;
+  gint height;
+  gint x, right;
+
+  widget = GTK_WIDGET (self);
+  context = gtk_widget_get_style_context (widget);
+  height = gtk_widget_get_allocated_height (widget);
+
+  x = get_content_x (self);
+  right = gtk_widget_get_allocated_width (widget) - ROW_MARGIN - ROW_BORDER;
+
+  /* DnD icon */
+  if (self->handle_subtasks)
+    {
+      render_dnd_icon (self, cr, x, (height - DND_ICON_SIZE) / 2);
+      x += DND_ICON_SIZE + ROW_SPACING;
+    }
+
+  /* Check */
+  check_context = get_check_style_context (widget);
+
+  /* The theme or the fonts changed since the layouts were built */
+  if (self->style_serial != style_serial)
+    {
+      clear_layouts (self);
+      self->style_serial = style_serial;
+    }
+
+  gtk_style_context_save (check_context);
+  gtk_style_context_set_state (check_context,
+                               gtd_task_get_complete (self->task) ? GTK_STATE_FLAG_CHECKED : GTK_STATE_FLAG_NORMAL);
+
+  check_size = get_check_size (check_context);
+
+  gtk_render_background (check_context, cr, x, (height - check_size) / 2, check_size, check_size);
+  gtk_render_frame (check_context, cr, x, (height - check_size) / 2, check_size, check_size);
+  gtk_render_check (check_context, cr, x, (height - check_size) / 2, check_size, check_size);
+
+  gtk_style_context_restore (check_context);
+
+  x += check_size + ROW_SPACING;
+
+  /* List name and due date, right-aligned */
+  if (self->show_list_name)
+    {
+      layout = get_list_layout (self);
+      pango_layout_get_pixel_extents (layout, NULL, &extents);
+
+      right -= extents.width;
+      render_dim_layout (context, cr, right, (height - extents.height) / 2, layout);
+      right -= ROW_SPACING;
+    }
+
+  if (self->show_due_date)
+    {
+      layout = get_date_layout (self);
+      pango_layout_get_pixel_extents (layout, NULL, &extents);
+
+      right -= extents.width + DATE_MARGIN;
+      render_dim_layout (context, cr, right, (height - extents.height) / 2, layout);
+      right -= ROW_SPACING;
+    }
+
+  /* Title */
+  layout = get_title_layout (self);
+  pango_layout_set_width (layout, MAX (right - x, 0) * PANGO_SCALE);
+  pango_layout_get_pixel_extents (layout, NULL, &extents);
+
+  gtk_render_layout (context, cr, x, (height - extents.height) / 2, layout);
+}
+
+static void
+task_notify_cb (GtdTaskRow *self,
+                GParamSpec *pspec,
+                GtdTask    *task)
+{
+  if (g_str_equal (pspec->name, "priority"))
+    gtd_task_row__priority_changed_cb (self, pspec, G_OBJECT (task));
+  else if (g_str_equal (pspec->name, "complete"))
+    complete_changed_cb (self, pspec, task);
+  else if (g_str_equal (pspec->name, "depth"))
+    depth_changed_cb (self, pspec, task);
+  else if (g_str_equal (pspec->name, "title"))
+    g_clear_object (&self->title_layout);
+  else if (g_str_equal (pspec->name, "due-date"))
+    update_due_date (self);
+  else
+    return;
+
+  if (!self->inflated)
+    gtk_widget_queue_draw (GTK_WIDGET (self));
+}
+
+static void
+unbind_task (GtdTaskRow *self)
+{
+  guint i;
+
+  for (i = 0; i < self->bindings->len; i++)
+    g_binding_unbind (g_ptr_array_index (self->bindings, i));
+
+  g_ptr_array_set_size (self->bindings, 0);
+}
+
+static void
+bind_task (GtdTaskRow *row)
+{
+  GtdTask *task = row->task;
+
+  unbind_task (row);
+
+  gtk_label_set_label (row->task_list_label, gtd_task_list_get_name (gtd_task_get_list (task)));
+
+  g_signal_handlers_block_by_func (row->done_check, complete_check_toggled_cb, row);
+
+  g_ptr_array_add (row->bindings,
+                   g_object_bind_property (task,
+                                           "title",
+                                           row->title_entry,
+                                           "text",
+                                           G_BINDING_BIDIRECTIONAL | G_BINDING_SYNC_CREATE));
+
+  g_ptr_array_add (row->bindings,
+                   g_object_bind_property (task,
+                                           "title",
+                                           row->title_label,
+                                           "label",
+                                           G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE));
+
+  g_ptr_array_add (row->bindings,
+                   g_object_bind_property (task,
+                                           "complete",
+                                           row->done_check,
+                                           "active",
+                                           G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE));
+
+  g_ptr_array_add (row->bindings,
+                   g_object_bind_property (task,
+                                           "ready",
+                                           row->task_loading_spinner,
+                                           "visible",
+                                           G_BINDING_INVERT_BOOLEAN | G_BINDING_SYNC_CREATE));
+
+  update_due_date (row);
+
+  depth_changed_cb (row, NULL, task);
+
+  g_signal_handlers_unblock_by_func (row->done_check, complete_check_toggled_cb, row);
+}
+
+/*
+ * Builds the widgets of the row. Compact rows do this when they are
+ * focused or edited, see gtd_task_row__deflate().
+ */
+static void
+gtd_task_row__inflate (GtdTaskRow *self)
+{
+  if (self->inflated)
+    return;
+
+  self->inflated = TRUE;
+  self->pressed_area = HIT_AREA_NONE;
+
+  clear_layouts (self);
+
+  if (self->event_window)
+    {
+      gdk_window_set_cursor (self->event_window, NULL);
+      gdk_window_hide (self->event_window);
+    }
+
+  /* The template is only built once, and then shown and hidden */
+  if (!self->revealer)
+    {
+      gtk_widget_init_template (GTK_WIDGET (self));
+
+      /* The source of DnD is the drag icon */
+      gtk_drag_source_set (self->dnd_event_box,
+                           GDK_BUTTON1_MASK,
+                           NULL,
+                           0,
+                           GDK_ACTION_COPY);
+    }
+  else
+    {
+      gtk_widget_show (GTK_WIDGET (self->revealer));
+    }
+
+  gtk_widget_set_visible (self->dnd_box, self->handle_subtasks);
+  gtk_widget_set_visible (GTK_WIDGET (self->task_date_label), self->show_due_date);
+  gtk_widget_set_visible (GTK_WIDGET (self->task_list_label), self->show_list_name);
+
+  if (self->name_group)
+    {
+      gtk_size_group_add_widget (self->name_group, GTK_WIDGET (self->task_list_label));
+      gtk_size_group_add_widget (self->name_group, GTK_WIDGET (self->task_date_label));
+    }
+
+  if (self->task)
+    bind_task (self);
+
+  /* A compact row was already visible, so don't animate it */
+  if (self->compact)
+    {
+      GtkRevealerTransitionType transition_type;
 
-  g_free (new_label);
+      transition_type = gtk_revealer_get_transition_type (self->revealer);
 
-  return TRUE;
+      gtk_revealer_set_transition_type (self->revealer, GTK_REVEALER_TRANSITION_TYPE_NONE);
+      gtk_revealer_set_reveal_child (self->revealer, TRUE);
+      gtk_revealer_set_transition_type (self->revealer, transition_type);
+    }
+}
+
+/*
+ * Hides the widgets of a compact row, and draws it again. They're kept
+ * around, unbound from the task, for the next time the row is focused.
+ */
+static void
+gtd_task_row__deflate (GtdTaskRow *self)
+{
+  if (!self->inflated)
+    return;
+
+  self->inflated = FALSE;
+
+  unbind_task (self);
+
+  /* The revealer is the only child of the template */
+  gtk_widget_hide (GTK_WIDGET (self->revealer));
+
+  if (self->event_window && gtk_widget_get_mapped (GTK_WIDGET (self)))
+    gdk_window_show (self->event_window);
+
+  gtk_widget_queue_resize (GTK_WIDGET (self));
+}
+
+static gboolean
+deflate_cb (gpointer user_data)
+{
+  GtdTaskRow *self;
+  GtkWidget *toplevel;
+  GtkWidget *focus;
+
+  self = GTD_TASK_ROW (user_data);
+  self->deflate_idle_id = 0;
+
+  if (!self->inflated || self->active || self->dragging)
+    return G_SOURCE_REMOVE;
+
+  /* The row is being hidden, see complete_check_toggled_cb() and gtd_task_row_destroy() */
+  if (!gtk_revealer_get_reveal_child (self->revealer) || self->destroy_row_timeout_id > 0)
+    return G_SOURCE_REMOVE;
+
+  toplevel = gtk_widget_get_toplevel (GTK_WIDGET (self));
+  focus = GTK_IS_WINDOW (toplevel) ? gtk_window_get_focus (GTK_WINDOW (toplevel)) : NULL;
+
+  if (focus && (focus == GTK_WIDGET (self) || gtk_widget_is_ancestor (focus, GTK_WIDGET (self))))
+    return G_SOURCE_REMOVE;
+
+  gtd_task_row__deflate (self);
+
+  return G_SOURCE_REMOVE;
+}
+
+/*
+ * The focus moves in steps, so whether it left the row is only
+ * checked once it settles.
+ */
+static void
+queue_deflate (GtdTaskRow *self)
+{
+  if (!self->compact || !self->inflated || self->deflate_idle_id > 0)
+    return;
+
+  self->deflate_idle_id = g_idle_add (deflate_cb, self);
 }
 
 static gboolean
@@ -397,6 +1179,23 @@ gtd_task_row_new (GtdTask *task)
                        NULL);
 }
 
+/**
+ * gtd_task_row_new_compact:
+ * @task: a #GtdTask
+ *
+ * Creates a compact #GtdTaskRow for @task. See #GtdTaskRow:compact.
+ *
+ * Returns: (transfer full): a new #GtdTaskRow
+ */
+GtkWidget*
+gtd_task_row_new_compact (GtdTask *task)
+{
+  return g_object_new (GTD_TYPE_TASK_ROW,
+                       "compact", TRUE,
+                       "task", task,
+                       NULL);
+}
+
 static gboolean
 gtd_task_row__key_press_event (GtkWidget   *row,
                                GdkEventKey *event)
@@ -422,6 +1221,149 @@ gtd_task_row_focus_in_event (GtkWidget     *widget,
   return GDK_EVENT_PROPAGATE;
 }
 
+static gboolean
+gtd_task_row_focus_out_event (GtkWidget     *widget,
+                              GdkEventFocus *event)
+{
+  queue_deflate (GTD_TASK_ROW (widget));
+
+  return GTK_WIDGET_CLASS (gtd_task_row_parent_class)->focus_out_event (widget, event);
+}
+
+static void
+gtd_task_row_set_focus_child (GtkContainer *container,
+                              GtkWidget    *child)
+{
+  GTK_CONTAINER_CLASS (gtd_task_row_parent_class)->set_focus_child (container, child);
+
+  if (!child)
+    queue_deflate (GTD_TASK_ROW (container));
+}
+
+static gboolean
+gtd_task_row_button_press_event (GtkWidget      *widget,
+                                 GdkEventButton *event)
+{
+  GtdTaskRow *self = GTD_TASK_ROW (widget);
+
+  if (event->window != self->event_window)
+    return GDK_EVENT_PROPAGATE;
+
+  if (event->type == GDK_BUTTON_PRESS && event->button == GDK_BUTTON_PRIMARY)
+    {
+      self->pressed_area = get_hit_area (self, event->x, event->y);
+      self->clicked_x = event->x;
+      self->clicked_y = event->y;
+    }
+
+  /* Don't let the listbox activate the row */
+  return GDK_EVENT_STOP;
+}
+
+static gboolean
+gtd_task_row_button_release_event (GtkWidget      *widget,
+                                   GdkEventButton *event)
+{
+  GtdTaskRow *self = GTD_TASK_ROW (widget);
+
+  if (event->window != self->event_window || event->button != GDK_BUTTON_PRIMARY)
+    return GDK_EVENT_PROPAGATE;
+
+  if (self->pressed_area == HIT_AREA_CHECK &&
+      get_hit_area (self, event->x, event->y) == HIT_AREA_CHECK &&
+      self->task)
+    {
+      gtd_task_set_complete (self->task, !gtd_task_get_complete (self->task));
+    }
+
+  self->pressed_area = HIT_AREA_NONE;
+
+  return GDK_EVENT_STOP;
+}
+
+static gboolean
+gtd_task_row_motion_notify_event (GtkWidget      *widget,
+                                  GdkEventMotion *event)
+{
+  GtdTaskRow *self = GTD_TASK_ROW (widget);
+  GtkTargetList *targets;
+  HitArea area;
+
+  if (event->window != self->event_window)
+    return GDK_EVENT_PROPAGATE;
+
+  if (self->pressed_area != HIT_AREA_DND)
+    {
+      area = get_hit_area (self, event->x, event->y);
+
+      if (area != self->hovered_area)
+        {
+          self->hovered_area = area;
+          set_dnd_cursor (self, area == HIT_AREA_DND ? CURSOR_GRAB : CURSOR_NONE);
+        }
+
+      /* The listbox keeps tracking the hovered row */
+      return GDK_EVENT_PROPAGATE;
+    }
+
+  if (!gtk_drag_check_threshold (widget, self->clicked_x, self->clicked_y, event->x, event->y))
+    return GDK_EVENT_STOP;
+
+  self->pressed_area = HIT_AREA_NONE;
+
+  /* The row itself is the source, see gtd_task_row_drag_begin() */
+  targets = gtk_target_list_new (NULL, 0);
+
+  gtk_drag_begin_with_coordinates (widget,
+                                   targets,
+                                   GDK_ACTION_COPY,
+                                   GDK_BUTTON_PRIMARY,
+                                   (GdkEvent*) event,
+                                   -1,
+                                   -1);
+
+  gtk_target_list_unref (targets);
+
+  return GDK_EVENT_STOP;
+}
+
+static gboolean
+gtd_task_row_leave_notify_event (GtkWidget        *widget,
+                                 GdkEventCrossing *event)
+{
+  GtdTaskRow *self = GTD_TASK_ROW (widget);
+
+  if (event->window == self->event_window && self->hovered_area != HIT_AREA_NONE)
+    {
+      self->hovered_area = HIT_AREA_NONE;
+      set_dnd_cursor (self, CURSOR_NONE);
+    }
+
+  return GDK_EVENT_PROPAGATE;
+}
+
+static void
+gtd_task_row_drag_begin (GtkWidget      *widget,
+                         GdkDragContext *context)
+{
+  drag_begin_cb (widget, context, GTD_TASK_ROW (widget));
+}
+
+static gboolean
+gtd_task_row_drag_failed (GtkWidget      *widget,
+                          GdkDragContext *context,
+                          GtkDragResult   result)
+{
+  return drag_failed_cb (widget, context, result, GTD_TASK_ROW (widget));
+}
+
+static void
+gtd_task_row_drag_end (GtkWidget      *widget,
+                       GdkDragContext *context)
+{
+  drag_end_cb (widget, context, GTD_TASK_ROW (widget));
+}
+
 static void
 gtd_task_row_finalize (GObject *object)
 {
@@ -429,6 +1371,8 @@ gtd_task_row_finalize (GObject *object)
 
   g_clear_object (&self->task);
 
+  g_ptr_array_unref (self->bindings);
+
   G_OBJECT_CLASS (gtd_task_row_parent_class)->finalize (object);
 }
 
@@ -444,18 +1388,19 @@ gtd_task_row_dispose (GObject *object)
   if (task)
     {
       g_signal_handlers_disconnect_by_func (task,
-                                        depth_changed_cb,
-                                        self);
-
-      g_signal_handlers_disconnect_by_func (task,
-                                            complete_changed_cb,
+                                            task_notify_cb,
                                             self);
+    }
 
-      g_signal_handlers_disconnect_by_func (task,
-                                            gtd_task_row__priority_changed_cb,
-                                            self);
+  if (self->deflate_idle_id > 0)
+    {
+      g_source_remove (self->deflate_idle_id);
+      self->deflate_idle_id = 0;
     }
 
+  clear_layouts (self);
+  g_clear_object (&self->name_group);
+
   G_OBJECT_CLASS (gtd_task_row_parent_class)->dispose (object);
 }
 
@@ -469,6 +1414,10 @@ gtd_task_row_get_property (GObject    *object,
 
   switch (prop_id)
     {
+    case PROP_COMPACT:
+      g_value_set_boolean (value, self->compact);
+      break;
+
     case PROP_HANDLE_SUBTASKS:
       g_value_set_boolean (value, self->handle_subtasks);
       break;
@@ -492,6 +1441,10 @@ gtd_task_row_set_property (GObject      *object,
 
   switch (prop_id)
     {
+    case PROP_COMPACT:
+      self->compact = g_value_get_boolean (value);
+      break;
+
     case PROP_HANDLE_SUBTASKS:
       gtd_task_row_set_handle_subtasks (self, g_value_get_boolean (value));
       break;
@@ -505,19 +1458,191 @@ gtd_task_row_set_property (GObject      *object,
     }
 }
 
+static void
+gtd_task_row_constructed (GObject *object)
+{
+  GtdTaskRow *self = GTD_TASK_ROW (object);
+
+  G_OBJECT_CLASS (gtd_task_row_parent_class)->constructed (object);
+
+  if (!self->compact)
+    gtd_task_row__inflate (self);
+}
+
+static gboolean
+gtd_task_row_draw (GtkWidget *widget,
+                   cairo_t   *cr)
+{
+  GtdTaskRow *self = GTD_TASK_ROW (widget);
+
+  GTK_WIDGET_CLASS (gtd_task_row_parent_class)->draw (widget, cr);
+
+  if (!self->inflated && self->task)
+    gtd_task_row__draw_compact (self, cr);
+
+  return GDK_EVENT_PROPAGATE;
+}
+
+static void
+gtd_task_row_get_preferred_height (GtkWidget *widget,
+                                   gint      *minimum,
+                                   gint      *natural)
+{
+  GtdTaskRow *self = GTD_TASK_ROW (widget);
+  gint content_height;
+
+  GTK_WIDGET_CLASS (gtd_task_row_parent_class)->get_preferred_height (widget, minimum, natural);
+
+  if (self->inflated)
+    return;
+
+  content_height = MAX (get_title_height (widget), get_check_size (get_check_style_context (widget)));
+  content_height += 2 * ROW_BORDER;
+
+  *minimum += content_height;
+  *natural += content_height;
+}
+
+static void
+gtd_task_row_size_allocate (GtkWidget     *widget,
+                            GtkAllocation *allocation)
+{
+  GTK_WIDGET_CLASS (gtd_task_row_parent_class)->size_allocate (widget, allocation);
+
+  update_event_window (GTD_TASK_ROW (widget));
+}
+
+static void
+gtd_task_row_realize (GtkWidget *widget)
+{
+  GtdTaskRow *self = GTD_TASK_ROW (widget);
+  GdkWindowAttr attributes = { 0, };
+
+  GTK_WIDGET_CLASS (gtd_task_row_parent_class)->realize (widget);
+
+  attributes.window_type = GDK_WINDOW_CHILD;
+  attributes.wclass = GDK_INPUT_ONLY;
+  attributes.width = 1;
+  attributes.height = 1;
+  attributes.event_mask = gtk_widget_get_events (widget) |
+                          GDK_BUTTON_PRESS_MASK |
+                          GDK_BUTTON_RELEASE_MASK |
+                          GDK_POINTER_MOTION_MASK |
+                          GDK_LEAVE_NOTIFY_MASK;
+
+  self->event_window = gdk_window_new (gtk_widget_get_window (widget), &attributes, 0);
+  gtk_widget_register_window (widget, self->event_window);
+
+  update_event_window (self);
+}
+
+static void
+gtd_task_row_unrealize (GtkWidget *widget)
+{
+  GtdTaskRow *self = GTD_TASK_ROW (widget);
+
+  if (self->event_window)
+    {
+      gtk_widget_unregister_window (widget, self->event_window);
+      gdk_window_destroy (self->event_window);
+      self->event_window = NULL;
+    }
+
+  GTK_WIDGET_CLASS (gtd_task_row_parent_class)->unrealize (widget);
+}
+
+static void
+gtd_task_row_map (GtkWidget *widget)
+{
+  GtdTaskRow *self = GTD_TASK_ROW (widget);
+
+  GTK_WIDGET_CLASS (gtd_task_row_parent_class)->map (widget);
+
+  ensure_due_date_labels ();
+  g_hash_table_add (mapped_rows, self);
+
+  /* The day changed while the row was hidden */
+  if (self->task && self->date_day != due_date_day)
+    update_due_date (self);
+
+  if (!self->inflated)
+    gdk_window_show (self->event_window);
+}
+
+static void
+gtd_task_row_unmap (GtkWidget *widget)
+{
+  GtdTaskRow *self = GTD_TASK_ROW (widget);
+
+  g_hash_table_remove (mapped_rows, widget);
+
+  self->pressed_area = HIT_AREA_NONE;
+  self->hovered_area = HIT_AREA_NONE;
+  gdk_window_hide (self->event_window);
+
+  GTK_WIDGET_CLASS (gtd_task_row_parent_class)->unmap (widget);
+}
+
+static void
+gtd_task_row_screen_changed (GtkWidget *widget,
+                             GdkScreen *previous_screen)
+{
+  if (GTK_WIDGET_CLASS (gtd_task_row_parent_class)->screen_changed)
+    GTK_WIDGET_CLASS (gtd_task_row_parent_class)->screen_changed (widget, previous_screen);
+
+  /* Follows the settings of the new screen */
+  ensure_shared_style (widget);
+}
+
 static void
 gtd_task_row_class_init (GtdTaskRowClass *klass)
 {
   GObjectClass *object_class = G_OBJECT_CLASS (klass);
   GtkWidgetClass *widget_class = GTK_WIDGET_CLASS (klass);
+  GtkContainerClass *container_class = GTK_CONTAINER_CLASS (klass);
 
+  object_class->constructed = gtd_task_row_constructed;
   object_class->dispose = gtd_task_row_dispose;
   object_class->finalize = gtd_task_row_finalize;
   object_class->get_property = gtd_task_row_get_property;
   object_class->set_property = gtd_task_row_set_property;
 
+  widget_class->button_press_event = gtd_task_row_button_press_event;
+  widget_class->button_release_event = gtd_task_row_button_release_event;
+  widget_class->drag_begin = gtd_task_row_drag_begin;
+  widget_class->drag_end = gtd_task_row_drag_end;
+  widget_class->drag_failed = gtd_task_row_drag_failed;
+  widget_class->draw = gtd_task_row_draw;
   widget_class->focus_in_event = gtd_task_row_focus_in_event;
+  widget_class->focus_out_event = gtd_task_row_focus_out_event;
+  widget_class->get_preferred_height = gtd_task_row_get_preferred_height;
   widget_class->key_press_event = gtd_task_row__key_press_event;
+  widget_class->leave_notify_event = gtd_task_row_leave_notify_event;
+  widget_class->map = gtd_task_row_map;
+  widget_class->motion_notify_event = gtd_task_row_motion_notify_event;
+  widget_class->realize = gtd_task_row_realize;
+  widget_class->size_allocate = gtd_task_row_size_allocate;
+  widget_class->unmap = gtd_task_row_unmap;
+  widget_class->screen_changed = gtd_task_row_screen_changed;
+  widget_class->unrealize = gtd_task_row_unrealize;
+
+  container_class->set_focus_child = gtd_task_row_set_focus_child;
+
+  /**
+   * GtdTaskRow::compact:
+   *
+   * Whether the row draws its contents itself while it isn't focused
+   * or edited. Compact rows are much cheaper to create, which matters
+   * for long lists.
+   */
+  g_object_class_install_property (
+          object_class,
+          PROP_COMPACT,
+          g_param_spec_boolean ("compact",
+                                "Whether the row is compact",
+                                "Whether the row draws its contents while it isn't focused or edited",
+                                FALSE,
+                                G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY));
 
   /**
    * GtdTaskRow::handle-subtasks:
@@ -594,6 +1719,7 @@ gtd_task_row_class_init (GtdTaskRowClass *klass)
   gtk_widget_class_bind_template_callback (widget_class, button_press_event);
   gtk_widget_class_bind_template_callback (widget_class, complete_check_toggled_cb);
   gtk_widget_class_bind_template_callback (widget_class, drag_begin_cb);
+  gtk_widget_class_bind_template_callback (widget_class, drag_end_cb);
   gtk_widget_class_bind_template_callback (widget_class, drag_failed_cb);
   gtk_widget_class_bind_template_callback (widget_class, mouse_out_event);
   gtk_widget_class_bind_template_callback (widget_class, mouse_over_event);
@@ -605,15 +1731,14 @@ static void
 gtd_task_row_init (GtdTaskRow *self)
 {
   self->handle_subtasks = TRUE;
-
-  gtk_widget_init_template (GTK_WIDGET (self));
-
-  /* The source of DnD is the drag icon */
-  gtk_drag_source_set (self->dnd_event_box,
-                       GDK_BUTTON1_MASK,
-                       NULL,
-                       0,
-                       GDK_ACTION_COPY);
+  self->show_due_date = TRUE;
+  self->bindings = g_ptr_array_new ();
+
+  /* The template is only built when the row is inflated */
+  gtk_widget_set_size_request (GTK_WIDGET (self), 100, -1);
+  gtk_widget_set_can_focus (GTK_WIDGET (self), TRUE);
+  gtk_list_box_row_set_activatable (GTK_LIST_BOX_ROW (self), TRUE);
+  gtk_list_box_row_set_selectable (GTK_LIST_BOX_ROW (self), FALSE);
 }
 
 /**
@@ -647,75 +1772,39 @@ gtd_task_row_set_task (GtdTaskRow *row,
 {
   g_return_if_fail (GTD_IS_TASK_ROW (row));
 
-  if (g_set_object (&row->task, task))
+  if (row->task == task)
+    return;
+
+  if (row->task)
     {
-      if (task)
-        {
-          gtk_label_set_label (row->task_list_label, gtd_task_list_get_name (gtd_task_get_list (task)));
-
-          g_signal_handlers_block_by_func (row->done_check, complete_check_toggled_cb, row);
-
-          g_object_bind_property (task,
-                                  "title",
-                                  row->title_entry,
-                                  "text",
-                                  G_BINDING_BIDIRECTIONAL | G_BINDING_SYNC_CREATE);
-
-          g_object_bind_property (task,
-                                  "title",
-                                  row->title_label,
-                                  "label",
-                                  G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE);
-
-          g_object_bind_property (task,
-                                  "complete",
-                                  row->done_check,
-                                  "active",
-                                  G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE);
-
-          g_object_bind_property (task,
-                                  "ready",
-                                  row->task_loading_spinner,
-                                  "visible",
-                                  G_BINDING_INVERT_BOOLEAN | G_BINDING_SYNC_CREATE);
-
-          g_object_bind_property_full (task,
-                                       "due-date",
-                                       row->task_date_label,
-                                       "label",
-                                       G_BINDING_DEFAULT | G_BINDING_SYNC_CREATE,
-                                       gtd_task_row__date_changed_binding,
-                                       NULL,
-                                       row,
-                                       NULL);
-
-          /*
-           * Here we generate a false callback call just to reuse the method to
-           * sync the initial state of the priority icon.
-           */
-          gtd_task_row__priority_changed_cb (row, NULL, G_OBJECT (task));
-          g_signal_connect_swapped (task,
-                                    "notify::priority",
-                                    G_CALLBACK (gtd_task_row__priority_changed_cb),
-                                    row);
-
-          complete_changed_cb (row, NULL, task);
-          g_signal_connect_swapped (task,
-                                    "notify::complete",
-                                    G_CALLBACK (complete_changed_cb),
-                                    row);
-
-          depth_changed_cb (row, NULL, task);
-          g_signal_connect_swapped (task,
-                                    "notify::depth",
-                                    G_CALLBACK (depth_changed_cb),
-                                    row);
-
-          g_signal_handlers_unblock_by_func (row->done_check, complete_check_toggled_cb, row);
-        }
+      g_signal_handlers_disconnect_by_func (row->task, task_notify_cb, row);
+      unbind_task (row);
+    }
 
-      g_object_notify (G_OBJECT (row), "task");
+  g_set_object (&row->task, task);
+  clear_layouts (row);
+
+  if (task)
+    {
+      /*
+       * Here we generate a false callback call just to reuse the method to
+       * sync the initial state of the priority icon.
+       */
+      gtd_task_row__priority_changed_cb (row, NULL, G_OBJECT (task));
+      complete_changed_cb (row, NULL, task);
+
+      g_signal_connect_swapped (task,
+                                "notify",
+                                G_CALLBACK (task_notify_cb),
+                                row);
+
+      if (row->inflated)
+        bind_task (row);
     }
+
+  gtk_widget_queue_resize (GTK_WIDGET (row));
+
+  g_object_notify (G_OBJECT (row), "task");
 }
 
 /**
@@ -731,7 +1820,12 @@ gtd_task_row_set_list_name_visible (GtdTaskRow *row,
 {
   g_return_if_fail (GTD_IS_TASK_ROW (row));
 
-  gtk_widget_set_visible (GTK_WIDGET (row->task_list_label), show_list_name);
+  row->show_list_name = show_list_name;
+
+  if (row->inflated)
+    gtk_widget_set_visible (GTK_WIDGET (row->task_list_label), show_list_name);
+  else
+    gtk_widget_queue_draw (GTK_WIDGET (row));
 }
 
 /**
@@ -747,20 +1841,29 @@ gtd_task_row_set_due_date_visible (GtdTaskRow *row,
 {
   g_return_if_fail (GTD_IS_TASK_ROW (row));
 
-  gtk_widget_set_visible (GTK_WIDGET (row->task_date_label), show_due_date);
+  row->show_due_date = show_due_date;
+
+  if (row->inflated)
+    gtk_widget_set_visible (GTK_WIDGET (row->task_date_label), show_due_date);
+  else
+    gtk_widget_queue_draw (GTK_WIDGET (row));
 }
 
 /**
  * gtd_task_row_reveal:
  * @row: a #GtdTaskRow
  *
- * Runs a nifty animation to reveal @row.
+ * Runs a nifty animation to reveal @row. Compact rows are
+ * shown right away.
  */
 void
 gtd_task_row_reveal (GtdTaskRow *row)
 {
   g_return_if_fail (GTD_IS_TASK_ROW (row));
 
+  if (!row->inflated)
+    return;
+
   gtk_revealer_set_reveal_child (row->revealer, TRUE);
 }
 
@@ -775,7 +1878,7 @@ gtd_task_row_destroy (GtdTaskRow *self)
 {
   g_return_if_fail (GTD_IS_TASK_ROW (self));
 
-  if (!gtk_revealer_get_child_revealed (self->revealer))
+  if (!self->inflated || !gtk_revealer_get_child_revealed (self->revealer))
     {
       gtk_widget_destroy (GTK_WIDGET (self));
     }
@@ -811,8 +1914,11 @@ gtd_task_row_set_handle_subtasks (GtdTaskRow *self,
 
   self->handle_subtasks = handle_subtasks;
 
-  gtk_widget_set_visible (self->dnd_box, handle_subtasks);
-  depth_changed_cb (self, NULL, self->task);
+  if (self->inflated)
+    gtk_widget_set_visible (self->dnd_box, handle_subtasks);
+
+  if (self->task)
+    depth_changed_cb (self, NULL, self->task);
 
   g_object_notify (G_OBJECT (self), "handle-subtasks");
 }
@@ -838,14 +1944,18 @@ gtd_task_row_set_active (GtdTaskRow *self,
 
   if (active)
     {
+      /* The row is about to be edited */
+      gtd_task_row__inflate (self);
+
       gtk_stack_set_visible_child_name (self->task_stack, "title");
       gtk_widget_grab_focus (GTK_WIDGET (self->title_entry));
 
       g_signal_emit (self, signals[ENTER], 0);
     }
-  else
+  else if (self->inflated)
     {
       gtk_stack_set_visible_child_name (self->task_stack, "label");
+      queue_deflate (self);
     }
 }
 
@@ -854,6 +1964,11 @@ gtd_task_row_set_sizegroups (GtdTaskRow   *self,
                              GtkSizeGroup *name_group,
                              GtkSizeGroup *date_group)
 {
+  g_set_object (&self->name_group, name_group);
+
+  if (!self->inflated)
+    return;
+
   gtk_size_group_add_widget (name_group, GTK_WIDGET (self->task_list_label));
   gtk_size_group_add_widget (name_group, GTK_WIDGET (self->task_date_label));
 }
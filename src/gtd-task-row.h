@@ -32,6 +32,8 @@ G_DECLARE_FINAL_TYPE (GtdTaskRow, gtd_task_row, GTD, TASK_ROW, GtkListBoxRow)
 
 GtkWidget*                gtd_task_row_new                      (GtdTask             *task);
 
+GtkWidget*                gtd_task_row_new_compact              (GtdTask             *task);
+
 GtdTask*                  gtd_task_row_get_task                 (GtdTaskRow          *row);
 
 void                      gtd_task_row_set_task                 (GtdTaskRow          *row,
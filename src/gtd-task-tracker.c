@@ -0,0 +1,427 @@
+/* gtd-task-tracker.c
+ *
+ * Copyright (C) 2017 Georges Basile Stavracas Neto <georges.stavracas@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtd-manager.h"
+#include "gtd-task.h"
+#include "gtd-task-list.h"
+#include "gtd-task-list-view.h"
+#include "gtd-task-tracker.h"
+
+/**
+ * SECTION:gtd-task-tracker
+ * @Short_description: Keeps a #GtdTaskListView in sync with a filter
+ * @Title:GtdTaskTracker
+ *
+ * The #GtdTaskTracker follows the tasks of every list of the #GtdManager,
+ * and shows the ones accepted by a filter function in a #GtdTaskListView.
+ * Each change only touches the task that changed, so panels showing tasks
+ * from many lists don't rebuild their views while tasks are loaded.
+ */
+
+struct _GtdTaskTracker
+{
+  GObject             parent;
+
+  GtdTaskListView    *view;
+
+  GtdTaskTrackerFilterFunc filter_func;
+  gpointer            filter_data;
+
+  /* GtdTask → GINT_TO_POINTER (complete), for the tracked tasks */
+  GHashTable         *tasks;
+  guint               n_incomplete_tasks;
+
+  gboolean            started;
+};
+
+G_DEFINE_TYPE (GtdTaskTracker, gtd_task_tracker, G_TYPE_OBJECT)
+
+enum
+{
+  TASK_ADDED,
+  TASK_REMOVED,
+  TASK_UPDATED,
+  N_SIGNALS
+};
+
+static guint signals[N_SIGNALS] = { 0, };
+
+enum
+{
+  PROP_0,
+  PROP_N_INCOMPLETE_TASKS,
+  N_PROPS
+};
+
+/*
+ * Re-tests a single task, and updates the view and the counter of
+ * incomplete tasks.
+ */
+static void
+update_task (GtdTaskTracker *self,
+             GtdTask        *task,
+             gboolean        removed)
+{
+  gpointer was_complete;
+  gboolean is_member;
+  gboolean was_member;
+  gboolean complete;
+
+  was_member = g_hash_table_lookup_extended (self->tasks, task, NULL, &was_complete);
+  is_member = !removed && self->filter_func (task, self->filter_data);
+  complete = gtd_task_get_complete (task);
+
+  if (was_member && !GPOINTER_TO_INT (was_complete))
+    self->n_incomplete_tasks--;
+
+  if (is_member && !complete)
+    self->n_incomplete_tasks++;
+
+  if (is_member)
+    {
+      g_hash_table_insert (self->tasks, g_object_ref (task), GINT_TO_POINTER (complete));
+
+      if (was_member)
+        {
+          g_signal_emit (self, signals[TASK_UPDATED], 0, task);
+        }
+      else
+        {
+          g_signal_emit (self, signals[TASK_ADDED], 0, task);
+          gtd_task_list_view_add_task (self->view, task);
+        }
+    }
+  else if (was_member)
+    {
+      /* Keep the task alive until everybody is done with it */
+      g_object_ref (task);
+
+      g_hash_table_remove (self->tasks, task);
+      gtd_task_list_view_remove_task (self->view, task);
+      g_signal_emit (self, signals[TASK_REMOVED], 0, task);
+
+      g_object_unref (task);
+    }
+}
+
+static void
+update_tasks (GtdTaskTracker *self,
+              GList          *tasks,
+              gboolean        removed)
+{
+  guint old_n_incomplete_tasks;
+  GList *l;
+
+  old_n_incomplete_tasks = self->n_incomplete_tasks;
+
+  for (l = tasks; l != NULL; l = l->next)
+    update_task (self, l->data, removed);
+
+  if (old_n_incomplete_tasks != self->n_incomplete_tasks)
+    g_object_notify (G_OBJECT (self), "n-incomplete-tasks");
+}
+
+static void
+task_added_cb (GtdTaskList    *list,
+               GtdTask        *task,
+               GtdTaskTracker *self)
+{
+  GList tasks = { task, NULL, NULL };
+
+  update_tasks (self, &tasks, FALSE);
+}
+
+static void
+task_removed_cb (GtdTaskList    *list,
+                 GtdTask        *task,
+                 GtdTaskTracker *self)
+{
+  GList tasks = { task, NULL, NULL };
+
+  update_tasks (self, &tasks, TRUE);
+}
+
+static void
+list_added_cb (GtdManager     *manager,
+               GtdTaskList    *list,
+               GtdTaskTracker *self)
+{
+  GList *tasks;
+
+  g_signal_connect_object (list,
+                           "task-added",
+                           G_CALLBACK (task_added_cb),
+                           self,
+                           0);
+
+  g_signal_connect_object (list,
+                           "task-updated",
+                           G_CALLBACK (task_added_cb),
+                           self,
+                           0);
+
+  g_signal_connect_object (list,
+                           "task-removed",
+                           G_CALLBACK (task_removed_cb),
+                           self,
+                           0);
+
+  tasks = gtd_task_list_get_tasks (list);
+  update_tasks (self, tasks, FALSE);
+  g_list_free (tasks);
+}
+
+static void
+list_removed_cb (GtdManager     *manager,
+                 GtdTaskList    *list,
+                 GtdTaskTracker *self)
+{
+  GList *tasks;
+
+  g_signal_handlers_disconnect_by_data (list, self);
+
+  tasks = gtd_task_list_get_tasks (list);
+  update_tasks (self, tasks, TRUE);
+  g_list_free (tasks);
+}
+
+static void
+gtd_task_tracker_finalize (GObject *object)
+{
+  GtdTaskTracker *self = (GtdTaskTracker *)object;
+
+  g_clear_pointer (&self->tasks, g_hash_table_destroy);
+  g_clear_object (&self->view);
+
+  G_OBJECT_CLASS (gtd_task_tracker_parent_class)->finalize (object);
+}
+
+static void
+gtd_task_tracker_get_property (GObject    *object,
+                               guint       prop_id,
+                               GValue     *value,
+                               GParamSpec *pspec)
+{
+  GtdTaskTracker *self = GTD_TASK_TRACKER (object);
+
+  switch (prop_id)
+    {
+    case PROP_N_INCOMPLETE_TASKS:
+      g_value_set_uint (value, self->n_incomplete_tasks);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+    }
+}
+
+static void
+gtd_task_tracker_class_init (GtdTaskTrackerClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->finalize = gtd_task_tracker_finalize;
+  object_class->get_property = gtd_task_tracker_get_property;
+
+  /**
+   * GtdTaskTracker:n-incomplete-tasks:
+   *
+   * The number of tracked tasks that are not complete.
+   */
+  g_object_class_install_property (object_class,
+                                   PROP_N_INCOMPLETE_TASKS,
+                                   g_param_spec_uint ("n-incomplete-tasks",
+                                                      "Number of incomplete tasks",
+                                                      "The number of tracked tasks that are not complete",
+                                                      0,
+                                                      G_MAXUINT,
+                                                      0,
+                                                      G_PARAM_READABLE | G_PARAM_EXPLICIT_NOTIFY));
+
+  /**
+   * GtdTaskTracker::task-added:
+   * @self: a #GtdTaskTracker
+   * @task: a #GtdTask
+   *
+   * The ::task-added signal is emmited when @task starts being
+   * tracked, right before it is added to the view.
+   */
+  signals[TASK_ADDED] = g_signal_new ("task-added",
+                                      GTD_TYPE_TASK_TRACKER,
+                                      G_SIGNAL_RUN_LAST,
+                                      0, NULL, NULL, NULL,
+                                      G_TYPE_NONE,
+                                      1,
+                                      GTD_TYPE_TASK);
+
+  /**
+   * GtdTaskTracker::task-removed:
+   * @self: a #GtdTaskTracker
+   * @task: a #GtdTask
+   *
+   * The ::task-removed signal is emmited when @task stops being
+   * tracked, right after it is removed from the view.
+   */
+  signals[TASK_REMOVED] = g_signal_new ("task-removed",
+                                        GTD_TYPE_TASK_TRACKER,
+                                        G_SIGNAL_RUN_LAST,
+                                        0, NULL, NULL, NULL,
+                                        G_TYPE_NONE,
+                                        1,
+                                        GTD_TYPE_TASK);
+
+  /**
+   * GtdTaskTracker::task-updated:
+   * @self: a #GtdTaskTracker
+   * @task: a #GtdTask
+   *
+   * The ::task-updated signal is emmited when a tracked task
+   * changes, and is still accepted by the filter.
+   */
+  signals[TASK_UPDATED] = g_signal_new ("task-updated",
+                                        GTD_TYPE_TASK_TRACKER,
+                                        G_SIGNAL_RUN_LAST,
+                                        0, NULL, NULL, NULL,
+                                        G_TYPE_NONE,
+                                        1,
+                                        GTD_TYPE_TASK);
+}
+
+static void
+gtd_task_tracker_init (GtdTaskTracker *self)
+{
+  self->tasks = g_hash_table_new_full (g_direct_hash, g_direct_equal, g_object_unref, NULL);
+}
+
+/**
+ * gtd_task_tracker_new:
+ * @view: the #GtdTaskListView showing the tracked tasks
+ * @func: the filter function
+ * @user_data: (closure func): data passed to @func
+ *
+ * Creates a new #GtdTaskTracker. Tasks are only tracked after
+ * gtd_task_tracker_start() is called, so the signals can be
+ * connected before.
+ *
+ * Returns: (transfer full): a #GtdTaskTracker
+ */
+GtdTaskTracker*
+gtd_task_tracker_new (GtdTaskListView          *view,
+                      GtdTaskTrackerFilterFunc  func,
+                      gpointer                  user_data)
+{
+  GtdTaskTracker *self;
+
+  g_return_val_if_fail (GTD_IS_TASK_LIST_VIEW (view), NULL);
+  g_return_val_if_fail (func != NULL, NULL);
+
+  self = g_object_new (GTD_TYPE_TASK_TRACKER, NULL);
+  self->view = g_object_ref (view);
+  self->filter_func = func;
+  self->filter_data = user_data;
+
+  return self;
+}
+
+/**
+ * gtd_task_tracker_start:
+ * @self: a #GtdTaskTracker
+ *
+ * Starts tracking the tasks of the current and future lists.
+ */
+void
+gtd_task_tracker_start (GtdTaskTracker *self)
+{
+  GtdManager *manager;
+  GList *lists;
+  GList *l;
+
+  g_return_if_fail (GTD_IS_TASK_TRACKER (self));
+
+  if (self->started)
+    return;
+
+  self->started = TRUE;
+  manager = gtd_manager_get_default ();
+  lists = gtd_manager_get_task_lists (manager);
+
+  for (l = lists; l != NULL; l = l->next)
+    list_added_cb (manager, l->data, self);
+
+  g_list_free (lists);
+
+  g_signal_connect_object (manager,
+                           "list-added",
+                           G_CALLBACK (list_added_cb),
+                           self,
+                           0);
+
+  g_signal_connect_object (manager,
+                           "list-removed",
+                           G_CALLBACK (list_removed_cb),
+                           self,
+                           0);
+}
+
+/**
+ * gtd_task_tracker_refilter:
+ * @self: a #GtdTaskTracker
+ *
+ * Tests every task against the filter again. Only call this when the
+ * filter itself changed, e.g. after a day change, since it traverses
+ * all the tasks.
+ */
+void
+gtd_task_tracker_refilter (GtdTaskTracker *self)
+{
+  GList *tasks;
+  GList *lists;
+  GList *l;
+
+  g_return_if_fail (GTD_IS_TASK_TRACKER (self));
+
+  if (!self->started)
+    return;
+
+  tasks = NULL;
+  lists = gtd_manager_get_task_lists (gtd_manager_get_default ());
+
+  for (l = lists; l != NULL; l = l->next)
+    tasks = g_list_concat (gtd_task_list_get_tasks (l->data), tasks);
+
+  update_tasks (self, tasks, FALSE);
+
+  g_list_free (tasks);
+  g_list_free (lists);
+}
+
+/**
+ * gtd_task_tracker_get_n_incomplete_tasks:
+ * @self: a #GtdTaskTracker
+ *
+ * Retrieves the number of tracked tasks that are not complete.
+ *
+ * Returns: the number of incomplete tasks
+ */
+guint
+gtd_task_tracker_get_n_incomplete_tasks (GtdTaskTracker *self)
+{
+  g_return_val_if_fail (GTD_IS_TASK_TRACKER (self), 0);
+
+  return self->n_incomplete_tasks;
+}
@@ -0,0 +1,57 @@
+/* gtd-task-tracker.h
+ *
+ * Copyright (C) 2017 Georges Basile Stavracas Neto <georges.stavracas@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GTD_TASK_TRACKER_H
+#define GTD_TASK_TRACKER_H
+
+#include "gtd-task-list-view.h"
+#include "gtd-types.h"
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+#define GTD_TYPE_TASK_TRACKER (gtd_task_tracker_get_type())
+
+G_DECLARE_FINAL_TYPE (GtdTaskTracker, gtd_task_tracker, GTD, TASK_TRACKER, GObject)
+
+/**
+ * GtdTaskTrackerFilterFunc:
+ * @task: a #GtdTask
+ * @user_data: (closure): user data
+ *
+ * The function deciding whether @task is tracked.
+ *
+ * Returns: %TRUE if @task should be tracked, %FALSE otherwise
+ */
+typedef gboolean     (*GtdTaskTrackerFilterFunc)                 (GtdTask            *task,
+                                                                  gpointer            user_data);
+
+GtdTaskTracker*      gtd_task_tracker_new                        (GtdTaskListView          *view,
+                                                                  GtdTaskTrackerFilterFunc  func,
+                                                                  gpointer                  user_data);
+
+void                 gtd_task_tracker_start                      (GtdTaskTracker     *self);
+
+void                 gtd_task_tracker_refilter                   (GtdTaskTracker     *self);
+
+guint                gtd_task_tracker_get_n_incomplete_tasks     (GtdTaskTracker     *self);
+
+G_END_DECLS
+
+#endif /* GTD_TASK_TRACKER_H */
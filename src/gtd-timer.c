@@ -28,12 +28,35 @@ struct _GtdTimer
 
   GDateTime          *current_day;
 
+  gboolean            suspended;
+
+  /* Deadlines, as a binary min-heap ordered by wall-clock time */
+  GPtrArray          *deadlines;
+  GHashTable         *deadline_ids;
+  guint               last_deadline_id;
+  guint               deadline_timeout_id;
+
   GDBusProxy         *logind;
   GCancellable       *cancellable;
 };
 
+typedef struct
+{
+  guint               id;
+  guint               index;
+
+  /* Wall-clock time, in microseconds */
+  gint64              time;
+
+  GtdTimerFunc        func;
+  gpointer            user_data;
+  GDestroyNotify      destroy;
+} Deadline;
+
 static gboolean      update_for_day_change                       (gpointer           user_data);
 
+static void          schedule_next_deadline                      (GtdTimer           *self);
+
 G_DEFINE_TYPE (GtdTimer, gtd_timer, GTD_TYPE_OBJECT)
 
 enum
@@ -44,6 +67,13 @@ enum
 
 static guint signals[N_SIGNALS] = { 0, };
 
+enum
+{
+  PROP_0,
+  PROP_SUSPENDED,
+  N_PROPS
+};
+
 /*
  * Auxiliary methods
  */
@@ -90,6 +120,171 @@ schedule_update_for_day_change (GtdTimer *self)
                                                    self);
 }
 
+/*
+ * Deadlines
+ *
+ * Deadlines are kept in a binary heap, and only the earliest one has a
+ * main loop timeout armed, however many deadlines there are. Timeouts
+ * are based on the monotonic clock, which doesn't advance while the
+ * system is suspended, so the timeout is armed again when resuming.
+ */
+
+static void
+deadline_free (Deadline *deadline)
+{
+  if (deadline->destroy)
+    deadline->destroy (deadline->user_data);
+
+  g_free (deadline);
+}
+
+static inline Deadline*
+heap_get (GtdTimer *self,
+          guint     index)
+{
+  return g_ptr_array_index (self->deadlines, index);
+}
+
+static void
+heap_swap (GtdTimer *self,
+           guint     a,
+           guint     b)
+{
+  Deadline *da, *db;
+
+  da = heap_get (self, a);
+  db = heap_get (self, b);
+
+  g_ptr_array_index (self->deadlines, a) = db;
+  g_ptr_array_index (self->deadlines, b) = da;
+
+  da->index = b;
+  db->index = a;
+}
+
+static void
+heap_sift_up (GtdTimer *self,
+              guint     index)
+{
+  while (index > 0)
+    {
+      guint parent = (index - 1) / 2;
+
+      if (heap_get (self, parent)->time <= heap_get (self, index)->time)
+        break;
+
+      heap_swap (self, parent, index);
+      index = parent;
+    }
+}
+
+static void
+heap_sift_down (GtdTimer *self,
+                guint     index)
+{
+  guint len = self->deadlines->len;
+
+  while (TRUE)
+    {
+      guint smallest = index;
+      guint left = 2 * index + 1;
+      guint right = left + 1;
+
+      if (left < len && heap_get (self, left)->time < heap_get (self, smallest)->time)
+        smallest = left;
+
+      if (right < len && heap_get (self, right)->time < heap_get (self, smallest)->time)
+        smallest = right;
+
+      if (smallest == index)
+        break;
+
+      heap_swap (self, index, smallest);
+      index = smallest;
+    }
+}
+
+static void
+heap_push (GtdTimer *self,
+           Deadline *deadline)
+{
+  deadline->index = self->deadlines->len;
+  g_ptr_array_add (self->deadlines, deadline);
+
+  heap_sift_up (self, deadline->index);
+}
+
+/* Removes the deadline at @index from the heap, without freeing it */
+static Deadline*
+heap_remove (GtdTimer *self,
+             guint     index)
+{
+  Deadline *deadline;
+  guint last;
+
+  deadline = heap_get (self, index);
+  last = self->deadlines->len - 1;
+
+  if (index != last)
+    heap_swap (self, index, last);
+
+  g_ptr_array_remove_index (self->deadlines, last);
+
+  if (index != last)
+    {
+      heap_sift_down (self, index);
+      heap_sift_up (self, index);
+    }
+
+  return deadline;
+}
+
+static gboolean
+deadline_timeout_cb (gpointer user_data)
+{
+  GtdTimer *self = user_data;
+  gint64 now;
+
+  self->deadline_timeout_id = 0;
+
+  now = g_get_real_time ();
+
+  /* Allow some slack, since timeouts have millisecond granularity */
+  while (self->deadlines->len > 0 && heap_get (self, 0)->time <= now + 1000)
+    {
+      Deadline *deadline = heap_remove (self, 0);
+
+      g_hash_table_remove (self->deadline_ids, GUINT_TO_POINTER (deadline->id));
+
+      deadline->func (self, deadline->user_data);
+      deadline_free (deadline);
+    }
+
+  schedule_next_deadline (self);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+schedule_next_deadline (GtdTimer *self)
+{
+  gint64 timeout;
+
+  if (self->deadline_timeout_id > 0)
+    {
+      g_source_remove (self->deadline_timeout_id);
+      self->deadline_timeout_id = 0;
+    }
+
+  if (self->deadlines->len == 0)
+    return;
+
+  timeout = (heap_get (self, 0)->time - g_get_real_time ()) / 1000;
+  timeout = CLAMP (timeout, 0, G_MAXINT);
+
+  self->deadline_timeout_id = g_timeout_add ((guint) timeout, deadline_timeout_cb, self);
+}
+
 /*
  * Callbacks
  */
@@ -110,12 +305,21 @@ logind_signal_received_cb (GDBusProxy  *logind,
   child = g_variant_get_child_value (params, 0);
   resuming = !g_variant_get_boolean (child);
 
+  if (self->suspended == resuming)
+    {
+      self->suspended = !resuming;
+      g_object_notify (G_OBJECT (self), "suspended");
+    }
+
   /* Only emit :update when resuming */
   if (resuming)
     {
       /* Reschedule the daily timeout */
       update_current_day (self);
       schedule_update_for_day_change (self);
+
+      /* Deadlines that passed while suspended fire now */
+      schedule_next_deadline (self);
     }
 
   g_clear_pointer (&child, g_variant_unref);
@@ -176,6 +380,18 @@ gtd_timer_finalize (GObject *object)
       self->update_timeout_id = 0;
     }
 
+  if (self->deadline_timeout_id > 0)
+    {
+      g_source_remove (self->deadline_timeout_id);
+      self->deadline_timeout_id = 0;
+    }
+
+  g_clear_pointer (&self->deadline_ids, g_hash_table_destroy);
+
+  if (self->deadlines)
+    g_ptr_array_foreach (self->deadlines, (GFunc) deadline_free, NULL);
+
+  g_clear_pointer (&self->deadlines, g_ptr_array_unref);
   g_clear_pointer (&self->current_day, g_date_time_unref);
 
   g_clear_object (&self->cancellable);
@@ -190,7 +406,17 @@ gtd_timer_get_property (GObject    *object,
                         GValue     *value,
                         GParamSpec *pspec)
 {
-  G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+  GtdTimer *self = GTD_TIMER (object);
+
+  switch (prop_id)
+    {
+    case PROP_SUSPENDED:
+      g_value_set_boolean (value, self->suspended);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+    }
 }
 
 static void
@@ -211,6 +437,20 @@ gtd_timer_class_init (GtdTimerClass *klass)
   object_class->get_property = gtd_timer_get_property;
   object_class->set_property = gtd_timer_set_property;
 
+  /**
+   * GtdTimer:suspended:
+   *
+   * Whether the session is suspended or about to be suspended. Objects
+   * that poll remote services should pause while this is %TRUE.
+   */
+  g_object_class_install_property (object_class,
+                                   PROP_SUSPENDED,
+                                   g_param_spec_boolean ("suspended",
+                                                         "Suspended",
+                                                         "Whether the session is suspended",
+                                                         FALSE,
+                                                         G_PARAM_READABLE | G_PARAM_EXPLICIT_NOTIFY));
+
   /**
    * GtdTimer:update:
    *
@@ -233,6 +473,10 @@ gtd_timer_init (GtdTimer *self)
   self->current_day = g_date_time_new_now_local ();
   self->cancellable = g_cancellable_new ();
 
+  /* Deadlines leaving the heap are freed by whoever removes them */
+  self->deadlines = g_ptr_array_new ();
+  self->deadline_ids = g_hash_table_new (g_direct_hash, g_direct_equal);
+
   g_dbus_proxy_new_for_bus (G_BUS_TYPE_SYSTEM,
                             G_DBUS_PROXY_FLAGS_NONE,
                             NULL,
@@ -251,3 +495,99 @@ gtd_timer_new (void)
 {
   return g_object_new (GTD_TYPE_TIMER, NULL);
 }
+
+/**
+ * gtd_timer_get_suspended:
+ * @self: a #GtdTimer
+ *
+ * Retrieves whether the session is suspended, or about to be.
+ *
+ * Returns: %TRUE if the session is suspended, %FALSE otherwise.
+ */
+gboolean
+gtd_timer_get_suspended (GtdTimer *self)
+{
+  g_return_val_if_fail (GTD_IS_TIMER (self), FALSE);
+
+  return self->suspended;
+}
+
+/**
+ * gtd_timer_add_deadline:
+ * @self: a #GtdTimer
+ * @when: the time to call @func at
+ * @func: (scope notified): the function to call
+ * @user_data: (closure func): data passed to @func
+ * @destroy: (nullable): destroy notify for @user_data
+ *
+ * Calls @func once at @when, or as soon as possible if @when already
+ * passed. The call happens at the exact time even if the system was
+ * suspended in between, although it's delayed until the system
+ * resumes.
+ *
+ * Returns: the identifier of the deadline, to be passed to
+ * gtd_timer_remove_deadline().
+ */
+guint
+gtd_timer_add_deadline (GtdTimer       *self,
+                        GDateTime      *when,
+                        GtdTimerFunc    func,
+                        gpointer        user_data,
+                        GDestroyNotify  destroy)
+{
+  Deadline *deadline;
+  gboolean earliest;
+
+  g_return_val_if_fail (GTD_IS_TIMER (self), 0);
+  g_return_val_if_fail (when != NULL, 0);
+  g_return_val_if_fail (func != NULL, 0);
+
+  deadline = g_new0 (Deadline, 1);
+  deadline->id = ++self->last_deadline_id;
+  deadline->time = g_date_time_to_unix (when) * G_USEC_PER_SEC + g_date_time_get_microsecond (when);
+  deadline->func = func;
+  deadline->user_data = user_data;
+  deadline->destroy = destroy;
+
+  heap_push (self, deadline);
+  g_hash_table_insert (self->deadline_ids, GUINT_TO_POINTER (deadline->id), deadline);
+
+  /* Only rearm the timeout if this is the new earliest deadline */
+  earliest = deadline->index == 0;
+
+  if (earliest)
+    schedule_next_deadline (self);
+
+  return deadline->id;
+}
+
+/**
+ * gtd_timer_remove_deadline:
+ * @self: a #GtdTimer
+ * @id: the deadline identifier
+ *
+ * Removes the deadline @id, added with gtd_timer_add_deadline(). The
+ * function of the deadline is not called.
+ */
+void
+gtd_timer_remove_deadline (GtdTimer *self,
+                           guint     id)
+{
+  Deadline *deadline;
+  gboolean earliest;
+
+  g_return_if_fail (GTD_IS_TIMER (self));
+
+  deadline = g_hash_table_lookup (self->deadline_ids, GUINT_TO_POINTER (id));
+
+  if (!deadline)
+    return;
+
+  earliest = deadline->index == 0;
+
+  g_hash_table_remove (self->deadline_ids, GUINT_TO_POINTER (id));
+  deadline_free (heap_remove (self, deadline->index));
+
+  if (earliest)
+    schedule_next_deadline (self);
+}
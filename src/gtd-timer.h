@@ -29,8 +29,29 @@ G_BEGIN_DECLS
 
 G_DECLARE_FINAL_TYPE (GtdTimer, gtd_timer, GTD, TIMER, GtdObject)
 
+/**
+ * GtdTimerFunc:
+ * @self: the #GtdTimer
+ * @user_data: (closure): user data
+ *
+ * The function called when a deadline is reached.
+ */
+typedef void         (*GtdTimerFunc)                             (GtdTimer           *self,
+                                                                  gpointer            user_data);
+
 GtdTimer*            gtd_timer_new                               (void);
 
+gboolean             gtd_timer_get_suspended                     (GtdTimer           *self);
+
+guint                gtd_timer_add_deadline                      (GtdTimer           *self,
+                                                                  GDateTime          *when,
+                                                                  GtdTimerFunc        func,
+                                                                  gpointer            user_data,
+                                                                  GDestroyNotify      destroy);
+
+void                 gtd_timer_remove_deadline                   (GtdTimer           *self,
+                                                                  guint               id);
+
 G_END_DECLS
 
 #endif /* GTD_TIMER_H */
@@ -44,6 +44,7 @@ typedef struct _GtdTask                 GtdTask;
 typedef struct _GtdTaskList             GtdTaskList;
 typedef struct _GtdTaskListItem         GtdTaskListItem;
 typedef struct _GtdTaskRow              GtdTaskRow;
+typedef struct _GtdTaskTracker          GtdTaskTracker;
 typedef struct _GtdTimer                GtdTimer;
 typedef struct _GtdWindow               GtdWindow;
 
@@ -17,6 +17,7 @@
  */
 
 #include "gtd-provider.h"
+#include "gtd-task.h"
 #include "gtd-task-list.h"
 
 /**
@@ -40,11 +41,141 @@ enum
   LIST_ADDED,
   LIST_CHANGED,
   LIST_REMOVED,
+  LISTS_LOADED,
   NUM_SIGNALS
 };
 
 static guint signals[NUM_SIGNALS] = { 0, };
 
+typedef void         (*GtdProviderTaskFunc)                      (GtdProvider        *provider,
+                                                                  GtdTask            *task);
+
+typedef gboolean     (*GtdProviderFinishFunc)                    (GtdProvider        *provider,
+                                                                  GAsyncResult       *result,
+                                                                  GError            **error);
+
+/*
+ * Providers that don't implement the asynchronous variants of the
+ * task operations fall back to the synchronous ones, which complete
+ * right away.
+ */
+static void
+run_task_operation_sync (GtdProvider         *provider,
+                         GtdTask             *task,
+                         GtdProviderTaskFunc  operation,
+                         gpointer             source_tag,
+                         GCancellable        *cancellable,
+                         GAsyncReadyCallback  callback,
+                         gpointer             user_data)
+{
+  GTask *result;
+
+  result = g_task_new (provider, cancellable, callback, user_data);
+  g_task_set_source_tag (result, source_tag);
+
+  if (!g_task_return_error_if_cancelled (result))
+    {
+      operation (provider, task);
+      g_task_return_boolean (result, TRUE);
+    }
+
+  g_object_unref (result);
+}
+
+static gboolean
+finish_task_operation (GtdProvider            *provider,
+                       GAsyncResult           *result,
+                       gpointer                source_tag,
+                       GtdProviderFinishFunc   finish,
+                       GError                **error)
+{
+  if (g_task_is_valid (result, provider) && g_task_get_source_tag (G_TASK (result)) == source_tag)
+    return g_task_propagate_boolean (G_TASK (result), error);
+
+  g_return_val_if_fail (finish, FALSE);
+
+  return finish (provider, result, error);
+}
+
+/*
+ * Providers that don't remove tasks in batches get the removals one by
+ * one, with at most REMOVE_TASKS_MAX_PENDING of them running at once, so
+ * a large batch doesn't flood them. The batch finishes when the last
+ * removal does.
+ */
+#define REMOVE_TASKS_MAX_PENDING 4
+
+typedef struct
+{
+  GPtrArray          *tasks;
+  guint               next;
+  guint               n_pending;
+  GError             *error;
+} RemoveTasksData;
+
+static void
+remove_tasks_data_free (RemoveTasksData *data)
+{
+  g_ptr_array_unref (data->tasks);
+  g_clear_error (&data->error);
+  g_free (data);
+}
+
+static void          remove_tasks_fallback_cb                    (GObject            *source,
+                                                                  GAsyncResult       *result,
+                                                                  gpointer            user_data);
+
+static void
+remove_next_tasks (GTask *batch)
+{
+  RemoveTasksData *data = g_task_get_task_data (batch);
+
+  while (data->next < data->tasks->len && data->n_pending < REMOVE_TASKS_MAX_PENDING)
+    {
+      data->n_pending++;
+
+      gtd_provider_remove_task_async (g_task_get_source_object (batch),
+                                      g_ptr_array_index (data->tasks, data->next++),
+                                      g_task_get_cancellable (batch),
+                                      remove_tasks_fallback_cb,
+                                      g_object_ref (batch));
+    }
+}
+
+static void
+remove_tasks_fallback_cb (GObject      *source,
+                          GAsyncResult *result,
+                          gpointer      user_data)
+{
+  RemoveTasksData *data;
+  GTask *batch;
+  GError *error;
+
+  batch = user_data;
+  data = g_task_get_task_data (batch);
+  error = NULL;
+
+  /* Only the first error is reported */
+  if (!gtd_provider_remove_task_finish (GTD_PROVIDER (source), result, &error) && !data->error)
+    data->error = g_steal_pointer (&error);
+
+  g_clear_error (&error);
+
+  data->n_pending--;
+
+  remove_next_tasks (batch);
+
+  if (data->n_pending == 0)
+    {
+      if (data->error)
+        g_task_return_error (batch, g_steal_pointer (&data->error));
+      else
+        g_task_return_boolean (batch, TRUE);
+    }
+
+  g_object_unref (batch);
+}
+
 static void
 gtd_provider_default_init (GtdProviderInterface *iface)
 {
@@ -178,6 +309,24 @@ gtd_provider_default_init (GtdProviderInterface *iface)
                                         G_TYPE_NONE,
                                         1,
                                         GTD_TYPE_TASK_LIST);
+
+  /**
+   * GtdProvider::lists-loaded:
+   * @provider: a #GtdProvider
+   *
+   * The ::lists-loaded signal is emmited after @provider added
+   * all the #GtdTaskList it had when it started loading, and
+   * gtd_provider_get_lists_loaded() returns %TRUE.
+   */
+  signals[LISTS_LOADED] = g_signal_new ("lists-loaded",
+                                        GTD_TYPE_PROVIDER,
+                                        G_SIGNAL_RUN_LAST,
+                                        0,
+                                        NULL,
+                                        NULL,
+                                        NULL,
+                                        G_TYPE_NONE,
+                                        0);
 }
 
 /**
@@ -250,6 +399,27 @@ gtd_provider_get_enabled (GtdProvider *provider)
   return GTD_PROVIDER_GET_IFACE (provider)->get_enabled (provider);
 }
 
+/**
+ * gtd_provider_get_lists_loaded:
+ * @provider: a #GtdProvider
+ *
+ * Retrieves whether @provider already added the task lists it had
+ * when it started loading. Providers that add their lists right away
+ * don't need to implement this.
+ *
+ * Returns: %TRUE if the lists of @provider are loaded, %FALSE otherwise.
+ */
+gboolean
+gtd_provider_get_lists_loaded (GtdProvider *provider)
+{
+  g_return_val_if_fail (GTD_IS_PROVIDER (provider), FALSE);
+
+  if (!GTD_PROVIDER_GET_IFACE (provider)->get_lists_loaded)
+    return TRUE;
+
+  return GTD_PROVIDER_GET_IFACE (provider)->get_lists_loaded (provider);
+}
+
 /**
  * gtd_provider_get_icon:
  * @provider: a #GtdProvider
@@ -327,6 +497,290 @@ gtd_provider_remove_task (GtdProvider *provider,
   GTD_PROVIDER_GET_IFACE (provider)->remove_task (provider, task);
 }
 
+/**
+ * gtd_provider_create_task_async:
+ * @provider: a #GtdProvider
+ * @task: a #GtdTask
+ * @cancellable: (nullable): a #GCancellable
+ * @callback: (scope async): callback to call when the operation is finished
+ * @user_data: (closure): data to pass to @callback
+ *
+ * Asynchronously creates @task in @provider. Providers that don't
+ * implement it fall back to gtd_provider_create_task().
+ */
+void
+gtd_provider_create_task_async (GtdProvider         *provider,
+                                GtdTask             *task,
+                                GCancellable        *cancellable,
+                                GAsyncReadyCallback  callback,
+                                gpointer             user_data)
+{
+  GtdProviderInterface *iface;
+
+  g_return_if_fail (GTD_IS_PROVIDER (provider));
+  g_return_if_fail (GTD_IS_TASK (task));
+  g_return_if_fail (!cancellable || G_IS_CANCELLABLE (cancellable));
+
+  iface = GTD_PROVIDER_GET_IFACE (provider);
+
+  if (iface->create_task_async)
+    {
+      iface->create_task_async (provider, task, cancellable, callback, user_data);
+      return;
+    }
+
+  g_return_if_fail (iface->create_task);
+
+  run_task_operation_sync (provider,
+                           task,
+                           iface->create_task,
+                           gtd_provider_create_task_async,
+                           cancellable,
+                           callback,
+                           user_data);
+}
+
+/**
+ * gtd_provider_create_task_finish:
+ * @provider: a #GtdProvider
+ * @result: a #GAsyncResult
+ * @error: (nullable): return location for a #GError
+ *
+ * Finishes an operation started by gtd_provider_create_task_async().
+ *
+ * Returns: %TRUE if the task was created, %FALSE otherwise.
+ */
+gboolean
+gtd_provider_create_task_finish (GtdProvider   *provider,
+                                 GAsyncResult  *result,
+                                 GError       **error)
+{
+  g_return_val_if_fail (GTD_IS_PROVIDER (provider), FALSE);
+  g_return_val_if_fail (G_IS_ASYNC_RESULT (result), FALSE);
+
+  return finish_task_operation (provider,
+                                result,
+                                gtd_provider_create_task_async,
+                                GTD_PROVIDER_GET_IFACE (provider)->create_task_finish,
+                                error);
+}
+
+/**
+ * gtd_provider_update_task_async:
+ * @provider: a #GtdProvider
+ * @task: a #GtdTask
+ * @cancellable: (nullable): a #GCancellable
+ * @callback: (scope async): callback to call when the operation is finished
+ * @user_data: (closure): data to pass to @callback
+ *
+ * Asynchronously updates @task in @provider. Providers that don't
+ * implement it fall back to gtd_provider_update_task().
+ */
+void
+gtd_provider_update_task_async (GtdProvider         *provider,
+                                GtdTask             *task,
+                                GCancellable        *cancellable,
+                                GAsyncReadyCallback  callback,
+                                gpointer             user_data)
+{
+  GtdProviderInterface *iface;
+
+  g_return_if_fail (GTD_IS_PROVIDER (provider));
+  g_return_if_fail (GTD_IS_TASK (task));
+  g_return_if_fail (!cancellable || G_IS_CANCELLABLE (cancellable));
+
+  iface = GTD_PROVIDER_GET_IFACE (provider);
+
+  if (iface->update_task_async)
+    {
+      iface->update_task_async (provider, task, cancellable, callback, user_data);
+      return;
+    }
+
+  g_return_if_fail (iface->update_task);
+
+  run_task_operation_sync (provider,
+                           task,
+                           iface->update_task,
+                           gtd_provider_update_task_async,
+                           cancellable,
+                           callback,
+                           user_data);
+}
+
+/**
+ * gtd_provider_update_task_finish:
+ * @provider: a #GtdProvider
+ * @result: a #GAsyncResult
+ * @error: (nullable): return location for a #GError
+ *
+ * Finishes an operation started by gtd_provider_update_task_async().
+ *
+ * Returns: %TRUE if the task was updated, %FALSE otherwise.
+ */
+gboolean
+gtd_provider_update_task_finish (GtdProvider   *provider,
+                                 GAsyncResult  *result,
+                                 GError       **error)
+{
+  g_return_val_if_fail (GTD_IS_PROVIDER (provider), FALSE);
+  g_return_val_if_fail (G_IS_ASYNC_RESULT (result), FALSE);
+
+  return finish_task_operation (provider,
+                                result,
+                                gtd_provider_update_task_async,
+                                GTD_PROVIDER_GET_IFACE (provider)->update_task_finish,
+                                error);
+}
+
+/**
+ * gtd_provider_remove_task_async:
+ * @provider: a #GtdProvider
+ * @task: a #GtdTask
+ * @cancellable: (nullable): a #GCancellable
+ * @callback: (scope async): callback to call when the operation is finished
+ * @user_data: (closure): data to pass to @callback
+ *
+ * Asynchronously removes @task from @provider. Providers that don't
+ * implement it fall back to gtd_provider_remove_task().
+ */
+void
+gtd_provider_remove_task_async (GtdProvider         *provider,
+                                GtdTask             *task,
+                                GCancellable        *cancellable,
+                                GAsyncReadyCallback  callback,
+                                gpointer             user_data)
+{
+  GtdProviderInterface *iface;
+
+  g_return_if_fail (GTD_IS_PROVIDER (provider));
+  g_return_if_fail (GTD_IS_TASK (task));
+  g_return_if_fail (!cancellable || G_IS_CANCELLABLE (cancellable));
+
+  iface = GTD_PROVIDER_GET_IFACE (provider);
+
+  if (iface->remove_task_async)
+    {
+      iface->remove_task_async (provider, task, cancellable, callback, user_data);
+      return;
+    }
+
+  g_return_if_fail (iface->remove_task);
+
+  run_task_operation_sync (provider,
+                           task,
+                           iface->remove_task,
+                           gtd_provider_remove_task_async,
+                           cancellable,
+                           callback,
+                           user_data);
+}
+
+/**
+ * gtd_provider_remove_task_finish:
+ * @provider: a #GtdProvider
+ * @result: a #GAsyncResult
+ * @error: (nullable): return location for a #GError
+ *
+ * Finishes an operation started by gtd_provider_remove_task_async().
+ *
+ * Returns: %TRUE if the task was removed, %FALSE otherwise.
+ */
+gboolean
+gtd_provider_remove_task_finish (GtdProvider   *provider,
+                                 GAsyncResult  *result,
+                                 GError       **error)
+{
+  g_return_val_if_fail (GTD_IS_PROVIDER (provider), FALSE);
+  g_return_val_if_fail (G_IS_ASYNC_RESULT (result), FALSE);
+
+  return finish_task_operation (provider,
+                                result,
+                                gtd_provider_remove_task_async,
+                                GTD_PROVIDER_GET_IFACE (provider)->remove_task_finish,
+                                error);
+}
+
+/**
+ * gtd_provider_remove_tasks_async:
+ * @provider: a #GtdProvider
+ * @tasks: (element-type Gtd.Task): the tasks to remove
+ * @cancellable: (nullable): a #GCancellable
+ * @callback: (scope async): callback to call when the operation is finished
+ * @user_data: (closure): data to pass to @callback
+ *
+ * Asynchronously removes all the @tasks from @provider at once. Providers
+ * that don't implement it fall back to gtd_provider_remove_task_async()
+ * for each task, a few at a time.
+ */
+void
+gtd_provider_remove_tasks_async (GtdProvider         *provider,
+                                 GPtrArray           *tasks,
+                                 GCancellable        *cancellable,
+                                 GAsyncReadyCallback  callback,
+                                 gpointer             user_data)
+{
+  GtdProviderInterface *iface;
+  RemoveTasksData *data;
+  GTask *batch;
+
+  g_return_if_fail (GTD_IS_PROVIDER (provider));
+  g_return_if_fail (tasks != NULL);
+  g_return_if_fail (!cancellable || G_IS_CANCELLABLE (cancellable));
+
+  iface = GTD_PROVIDER_GET_IFACE (provider);
+
+  if (iface->remove_tasks_async)
+    {
+      iface->remove_tasks_async (provider, tasks, cancellable, callback, user_data);
+      return;
+    }
+
+  batch = g_task_new (provider, cancellable, callback, user_data);
+  g_task_set_source_tag (batch, gtd_provider_remove_tasks_async);
+
+  if (tasks->len == 0)
+    {
+      g_task_return_boolean (batch, TRUE);
+      g_object_unref (batch);
+      return;
+    }
+
+  data = g_new0 (RemoveTasksData, 1);
+  data->tasks = g_ptr_array_ref (tasks);
+
+  g_task_set_task_data (batch, data, (GDestroyNotify) remove_tasks_data_free);
+
+  remove_next_tasks (batch);
+
+  g_object_unref (batch);
+}
+
+/**
+ * gtd_provider_remove_tasks_finish:
+ * @provider: a #GtdProvider
+ * @result: a #GAsyncResult
+ * @error: (nullable): return location for a #GError
+ *
+ * Finishes an operation started by gtd_provider_remove_tasks_async().
+ *
+ * Returns: %TRUE if the tasks were removed, %FALSE otherwise.
+ */
+gboolean
+gtd_provider_remove_tasks_finish (GtdProvider   *provider,
+                                  GAsyncResult  *result,
+                                  GError       **error)
+{
+  g_return_val_if_fail (GTD_IS_PROVIDER (provider), FALSE);
+  g_return_val_if_fail (G_IS_ASYNC_RESULT (result), FALSE);
+
+  return finish_task_operation (provider,
+                                result,
+                                gtd_provider_remove_tasks_async,
+                                GTD_PROVIDER_GET_IFACE (provider)->remove_tasks_finish,
+                                error);
+}
+
 /**
  * gtd_provider_create_task_list:
  * @provider: a #GtdProvider
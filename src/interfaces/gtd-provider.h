@@ -44,6 +44,8 @@ struct _GtdProviderInterface
 
   gboolean           (*get_enabled)                              (GtdProvider        *provider);
 
+  gboolean           (*get_lists_loaded)                         (GtdProvider        *provider);
+
   /* Customs */
   GIcon*             (*get_icon)                                 (GtdProvider        *provider);
 
@@ -75,6 +77,47 @@ struct _GtdProviderInterface
 
   void               (*set_default_task_list)                    (GtdProvider        *provider,
                                                                   GtdTaskList        *list);
+
+  /* Asynchronous task operations */
+  void               (*create_task_async)                        (GtdProvider        *provider,
+                                                                  GtdTask            *task,
+                                                                  GCancellable       *cancellable,
+                                                                  GAsyncReadyCallback callback,
+                                                                  gpointer            user_data);
+
+  gboolean           (*create_task_finish)                       (GtdProvider        *provider,
+                                                                  GAsyncResult       *result,
+                                                                  GError            **error);
+
+  void               (*update_task_async)                        (GtdProvider        *provider,
+                                                                  GtdTask            *task,
+                                                                  GCancellable       *cancellable,
+                                                                  GAsyncReadyCallback callback,
+                                                                  gpointer            user_data);
+
+  gboolean           (*update_task_finish)                       (GtdProvider        *provider,
+                                                                  GAsyncResult       *result,
+                                                                  GError            **error);
+
+  void               (*remove_task_async)                        (GtdProvider        *provider,
+                                                                  GtdTask            *task,
+                                                                  GCancellable       *cancellable,
+                                                                  GAsyncReadyCallback callback,
+                                                                  gpointer            user_data);
+
+  gboolean           (*remove_task_finish)                       (GtdProvider        *provider,
+                                                                  GAsyncResult       *result,
+                                                                  GError            **error);
+
+  void               (*remove_tasks_async)                       (GtdProvider        *provider,
+                                                                  GPtrArray          *tasks,
+                                                                  GCancellable       *cancellable,
+                                                                  GAsyncReadyCallback callback,
+                                                                  gpointer            user_data);
+
+  gboolean           (*remove_tasks_finish)                      (GtdProvider        *provider,
+                                                                  GAsyncResult       *result,
+                                                                  GError            **error);
 };
 
 const gchar*         gtd_provider_get_id                         (GtdProvider        *provider);
@@ -85,6 +128,8 @@ const gchar*         gtd_provider_get_description                (GtdProvider
 
 gboolean             gtd_provider_get_enabled                    (GtdProvider        *provider);
 
+gboolean             gtd_provider_get_lists_loaded               (GtdProvider        *provider);
+
 GIcon*               gtd_provider_get_icon                       (GtdProvider        *provider);
 
 const GtkWidget*     gtd_provider_get_edit_panel                 (GtdProvider        *provider);
@@ -98,6 +143,46 @@ void                 gtd_provider_update_task                    (GtdProvider
 void                 gtd_provider_remove_task                    (GtdProvider        *provider,
                                                                   GtdTask            *task);
 
+void                 gtd_provider_create_task_async              (GtdProvider        *provider,
+                                                                  GtdTask            *task,
+                                                                  GCancellable       *cancellable,
+                                                                  GAsyncReadyCallback callback,
+                                                                  gpointer            user_data);
+
+gboolean             gtd_provider_create_task_finish             (GtdProvider        *provider,
+                                                                  GAsyncResult       *result,
+                                                                  GError            **error);
+
+void                 gtd_provider_update_task_async              (GtdProvider        *provider,
+                                                                  GtdTask            *task,
+                                                                  GCancellable       *cancellable,
+                                                                  GAsyncReadyCallback callback,
+                                                                  gpointer            user_data);
+
+gboolean             gtd_provider_update_task_finish             (GtdProvider        *provider,
+                                                                  GAsyncResult       *result,
+                                                                  GError            **error);
+
+void                 gtd_provider_remove_task_async              (GtdProvider        *provider,
+                                                                  GtdTask            *task,
+                                                                  GCancellable       *cancellable,
+                                                                  GAsyncReadyCallback callback,
+                                                                  gpointer            user_data);
+
+gboolean             gtd_provider_remove_task_finish             (GtdProvider        *provider,
+                                                                  GAsyncResult       *result,
+                                                                  GError            **error);
+
+void                 gtd_provider_remove_tasks_async             (GtdProvider        *provider,
+                                                                  GPtrArray          *tasks,
+                                                                  GCancellable       *cancellable,
+                                                                  GAsyncReadyCallback callback,
+                                                                  gpointer            user_data);
+
+gboolean             gtd_provider_remove_tasks_finish            (GtdProvider        *provider,
+                                                                  GAsyncResult       *result,
+                                                                  GError            **error);
+
 void                 gtd_provider_create_task_list               (GtdProvider        *provider,
                                                                   GtdTaskList        *list);
 
@@ -16,6 +16,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "gtd-color-style.h"
 #include "gtd-enum-types.h"
 #include "gtd-task.h"
 #include "gtd-task-list.h"
@@ -24,6 +25,16 @@
 
 #include <glib/gi18n.h>
 
+/* What the rendered thumbnail depends on */
+typedef struct
+{
+  guint                      generation;
+  gint                       scale_factor;
+  GtdWindowMode              mode;
+  gboolean                   selected;
+  GtkStateFlags              state;
+} ThumbnailKey;
+
 struct _GtdListSelectorGridItem
 {
   GtkFlowBoxChild            parent;
@@ -37,8 +48,18 @@ struct _GtdListSelectorGridItem
   GtdTaskList               *list;
   GtdWindowMode              mode;
 
-  /* Custom CSS */
-  GtkCssProvider            *css_provider;
+  /* Thumbnail cache */
+  cairo_surface_t           *thumbnail;
+  ThumbnailKey               thumbnail_key;
+  guint                      update_thumbnail_id;
+
+  /* Thumbnail being rendered in a worker thread */
+  GCancellable              *render_cancellable;
+  ThumbnailKey               pending_key;
+
+  /* Thumbnail waiting for the item to be scrolled into view */
+  GtkAdjustment             *vadjustment;
+  gboolean                   thumbnail_deferred;
 
   /* flags */
   gint                      selected;
@@ -47,6 +68,8 @@ struct _GtdListSelectorGridItem
 
 static void          gtd_list_selector_item_iface_init           (GtdListSelectorItemInterface *iface);
 
+static void          gtd_list_selector_grid_item__queue_update_thumbnail (GtdListSelectorGridItem *item);
+
 G_DEFINE_TYPE_EXTENDED (GtdListSelectorGridItem, gtd_list_selector_grid_item, GTK_TYPE_FLOW_BOX_CHILD,
                         0,
                         G_IMPLEMENT_INTERFACE (GTD_TYPE_LIST_SELECTOR_ITEM,
@@ -65,32 +88,168 @@ enum {
   LAST_PROP
 };
 
-static cairo_surface_t*
-gtd_list_selector_grid_item__render_thumbnail (GtdListSelectorGridItem *item)
+/*
+ * Mirrors the layout of the rows in the thumbnail: rows are separated
+ * by 4px, and the row that doesn't fit anymore is replaced by a "…".
+ */
+static guint
+count_visible_rows (gint row_height,
+                    gint top,
+                    gint bottom,
+                    gint size)
+{
+  guint n_rows;
+  gint y;
+
+  n_rows = 0;
+  y = top + 4;
+
+  while (y + row_height + 4 + bottom <= size)
+    {
+      n_rows++;
+      y += row_height + 4;
+    }
+
+  return n_rows;
+}
+
+/*
+ * Partial selection of the first @max incomplete tasks of @list according
+ * to gtd_task_compare(), so that we don't sort the whole list just to draw
+ * a handful of titles. Ties keep the order of the list, like g_list_sort().
+ */
+static guint
+select_first_tasks (GtdTaskList  *list,
+                    GtdTask     **selected,
+                    guint         max)
+{
+  GList *tasks;
+  GList *l;
+  guint n_selected;
+
+  if (max == 0)
+    return 0;
+
+  tasks = gtd_task_list_get_tasks (list);
+  n_selected = 0;
+
+  for (l = tasks; l != NULL; l = l->next)
+    {
+      GtdTask *task;
+      guint i;
+
+      task = l->data;
+
+      /* Don't render completed tasks */
+      if (gtd_task_get_complete (task))
+        continue;
+
+      if (n_selected == max && gtd_task_compare (task, selected[max - 1]) >= 0)
+        continue;
+
+      i = n_selected < max ? n_selected++ : max - 1;
+
+      while (i > 0 && gtd_task_compare (task, selected[i - 1]) < 0)
+        {
+          selected[i] = selected[i - 1];
+          i--;
+        }
+
+      selected[i] = task;
+    }
+
+  g_list_free (tasks);
+
+  return n_selected;
+}
+
+/*
+ * Rasterising the thumbnails is the expensive part of showing many lists,
+ * so it happens in worker threads. Everything that needs GTK (style, task
+ * titles, positions) is captured here on the main thread as a list of text
+ * runs, and the workers only deal with cairo and Pango.
+ */
+typedef struct
+{
+  gchar                     *text;
+  gdouble                    x;
+  gdouble                    y;
+} TextRun;
+
+typedef struct
+{
+  gint                       size;
+  gint                       text_width;
+  gdouble                    resolution;
+  cairo_font_options_t      *font_options;
+  PangoFontDescription      *font_desc;
+  PangoAlignment             alignment;
+  GdkRGBA                    color;
+  GArray                    *runs;
+} ThumbnailSnapshot;
+
+static void
+text_run_clear (TextRun *run)
+{
+  g_clear_pointer (&run->text, g_free);
+}
+
+static void
+thumbnail_snapshot_free (ThumbnailSnapshot *snapshot)
+{
+  g_clear_pointer (&snapshot->font_options, cairo_font_options_destroy);
+  g_clear_pointer (&snapshot->font_desc, pango_font_description_free);
+  g_clear_pointer (&snapshot->runs, g_array_unref);
+  g_free (snapshot);
+}
+
+static void
+thumbnail_snapshot_add_run (ThumbnailSnapshot *snapshot,
+                            gchar             *text,
+                            gdouble            x,
+                            gdouble            y)
+{
+  TextRun run = { text, x, y };
+
+  g_array_append_val (snapshot->runs, run);
+}
+
+static ThumbnailSnapshot*
+gtd_list_selector_grid_item__capture_thumbnail (GtdListSelectorGridItem *item)
 {
-  PangoFontDescription *font_desc;
+  const cairo_font_options_t *font_options;
+  ThumbnailSnapshot *snapshot;
+  PangoContext *pango_context;
   GtkStyleContext *context;
-  cairo_surface_t *surface;
   GtkStateFlags state;
   PangoLayout *layout;
   GtdTaskList *list;
   GtkBorder margin;
   GtkBorder padding;
   GdkRGBA *color;
-  cairo_t *cr;
-  GList *tasks;
+  GtdTask **tasks;
+  guint n_tasks;
+  guint max_rows;
   gint scale_factor;
-  gint width, height;
+  gint row_height;
 
   list = item->list;
   color = gtd_task_list_get_color (list);
   scale_factor = gtk_widget_get_scale_factor (GTK_WIDGET (item));
-  width = THUMBNAIL_SIZE * scale_factor;
-  height = THUMBNAIL_SIZE * scale_factor;
-  surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32,
-                                        width,
-                                        height);
-  cr = cairo_create (surface);
+  pango_context = gtk_widget_get_pango_context (GTK_WIDGET (item));
+
+  snapshot = g_new0 (ThumbnailSnapshot, 1);
+  snapshot->size = THUMBNAIL_SIZE * scale_factor;
+  snapshot->alignment = PANGO_ALIGN_LEFT;
+  snapshot->runs = g_array_new (FALSE, FALSE, sizeof (TextRun));
+
+  g_array_set_clear_func (snapshot->runs, (GDestroyNotify) text_run_clear);
+
+  /* Make the workers lay out text the same way the widget does */
+  snapshot->resolution = pango_cairo_context_get_resolution (pango_context);
+  font_options = pango_cairo_context_get_font_options (pango_context);
+
+  snapshot->font_options = font_options ? cairo_font_options_copy (font_options) : cairo_font_options_create ();
 
   /*
    * We'll draw the task names according to the font size, margin & padding
@@ -103,21 +262,6 @@ gtd_list_selector_grid_item__render_thumbnail (GtdListSelectorGridItem *item)
   gtk_style_context_save (context);
   gtk_style_context_add_class (context, "thumbnail");
 
-  gtk_style_context_get (context,
-                         state,
-                         "font", &font_desc,
-                         NULL);
-  gtk_style_context_get_margin (context,
-                                state,
-                                &margin);
-  gtk_style_context_get_padding (context,
-                                 state,
-                                 &padding);
-
-  /* Draw the first tasks from the list */
-  layout = pango_cairo_create_layout (cr);
-  tasks = gtd_task_list_get_tasks (list);
-
   /*
    * If the list color is way too dark, we draw the task names in a light
    * font color.
@@ -133,93 +277,81 @@ gtd_list_selector_grid_item__render_thumbnail (GtdListSelectorGridItem *item)
       gtk_style_context_remove_class (context, "dark");
     }
 
-  /*
-   * Sort the list, so that the first tasks are similar to what
-   * the user will see when selecting the list.
-   */
-  tasks = g_list_sort (tasks, (GCompareFunc) gtd_task_compare);
-  width -= padding.left + margin.left + padding.right + margin.right;
+  gtk_style_context_get (context,
+                         state,
+                         "font", &snapshot->font_desc,
+                         NULL);
+  gtk_style_context_get_margin (context,
+                                state,
+                                &margin);
+  gtk_style_context_get_padding (context,
+                                 state,
+                                 &padding);
+  gtk_style_context_get_color (context,
+                               state,
+                               &snapshot->color);
 
-  pango_layout_set_font_description (layout, font_desc);
-  pango_layout_set_ellipsize (layout, PANGO_ELLIPSIZE_END);
-  pango_layout_set_width (layout, width * PANGO_SCALE);
+  gtk_style_context_restore (context);
+
+  snapshot->text_width = snapshot->size - (padding.left + margin.left + padding.right + margin.right);
 
   /*
-   * If the list exists and it's first element is a completed task,
-   * we know for sure (since the list is already sorted) that there's
-   * no undone tasks here.
+   * Titles are ellipsized to a single line, so every row has the same
+   * height and we know upfront how many of them fit. Only those (and
+   * one more, to know whether the "…" mark is needed) are picked from
+   * the list, in the order the user will see them when selecting it.
    */
-  if (tasks && !gtd_task_get_complete (tasks->data))
+  layout = gtk_widget_create_pango_layout (GTK_WIDGET (item), "…");
+  pango_layout_set_font_description (layout, snapshot->font_desc);
+  pango_layout_get_pixel_size (layout, NULL, &row_height);
+  g_object_unref (layout);
+
+  max_rows = count_visible_rows (row_height,
+                                 margin.top + padding.top,
+                                 margin.bottom + padding.bottom,
+                                 snapshot->size);
+
+  tasks = g_new0 (GtdTask*, max_rows + 1);
+  n_tasks = select_first_tasks (list, tasks, max_rows + 1);
+
+  if (n_tasks > 0)
     {
-      /* Draw the task name for each selected row. */
       gdouble x, y;
-      GList *l;
+      guint j;
 
       x = margin.left + padding.left;
       y = margin.top + padding.top;
 
-      for (l = tasks; l != NULL; l = l->next)
+      for (j = 0; j < n_tasks; j++)
         {
           GString *string;
-          gchar *formatted_title;
-          gint i, font_height;
-
-          /* Don't render completed tasks */
-          if (gtd_task_get_complete (l->data))
-            continue;
+          gint i;
 
           /* Hardcoded spacing between tasks */
           y += 4;
 
-          /* Adjust the title according to the subtask hierarchy */
-          string = g_string_new ("");
-
-          for (i = 0; i < gtd_task_get_depth (l->data); i++)
-            g_string_append (string, "    ");
-
-          g_string_append (string, gtd_task_get_title (l->data));
-
-          formatted_title = g_string_free (string, FALSE);
-
-          /* Set the real title */
-          pango_layout_set_text (layout,
-                                 formatted_title,
-                                 -1);
-
-          pango_layout_get_pixel_size (layout,
-                                       NULL,
-                                       &font_height);
-
-          g_free (formatted_title);
-
           /*
            * If we reach the last visible row, it should draw a
            * "…" mark and stop drawing anything else
            */
-          if (y + font_height + 4 + margin.bottom + padding.bottom > THUMBNAIL_SIZE * scale_factor)
+          if (j == max_rows)
             {
-              pango_layout_set_text (layout,
-                                     "…",
-                                     -1);
-
-              gtk_render_layout (context,
-                             cr,
-                             x,
-                             y,
-                             layout);
+              thumbnail_snapshot_add_run (snapshot, g_strdup ("…"), x, y);
               break;
             }
 
-          gtk_render_layout (context,
-                             cr,
-                             x,
-                             y,
-                             layout);
+          /* Adjust the title according to the subtask hierarchy */
+          string = g_string_new ("");
 
-          y += font_height;
-        }
+          for (i = 0; i < gtd_task_get_depth (tasks[j]); i++)
+            g_string_append (string, "    ");
+
+          g_string_append (string, gtd_task_get_title (tasks[j]));
 
-      g_list_free (tasks);
+          thumbnail_snapshot_add_run (snapshot, g_string_free (string, FALSE), x, y);
+
+          y += row_height;
+        }
     }
   else
     {
@@ -227,85 +359,324 @@ gtd_list_selector_grid_item__render_thumbnail (GtdListSelectorGridItem *item)
        * If there's no task available, draw a "No tasks" string at
        * the middle of the list thumbnail.
        */
-      gdouble y;
-      gint font_height;
-
-      pango_layout_set_text (layout,
-                             _("No tasks"),
-                             -1);
-      pango_layout_set_alignment (layout, PANGO_ALIGN_CENTER);
-      pango_layout_get_pixel_size (layout,
-                                   NULL,
-                                   &font_height);
-
-      y = (THUMBNAIL_SIZE - font_height) * scale_factor / 2.0;
-
-      gtk_render_layout (context,
-                         cr,
-                         margin.left,
-                         y,
-                         layout);
+      snapshot->alignment = PANGO_ALIGN_CENTER;
+
+      thumbnail_snapshot_add_run (snapshot,
+                                  g_strdup (_("No tasks")),
+                                  margin.left,
+                                  (THUMBNAIL_SIZE - row_height) * scale_factor / 2.0);
     }
 
-  pango_font_description_free (font_desc);
-  g_object_unref (layout);
+  gdk_rgba_free (color);
+  g_free (tasks);
+
+  return snapshot;
+}
+
+static void
+render_thumbnail_in_thread (GTask        *task,
+                            gpointer      source_object,
+                            gpointer      task_data,
+                            GCancellable *cancellable)
+{
+  ThumbnailSnapshot *snapshot;
+  cairo_surface_t *surface;
+  PangoContext *pango_context;
+  PangoLayout *layout;
+  cairo_t *cr;
+  guint i;
+
+  snapshot = task_data;
+  surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32,
+                                        snapshot->size,
+                                        snapshot->size);
+  cr = cairo_create (surface);
+
+  layout = pango_cairo_create_layout (cr);
+  pango_context = pango_layout_get_context (layout);
 
-  /* Draws the selection checkbox */
-  if (item->mode == GTD_WINDOW_MODE_SELECTION)
+  pango_cairo_context_set_resolution (pango_context, snapshot->resolution);
+  pango_cairo_context_set_font_options (pango_context, snapshot->font_options);
+  pango_layout_context_changed (layout);
+
+  pango_layout_set_font_description (layout, snapshot->font_desc);
+  pango_layout_set_ellipsize (layout, PANGO_ELLIPSIZE_END);
+  pango_layout_set_width (layout, snapshot->text_width * PANGO_SCALE);
+  pango_layout_set_alignment (layout, snapshot->alignment);
+
+  gdk_cairo_set_source_rgba (cr, &snapshot->color);
+
+  for (i = 0; i < snapshot->runs->len; i++)
     {
-      gtk_style_context_add_class (context, GTK_STYLE_CLASS_CHECK);
+      TextRun *run = &g_array_index (snapshot->runs, TextRun, i);
 
-      if (item->selected)
-        gtk_style_context_set_state (context, GTK_STATE_FLAG_CHECKED);
+      if (g_cancellable_is_cancelled (cancellable))
+        break;
 
-      gtk_render_check (context,
-                        cr,
-                        THUMBNAIL_SIZE - CHECK_SIZE - padding.right - margin.right,
-                        THUMBNAIL_SIZE - CHECK_SIZE - padding.bottom,
-                        CHECK_SIZE,
-                        CHECK_SIZE);
+      pango_layout_set_text (layout, run->text, -1);
+
+      cairo_move_to (cr, run->x, run->y);
+      pango_cairo_show_layout (cr, layout);
     }
 
-  gdk_rgba_free (color);
+  g_object_unref (layout);
+  cairo_destroy (cr);
+
+  if (g_task_return_error_if_cancelled (task))
+    {
+      cairo_surface_destroy (surface);
+      return;
+    }
+
+  g_task_return_pointer (task, surface, (GDestroyNotify) cairo_surface_destroy);
+}
+
+/* The selection check needs the style context, so it's drawn here */
+static void
+gtd_list_selector_grid_item__render_check (GtdListSelectorGridItem *item,
+                                           cairo_surface_t         *surface)
+{
+  GtkStyleContext *context;
+  GtkStateFlags state;
+  GtkBorder margin;
+  GtkBorder padding;
+  cairo_t *cr;
+
+  if (item->mode != GTD_WINDOW_MODE_SELECTION)
+    return;
+
+  context = gtk_widget_get_style_context (GTK_WIDGET (item));
+  state = gtk_style_context_get_state (context);
+  cr = cairo_create (surface);
+
+  gtk_style_context_save (context);
+  gtk_style_context_add_class (context, "thumbnail");
+
+  gtk_style_context_get_margin (context,
+                                state,
+                                &margin);
+  gtk_style_context_get_padding (context,
+                                 state,
+                                 &padding);
+
+  gtk_style_context_add_class (context, GTK_STYLE_CLASS_CHECK);
+
+  if (item->selected)
+    gtk_style_context_set_state (context, GTK_STATE_FLAG_CHECKED);
+
+  gtk_render_check (context,
+                    cr,
+                    THUMBNAIL_SIZE - CHECK_SIZE - padding.right - margin.right,
+                    THUMBNAIL_SIZE - CHECK_SIZE - padding.bottom,
+                    CHECK_SIZE,
+                    CHECK_SIZE);
 
   gtk_style_context_restore (context);
   cairo_destroy (cr);
-  return surface;
 }
 
 static void
-gtd_list_selector_grid_item__update_thumbnail (GtdListSelectorGridItem *item)
+get_thumbnail_key (GtdListSelectorGridItem *item,
+                   ThumbnailKey            *key)
+{
+  key->generation = gtd_task_list_get_generation (item->list);
+  key->scale_factor = gtk_widget_get_scale_factor (GTK_WIDGET (item));
+  key->mode = item->mode;
+  key->selected = item->selected;
+  key->state = gtk_widget_get_state_flags (GTK_WIDGET (item));
+}
+
+static gboolean
+thumbnail_key_equal (const ThumbnailKey *a,
+                     const ThumbnailKey *b)
+{
+  return a->generation == b->generation &&
+         a->scale_factor == b->scale_factor &&
+         a->mode == b->mode &&
+         a->selected == b->selected &&
+         a->state == b->state;
+}
+
+static void
+thumbnail_rendered_cb (GObject      *source_object,
+                       GAsyncResult *result,
+                       gpointer      user_data)
 {
+  GtdListSelectorGridItem *item;
   cairo_surface_t *surface;
+  GError *error;
+
+  error = NULL;
+  surface = g_task_propagate_pointer (G_TASK (result), &error);
+
+  /* The item may be gone already, don't touch it */
+  if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+    {
+      g_clear_error (&error);
+      return;
+    }
+
+  item = GTD_LIST_SELECTOR_GRID_ITEM (user_data);
+
+  g_clear_object (&item->render_cancellable);
 
-  surface = gtd_list_selector_grid_item__render_thumbnail (item);
+  if (error)
+    {
+      g_warning ("Error rendering thumbnail: %s", error->message);
+      g_clear_error (&error);
+      return;
+    }
+
+  gtd_list_selector_grid_item__render_check (item, surface);
+
+  g_clear_pointer (&item->thumbnail, cairo_surface_destroy);
 
-  gtk_image_set_from_surface (GTK_IMAGE (item->icon_image), surface);
+  item->thumbnail = surface;
+  item->thumbnail_key = item->pending_key;
 
-  cairo_surface_destroy (surface);
+  gtk_image_set_from_surface (GTK_IMAGE (item->icon_image), item->thumbnail);
+}
+
+static void
+gtd_list_selector_grid_item__update_thumbnail (GtdListSelectorGridItem *item)
+{
+  ThumbnailKey key;
+  GTask *task;
+
+  if (!item->list)
+    return;
+
+  get_thumbnail_key (item, &key);
+
+  /* Nothing changed since the last time it was rendered */
+  if (item->thumbnail && thumbnail_key_equal (&key, &item->thumbnail_key))
+    return;
+
+  /* ... or it's being rendered right now */
+  if (item->render_cancellable && thumbnail_key_equal (&key, &item->pending_key))
+    return;
+
+  /*
+   * The previous thumbnail (or the placeholder icon, at first) stays
+   * until the new one is ready.
+   */
+  if (item->render_cancellable)
+    g_cancellable_cancel (item->render_cancellable);
+
+  g_clear_object (&item->render_cancellable);
+
+  item->render_cancellable = g_cancellable_new ();
+  item->pending_key = key;
+
+  task = g_task_new (NULL, item->render_cancellable, thumbnail_rendered_cb, item);
+  g_task_set_source_tag (task, gtd_list_selector_grid_item__update_thumbnail);
+  g_task_set_task_data (task,
+                        gtd_list_selector_grid_item__capture_thumbnail (item),
+                        (GDestroyNotify) thumbnail_snapshot_free);
+
+  g_task_run_in_thread (task, render_thumbnail_in_thread);
+
+  g_object_unref (task);
+}
+
+static void
+vadjustment_value_changed_cb (GtdListSelectorGridItem *item)
+{
+  if (item->thumbnail_deferred)
+    gtd_list_selector_grid_item__queue_update_thumbnail (item);
+}
+
+/*
+ * Whether the item is inside the visible area of the viewport it is
+ * scrolled in. The adjustment of the viewport is tracked, so deferred
+ * thumbnails are rendered as soon as the item is scrolled into view.
+ */
+static gboolean
+gtd_list_selector_grid_item__is_on_screen (GtdListSelectorGridItem *item)
+{
+  GtkAllocation allocation;
+  GtkAdjustment *vadjustment;
+  GtkWidget *viewport;
+  gint x, y;
+
+  viewport = gtk_widget_get_ancestor (GTK_WIDGET (item), GTK_TYPE_VIEWPORT);
+
+  if (!viewport)
+    return TRUE;
+
+  vadjustment = gtk_scrollable_get_vadjustment (GTK_SCROLLABLE (viewport));
+
+  if (item->vadjustment != vadjustment)
+    {
+      if (item->vadjustment)
+        g_signal_handlers_disconnect_by_func (item->vadjustment, vadjustment_value_changed_cb, item);
+
+      g_set_object (&item->vadjustment, vadjustment);
+
+      if (vadjustment)
+        {
+          g_signal_connect_object (vadjustment,
+                                   "value-changed",
+                                   G_CALLBACK (vadjustment_value_changed_cb),
+                                   item,
+                                   G_CONNECT_SWAPPED);
+        }
+    }
+
+  if (!gtk_widget_translate_coordinates (GTK_WIDGET (item), viewport, 0, 0, &x, &y))
+    return TRUE;
+
+  gtk_widget_get_allocation (GTK_WIDGET (item), &allocation);
+
+  return y + allocation.height > 0 && y < gtk_widget_get_allocated_height (viewport);
+}
+
+static gboolean
+update_thumbnail_cb (GtkWidget     *widget,
+                     GdkFrameClock *frame_clock,
+                     gpointer       user_data)
+{
+  GtdListSelectorGridItem *item = GTD_LIST_SELECTOR_GRID_ITEM (widget);
+
+  item->update_thumbnail_id = 0;
+
+  /* Items out of sight keep their current thumbnail until they're shown */
+  item->thumbnail_deferred = !gtd_list_selector_grid_item__is_on_screen (item);
+
+  if (!item->thumbnail_deferred)
+    gtd_list_selector_grid_item__update_thumbnail (item);
+
+  return G_SOURCE_REMOVE;
+}
+
+/*
+ * Changes are coalesced and the thumbnail is rendered at most once per
+ * frame, and only while the item is realized and on screen.
+ */
+static void
+gtd_list_selector_grid_item__queue_update_thumbnail (GtdListSelectorGridItem *item)
+{
+  if (item->update_thumbnail_id > 0)
+    return;
+
+  item->update_thumbnail_id = gtk_widget_add_tick_callback (GTK_WIDGET (item),
+                                                            update_thumbnail_cb,
+                                                            NULL,
+                                                            NULL);
 }
 
 static void
 color_changed (GtdListSelectorGridItem *self)
 {
   GdkRGBA *color;
-  gchar *color_str, *css;
 
   color = gtd_task_list_get_color (self->list);
-  color_str = gdk_rgba_to_string (color);
-  css = g_strdup_printf ("grid-item image { background-color: %s; }", color_str);
-
-  gtk_css_provider_load_from_data (self->css_provider,
-                                   css,
-                                   -1,
-                                   NULL);
 
-  gtd_list_selector_grid_item__update_thumbnail (self);
+  gtd_color_style_apply (GTK_WIDGET (self->icon_image), color);
 
+  gtd_list_selector_grid_item__queue_update_thumbnail (self);
 
-  g_clear_pointer (&color_str, g_free);
   g_clear_pointer (&color, gdk_rgba_free);
-  g_clear_pointer (&css, g_free);
 }
 
 static void
@@ -313,8 +684,7 @@ gtd_list_selector_grid_item__task_changed (GtdTaskList *list,
                                            GtdTask     *task,
                                            gpointer     user_data)
 {
-  if (!gtd_task_get_complete (task))
-    gtd_list_selector_grid_item__update_thumbnail (GTD_LIST_SELECTOR_GRID_ITEM (user_data));
+  gtd_list_selector_grid_item__queue_update_thumbnail (GTD_LIST_SELECTOR_GRID_ITEM (user_data));
 }
 
 static void
@@ -322,7 +692,7 @@ gtd_list_selector_grid_item__notify_ready (GtdListSelectorGridItem *item,
                                   GParamSpec      *pspec,
                                   gpointer         user_data)
 {
-  gtd_list_selector_grid_item__update_thumbnail (item);
+  gtd_list_selector_grid_item__queue_update_thumbnail (item);
 }
 
 GtkWidget*
@@ -387,7 +757,7 @@ gtd_list_selector_grid_item_state_flags_changed (GtkWidget     *item,
    */
 
   if (self->list)
-    gtd_list_selector_grid_item__update_thumbnail (GTD_LIST_SELECTOR_GRID_ITEM (item));
+    gtd_list_selector_grid_item__queue_update_thumbnail (self);
 }
 
 static GtdTaskList*
@@ -420,7 +790,7 @@ gtd_list_selector_grid_item_set_selected (GtdListSelectorItem *item,
     {
       self->selected = selected;
 
-      gtd_list_selector_grid_item__update_thumbnail (self);
+      gtd_list_selector_grid_item__queue_update_thumbnail (self);
 
       g_object_notify (G_OBJECT (item), "selected");
     }
@@ -439,7 +809,7 @@ gtd_list_selector_grid_item_finalize (GObject *object)
 {
   GtdListSelectorGridItem *self = GTD_LIST_SELECTOR_GRID_ITEM (object);
 
-  g_clear_object (&self->css_provider);
+  g_clear_pointer (&self->thumbnail, cairo_surface_destroy);
 
   G_OBJECT_CLASS (gtd_list_selector_grid_item_parent_class)->finalize (object);
 }
@@ -449,6 +819,18 @@ gtd_list_selector_grid_item_dispose (GObject *object)
 {
   GtdListSelectorGridItem *self = GTD_LIST_SELECTOR_GRID_ITEM (object);
 
+  if (self->vadjustment)
+    {
+      g_signal_handlers_disconnect_by_func (self->vadjustment, vadjustment_value_changed_cb, self);
+      g_clear_object (&self->vadjustment);
+    }
+
+  if (self->render_cancellable)
+    {
+      g_cancellable_cancel (self->render_cancellable);
+      g_clear_object (&self->render_cancellable);
+    }
+
   if (self->list)
     {
       g_signal_handlers_disconnect_by_func (self->list,
@@ -506,7 +888,7 @@ gtd_list_selector_grid_item_set_property (GObject      *object,
     {
     case PROP_MODE:
       self->mode = g_value_get_enum (value);
-      gtd_list_selector_grid_item__update_thumbnail (self);
+      gtd_list_selector_grid_item__queue_update_thumbnail (self);
       g_object_notify (object, "mode");
       break;
 
@@ -570,6 +952,19 @@ gtd_list_selector_grid_item_set_property (GObject      *object,
     }
 }
 
+static void
+gtd_list_selector_grid_item_size_allocate (GtkWidget     *widget,
+                                           GtkAllocation *allocation)
+{
+  GtdListSelectorGridItem *self = GTD_LIST_SELECTOR_GRID_ITEM (widget);
+
+  GTK_WIDGET_CLASS (gtd_list_selector_grid_item_parent_class)->size_allocate (widget, allocation);
+
+  /* Filtering and resizing may bring the item into view */
+  if (self->thumbnail_deferred)
+    gtd_list_selector_grid_item__queue_update_thumbnail (self);
+}
+
 static void
 gtd_list_selector_grid_item_class_init (GtdListSelectorGridItemClass *klass)
 {
@@ -581,6 +976,7 @@ gtd_list_selector_grid_item_class_init (GtdListSelectorGridItemClass *klass)
   object_class->get_property = gtd_list_selector_grid_item_get_property;
   object_class->set_property = gtd_list_selector_grid_item_set_property;
 
+  widget_class->size_allocate = gtd_list_selector_grid_item_size_allocate;
   widget_class->state_flags_changed = gtd_list_selector_grid_item_state_flags_changed;
 
   /**
@@ -628,10 +1024,8 @@ gtd_list_selector_grid_item_init (GtdListSelectorGridItem *self)
 {
   gtk_widget_init_template (GTK_WIDGET (self));
 
-  /* CSS provider */
-  self->css_provider = gtk_css_provider_new ();
-
-  gtk_style_context_add_provider (gtk_widget_get_style_context (GTK_WIDGET (self->icon_image)),
-                                  GTK_STYLE_PROVIDER (self->css_provider),
-                                  GTK_STYLE_PROVIDER_PRIORITY_APPLICATION + 2);
+  g_signal_connect_swapped (self,
+                            "notify::scale-factor",
+                            G_CALLBACK (gtd_list_selector_grid_item__queue_update_thumbnail),
+                            self);
 }
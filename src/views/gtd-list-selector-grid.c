@@ -16,19 +16,18 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include "interfaces/gtd-provider.h"
 #include "gtd-list-selector.h"
 #include "gtd-list-selector-grid.h"
 #include "gtd-list-selector-grid-item.h"
 #include "gtd-list-selector-item.h"
-#include "gtd-manager.h"
+#include "gtd-list-selector-model.h"
 #include "gtd-task-list.h"
 
 struct _GtdListSelectorGrid
 {
   GtkFlowBox          parent;
 
-  gchar              *search_query;
+  GtdListSelectorModel *model;
 
   GtdWindowMode       mode;
 };
@@ -47,10 +46,9 @@ enum {
   N_PROPS
 };
 
-static void
-gtd_list_selector_grid_list_added (GtdManager          *manager,
-                                   GtdTaskList         *list,
-                                   GtdListSelectorGrid *selector)
+static GtkWidget*
+create_item_func (GtdTaskList         *list,
+                  GtdListSelectorGrid *selector)
 {
   GtkWidget *item;
 
@@ -62,106 +60,22 @@ gtd_list_selector_grid_list_added (GtdManager          *manager,
                           "mode",
                           G_BINDING_BIDIRECTIONAL | G_BINDING_SYNC_CREATE);
 
-  gtk_widget_show (item);
-
-  gtk_flow_box_insert (GTK_FLOW_BOX (selector),
-                       item,
-                       -1);
+  return item;
 }
 
 static void
-gtd_list_selector_grid_list_removed (GtdManager          *manager,
-                                     GtdTaskList         *list,
-                                     GtdListSelectorGrid *selector)
-{
-  GList *children;
-  GList *l;
-
-  children = gtk_container_get_children (GTK_CONTAINER (selector));
-
-  for (l = children; l != NULL; l = l->next)
-    {
-      if (gtd_list_selector_item_get_list (l->data) == list)
-        gtk_widget_destroy (l->data);
-    }
-
-  g_list_free (children);
-}
-
-static gint
-gtd_list_selector_grid_sort_func (GtdListSelectorItem *a,
-                                  GtdListSelectorItem *b,
-                                  GtdListSelectorGrid *selector)
-{
-  GtdProvider *p1;
-  GtdProvider *p2;
-  GtdTaskList *l1;
-  GtdTaskList *l2;
-  gchar *name1;
-  gchar *name2;
-  gint retval = 0;
-
-  l1 = gtd_list_selector_item_get_list (a);
-  p1 = gtd_task_list_get_provider (l1);
-
-  l2 = gtd_list_selector_item_get_list (b);
-  p2 = gtd_task_list_get_provider (l2);
-
-  retval = g_strcmp0 (gtd_provider_get_description (p1), gtd_provider_get_description (p2));
-
-  if (retval != 0)
-    return retval;
-
-  name1 = g_utf8_casefold (gtd_task_list_get_name (l1), -1);
-  name2 = g_utf8_casefold (gtd_task_list_get_name (l2), -1);
-
-  retval = g_strcmp0 (name1, name2);
-
-  g_free (name1);
-  g_free (name2);
-
-  return retval;
-}
-
-static gboolean
-gtd_list_selector_grid_filter_func (GtdListSelectorItem *item,
-                                    GtdListSelectorGrid *selector)
+items_changed_cb (GListModel          *model,
+                  guint                position,
+                  guint                removed,
+                  guint                added,
+                  GtdListSelectorGrid *selector)
 {
-  GtdTaskList *list;
-  gboolean return_value;
-  gchar *search_folded;
-  gchar *list_name_folded;
-  gchar *haystack;
-
   /*
-   * When no search query is set, we obviously don't
-   * filter out anything.
+   * Items filtered out lose their selection, so let the panel
+   * update the actions of the current selection.
    */
-  if (!selector->search_query)
-    return TRUE;
-
-  list = gtd_list_selector_item_get_list (item);
-  haystack = NULL;
-  search_folded = g_utf8_casefold (selector->search_query, -1);
-  list_name_folded = g_utf8_casefold (gtd_task_list_get_name (list), -1);
-
-  if (!search_folded || search_folded[0] == '\0')
-    {
-      return_value = TRUE;
-      goto out;
-    }
-
-  haystack = g_strstr_len (list_name_folded,
-                           -1,
-                           search_folded);
-
-  return_value = (haystack != NULL);
-
-out:
-  g_free (search_folded);
-  g_free (list_name_folded);
-
-  return return_value;
+  if (removed > 0 && selector->mode == GTD_WINDOW_MODE_SELECTION)
+    g_signal_emit_by_name (selector, "list-selected", NULL);
 }
 
 /******************************
@@ -207,7 +121,7 @@ gtd_list_selector_grid_get_search_query (GtdListSelector *selector)
 {
   g_return_val_if_fail (GTD_IS_LIST_SELECTOR_GRID (selector), NULL);
 
-  return GTD_LIST_SELECTOR_GRID (selector)->search_query;
+  return gtd_list_selector_model_get_search_query (GTD_LIST_SELECTOR_GRID (selector)->model);
 }
 
 static void
@@ -220,12 +134,9 @@ gtd_list_selector_grid_set_search_query (GtdListSelector *selector,
 
   self = GTD_LIST_SELECTOR_GRID (selector);
 
-  if (g_strcmp0 (self->search_query, search_query) != 0)
+  if (g_strcmp0 (gtd_list_selector_model_get_search_query (self->model), search_query) != 0)
     {
-      g_clear_pointer (&self->search_query, g_free);
-      self->search_query = g_strdup (search_query);
-
-      gtk_flow_box_invalidate_filter (GTK_FLOW_BOX (self));
+      gtd_list_selector_model_set_search_query (self->model, search_query);
 
       g_object_notify (G_OBJECT (self), "search-query");
     }
@@ -268,7 +179,7 @@ gtd_list_selector_grid_finalize (GObject *object)
 {
   GtdListSelectorGrid *self = (GtdListSelectorGrid *)object;
 
-  g_clear_pointer (&self->search_query, g_free);
+  g_clear_object (&self->model);
 
   G_OBJECT_CLASS (gtd_list_selector_grid_parent_class)->finalize (object);
 }
@@ -288,7 +199,7 @@ gtd_list_selector_grid_get_property (GObject    *object,
       break;
 
     case PROP_SEARCH_QUERY:
-      g_value_set_string (value, self->search_query);
+      g_value_set_string (value, gtd_list_selector_model_get_search_query (self->model));
       break;
 
     default:
@@ -366,45 +277,26 @@ gtd_list_selector_grid_class_init (GtdListSelectorGridClass *klass)
 static void
 gtd_list_selector_grid_init (GtdListSelectorGrid *self)
 {
-  GtdManager *manager;
   GtkFlowBox *flowbox;
   GtkWidget *widget;
-  GList *lists;
-  GList *l;
-
-  manager = gtd_manager_get_default ();
-
-  g_signal_connect (manager,
-                    "list-added",
-                    G_CALLBACK (gtd_list_selector_grid_list_added),
-                    self);
-  g_signal_connect (manager,
-                    "list-removed",
-                    G_CALLBACK (gtd_list_selector_grid_list_removed),
-                    self);
 
-  /* Add already loaded lists */
-  lists = gtd_manager_get_task_lists (manager);
-
-  for (l = lists; l != NULL; l = l->next)
-    {
-      gtd_list_selector_grid_list_added (manager,
-                                         l->data,
-                                         self);
-    }
+  /*
+   * The box only has items for the lists matching the search query,
+   * already sorted by the model.
+   */
+  self->model = gtd_list_selector_model_new ();
 
-  g_list_free (lists);
+  g_signal_connect_after (self->model,
+                          "items-changed",
+                          G_CALLBACK (items_changed_cb),
+                          self);
 
-  /* Setup filter and sorting functions */
-  gtk_flow_box_set_sort_func (GTK_FLOW_BOX (self),
-                              (GtkFlowBoxSortFunc) gtd_list_selector_grid_sort_func,
-                              NULL,
-                              NULL);
+  gtk_flow_box_bind_model (GTK_FLOW_BOX (self),
+                           G_LIST_MODEL (self->model),
+                           (GtkFlowBoxCreateWidgetFunc) create_item_func,
+                           self,
+                           NULL);
 
-  gtk_flow_box_set_filter_func (GTK_FLOW_BOX (self),
-                                (GtkFlowBoxFilterFunc) gtd_list_selector_grid_filter_func,
-                                self,
-                                NULL);
   /* Setup some properties */
   widget = GTK_WIDGET (self);
   flowbox = GTK_FLOW_BOX (self);
@@ -39,8 +39,25 @@ struct _GtdListSelectorListItem
   /* data */
   GtdTaskList        *list;
   GtdWindowMode       mode;
+
+  guint               update_thumbnail_id;
+  guint               thumbnail_serial;
 };
 
+/*
+ * The thumbnail only depends on the color of the list, and many lists
+ * share the same color, so they're rendered once per color and scale
+ * factor and shared between all the items. Maps "color@scale" →
+ * cairo_surface_t. The tiles are drawn with a stateless style context,
+ * so a hovered or selected item doesn't leak into them, and everything
+ * is dropped once when the theme changes; items then see a new
+ * thumbnail_serial and render again.
+ */
+static GHashTable      *thumbnail_cache = NULL;
+static GtkStyleContext *thumbnail_context = NULL;
+static GtkSettings     *thumbnail_settings = NULL;
+static guint            thumbnail_serial = 1;
+
 
 static void          gtd_list_selector_item_iface_init           (GtdListSelectorItemInterface *iface);
 
@@ -110,6 +127,67 @@ leave_notify_event (GtkWidget               *widget,
   return GDK_EVENT_PROPAGATE;
 }
 
+static void
+thumbnail_theme_changed_cb (GtkSettings *settings,
+                            GParamSpec  *pspec,
+                            gpointer     user_data)
+{
+  if (thumbnail_cache)
+    g_hash_table_remove_all (thumbnail_cache);
+
+  g_clear_object (&thumbnail_context);
+  thumbnail_serial++;
+}
+
+/* Follows the theme of the screen the items are on */
+static void
+ensure_thumbnail_settings (GtdListSelectorListItem *item)
+{
+  GtkSettings *settings;
+
+  settings = gtk_widget_get_settings (GTK_WIDGET (item));
+
+  if (settings == thumbnail_settings)
+    return;
+
+  if (thumbnail_settings)
+    g_signal_handlers_disconnect_by_func (thumbnail_settings, thumbnail_theme_changed_cb, NULL);
+
+  thumbnail_settings = settings;
+
+  g_signal_connect (settings, "notify::gtk-theme-name", G_CALLBACK (thumbnail_theme_changed_cb), NULL);
+  g_signal_connect (settings, "notify::gtk-application-prefer-dark-theme", G_CALLBACK (thumbnail_theme_changed_cb), NULL);
+
+  thumbnail_theme_changed_cb (settings, NULL, NULL);
+}
+
+static GtkStyleContext*
+get_thumbnail_context (GtdListSelectorListItem *item)
+{
+  if (!thumbnail_context)
+    {
+      GtkWidgetPath *path;
+
+      path = gtk_widget_path_new ();
+
+      gtk_widget_path_append_type (path, GTK_TYPE_WINDOW);
+      gtk_widget_path_iter_set_object_name (path, -1, "window");
+      gtk_widget_path_append_type (path, GTK_TYPE_LIST_BOX);
+      gtk_widget_path_iter_set_object_name (path, -1, "list");
+      gtk_widget_path_append_type (path, GTD_TYPE_LIST_SELECTOR_LIST_ITEM);
+      gtk_widget_path_iter_set_object_name (path, -1, "row");
+      gtk_widget_path_iter_add_class (path, -1, "thumbnail");
+
+      thumbnail_context = gtk_style_context_new ();
+      gtk_style_context_set_path (thumbnail_context, path);
+      gtk_style_context_set_screen (thumbnail_context, gtk_widget_get_screen (GTK_WIDGET (item)));
+
+      gtk_widget_path_unref (path);
+    }
+
+  return thumbnail_context;
+}
+
 static cairo_surface_t*
 gtd_list_selector_list_item__render_thumbnail (GtdListSelectorListItem *item)
 {
@@ -120,23 +198,23 @@ gtd_list_selector_list_item__render_thumbnail (GtdListSelectorListItem *item)
   cairo_t *cr;
   gint width;
   gint height;
+  gint scale;
 
   list = item->list;
   gtk_widget_get_size_request (item->thumbnail_image,
                                &width,
                                &height);
-  context = gtk_widget_get_style_context (GTK_WIDGET (item));
+  scale = gtk_widget_get_scale_factor (GTK_WIDGET (item));
+  context = get_thumbnail_context (item);
   surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32,
-                                        width,
-                                        height);
+                                        width * scale,
+                                        height * scale);
+  cairo_surface_set_device_scale (surface, scale, scale);
   cr = cairo_create (surface);
 
   /* Draw the list's background color */
   color = gtd_task_list_get_color (list);
 
-  gtk_style_context_save (context);
-  gtk_style_context_add_class (context, "thumbnail");
-
   gtk_render_background (context,
                          cr,
                          4.0,
@@ -159,7 +237,6 @@ gtd_list_selector_list_item__render_thumbnail (GtdListSelectorListItem *item)
 
   cairo_fill (cr);
 
-  gtk_style_context_restore (context);
   gdk_rgba_free (color);
   cairo_destroy (cr);
 
@@ -170,12 +247,73 @@ static void
 gtd_list_selector_list_item__update_thumbnail (GtdListSelectorListItem *item)
 {
   cairo_surface_t *surface;
+  GdkRGBA *color;
+  gchar *color_str;
+  gchar *key;
+
+  ensure_thumbnail_settings (item);
+
+  item->thumbnail_serial = thumbnail_serial;
+
+  if (!thumbnail_cache)
+    {
+      thumbnail_cache = g_hash_table_new_full (g_str_hash,
+                                               g_str_equal,
+                                               g_free,
+                                               (GDestroyNotify) cairo_surface_destroy);
+    }
 
-  surface = gtd_list_selector_list_item__render_thumbnail (item);
+  color = gtd_task_list_get_color (item->list);
+  color_str = gdk_rgba_to_string (color);
+  key = g_strdup_printf ("%s@%d", color_str, gtk_widget_get_scale_factor (GTK_WIDGET (item)));
+  surface = g_hash_table_lookup (thumbnail_cache, key);
+
+  if (!surface)
+    {
+      surface = gtd_list_selector_list_item__render_thumbnail (item);
+      g_hash_table_insert (thumbnail_cache, g_strdup (key), surface);
+    }
 
   gtk_image_set_from_surface (GTK_IMAGE (item->thumbnail_image), surface);
 
-  cairo_surface_destroy (surface);
+  gdk_rgba_free (color);
+  g_free (color_str);
+  g_free (key);
+}
+
+static gboolean
+update_thumbnail_cb (GtkWidget     *widget,
+                     GdkFrameClock *frame_clock,
+                     gpointer       user_data)
+{
+  GtdListSelectorListItem *item = GTD_LIST_SELECTOR_LIST_ITEM (widget);
+
+  item->update_thumbnail_id = 0;
+
+  gtd_list_selector_list_item__update_thumbnail (item);
+
+  return G_SOURCE_REMOVE;
+}
+
+/* Items only get their thumbnail once they're about to be drawn */
+static void
+gtd_list_selector_list_item__queue_update_thumbnail (GtdListSelectorListItem *item)
+{
+  if (item->update_thumbnail_id > 0)
+    return;
+
+  item->update_thumbnail_id = gtk_widget_add_tick_callback (GTK_WIDGET (item),
+                                                            update_thumbnail_cb,
+                                                            NULL,
+                                                            NULL);
+}
+
+/* Scale factor changes only need another tile from the cache */
+static void
+scale_factor_changed_cb (GtdListSelectorListItem *item)
+{
+  if (item->list)
+    gtd_list_selector_list_item__queue_update_thumbnail (item);
 }
 
 static GtdTaskList*
@@ -212,8 +350,6 @@ gtd_list_selector_list_item_set_selected (GtdListSelectorItem *item,
     {
       gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (self->selection_check), selected);
 
-      gtd_list_selector_list_item__update_thumbnail (self);
-
       g_object_notify (G_OBJECT (item), "selected");
     }
 }
@@ -309,12 +445,13 @@ gtd_list_selector_list_item_set_property (GObject      *object,
                               "active",
                               G_BINDING_DEFAULT | G_BINDING_INVERT_BOOLEAN | G_BINDING_SYNC_CREATE);
 
-      g_signal_connect_swapped (self->list,
-                                "notify::color",
-                                G_CALLBACK (gtd_list_selector_list_item__update_thumbnail),
-                                self);
+      g_signal_connect_object (self->list,
+                               "notify::color",
+                               G_CALLBACK (gtd_list_selector_list_item__queue_update_thumbnail),
+                               self,
+                               G_CONNECT_SWAPPED);
 
-      gtd_list_selector_list_item__update_thumbnail (self);
+      gtd_list_selector_list_item__queue_update_thumbnail (self);
       break;
 
     default:
@@ -322,6 +459,30 @@ gtd_list_selector_list_item_set_property (GObject      *object,
     }
 }
 
+static void
+gtd_list_selector_list_item_screen_changed (GtkWidget *widget,
+                                            GdkScreen *previous_screen)
+{
+  if (GTK_WIDGET_CLASS (gtd_list_selector_list_item_parent_class)->screen_changed)
+    GTK_WIDGET_CLASS (gtd_list_selector_list_item_parent_class)->screen_changed (widget, previous_screen);
+
+  /* Rendering the thumbnail picks up the settings of the new screen */
+  if (GTD_LIST_SELECTOR_LIST_ITEM (widget)->list)
+    gtd_list_selector_list_item__queue_update_thumbnail (GTD_LIST_SELECTOR_LIST_ITEM (widget));
+}
+
+static void
+gtd_list_selector_list_item_style_updated (GtkWidget *widget)
+{
+  GtdListSelectorListItem *self = GTD_LIST_SELECTOR_LIST_ITEM (widget);
+
+  GTK_WIDGET_CLASS (gtd_list_selector_list_item_parent_class)->style_updated (widget);
+
+  /* Only the theme changes the tiles, not the state of the item */
+  if (self->list && self->thumbnail_serial != thumbnail_serial)
+    gtd_list_selector_list_item__queue_update_thumbnail (self);
+}
+
 static void
 gtd_list_selector_list_item_class_init (GtdListSelectorListItemClass *klass)
 {
@@ -331,6 +492,9 @@ gtd_list_selector_list_item_class_init (GtdListSelectorListItemClass *klass)
   object_class->get_property = gtd_list_selector_list_item_get_property;
   object_class->set_property = gtd_list_selector_list_item_set_property;
 
+  widget_class->screen_changed = gtd_list_selector_list_item_screen_changed;
+  widget_class->style_updated = gtd_list_selector_list_item_style_updated;
+
   /**
    * GtdListSelectorListItem::mode:
    *
@@ -383,6 +547,11 @@ gtd_list_selector_list_item_init (GtdListSelectorListItem *self)
                           self,
                           "selected",
                           G_BINDING_BIDIRECTIONAL);
+
+  g_signal_connect (self,
+                    "notify::scale-factor",
+                    G_CALLBACK (scale_factor_changed_cb),
+                    NULL);
 }
 
 GtkWidget*
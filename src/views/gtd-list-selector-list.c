@@ -16,19 +16,18 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include "interfaces/gtd-provider.h"
 #include "gtd-list-selector.h"
 #include "gtd-list-selector-item.h"
 #include "gtd-list-selector-list.h"
 #include "gtd-list-selector-list-item.h"
-#include "gtd-manager.h"
+#include "gtd-list-selector-model.h"
 #include "gtd-task-list.h"
 
 struct _GtdListSelectorList
 {
   GtkListBox          parent;
 
-  gchar              *search_query;
+  GtdListSelectorModel *model;
 
   GtdWindowMode       mode;
 
@@ -74,10 +73,9 @@ on_click (GtdListSelectorList  *selector,
   return GDK_EVENT_PROPAGATE;
 }
 
-static void
-gtd_list_selector_list_list_added (GtdManager          *manager,
-                                   GtdTaskList         *list,
-                                   GtdListSelectorList *selector)
+static GtkWidget*
+create_item_func (GtdTaskList         *list,
+                  GtdListSelectorList *selector)
 {
   GtkWidget *item;
 
@@ -106,115 +104,22 @@ gtd_list_selector_list_list_added (GtdManager          *manager,
                     G_CALLBACK (on_row_selected),
                     selector);
 
-  /*
-   * In order to determine if a user held control when left-clicking
-   * a list item we capture the button event here and check for
-   * the control mask. The event is always propagated.
-   */
-  g_signal_connect (selector,
-                    "button-press-event",
-                    G_CALLBACK (on_click),
-                    NULL);
-
-  gtk_widget_show (item);
-
-  gtk_container_add (GTK_CONTAINER (selector), item);
+  return item;
 }
 
-
 static void
-gtd_list_selector_list_list_removed (GtdManager          *manager,
-                                     GtdTaskList         *list,
-                                     GtdListSelectorList *selector)
-{
-  GList *children;
-  GList *l;
-
-  children = gtk_container_get_children (GTK_CONTAINER (selector));
-
-  for (l = children; l != NULL; l = l->next)
-    {
-      if (gtd_list_selector_item_get_list (l->data) == list)
-        gtk_widget_destroy (l->data);
-    }
-
-  g_list_free (children);
-}
-
-static gint
-sort_func (GtdListSelectorItem *a,
-           GtdListSelectorItem *b,
-           GtdListSelectorList *selector)
-{
-  GtdProvider *p1;
-  GtdProvider *p2;
-  GtdTaskList *l1;
-  GtdTaskList *l2;
-  gchar *name1;
-  gchar *name2;
-  gint retval = 0;
-
-  l1 = gtd_list_selector_item_get_list (a);
-  p1 = gtd_task_list_get_provider (l1);
-
-  l2 = gtd_list_selector_item_get_list (b);
-  p2 = gtd_task_list_get_provider (l2);
-
-  retval = g_strcmp0 (gtd_provider_get_description (p1), gtd_provider_get_description (p2));
-
-  if (retval != 0)
-    return retval;
-
-  name1 = g_utf8_casefold (gtd_task_list_get_name (l1), -1);
-  name2 = g_utf8_casefold (gtd_task_list_get_name (l2), -1);
-
-  retval = g_strcmp0 (name1, name2);
-
-  g_free (name1);
-  g_free (name2);
-
-  return retval;
-}
-
-static gboolean
-filter_func (GtdListSelectorItem *item,
-             GtdListSelectorList *selector)
+items_changed_cb (GListModel          *model,
+                  guint                position,
+                  guint                removed,
+                  guint                added,
+                  GtdListSelectorList *selector)
 {
-  GtdTaskList *list;
-  gboolean return_value;
-  gchar *search_folded;
-  gchar *list_name_folded;
-  gchar *haystack;
-
   /*
-   * When no search query is set, we obviously don't
-   * filter out anything.
+   * Items filtered out lose their selection, so let the panel
+   * update the actions of the current selection.
    */
-  if (!selector->search_query)
-    return TRUE;
-
-  list = gtd_list_selector_item_get_list (item);
-  haystack = NULL;
-  search_folded = g_utf8_casefold (selector->search_query, -1);
-  list_name_folded = g_utf8_casefold (gtd_task_list_get_name (list), -1);
-
-  if (!search_folded || search_folded[0] == '\0')
-    {
-      return_value = TRUE;
-      goto out;
-    }
-
-  haystack = g_strstr_len (list_name_folded,
-                           -1,
-                           search_folded);
-
-  return_value = (haystack != NULL);
-
-out:
-  g_free (search_folded);
-  g_free (list_name_folded);
-
-  return return_value;
+  if (removed > 0 && selector->mode == GTD_WINDOW_MODE_SELECTION)
+    g_signal_emit_by_name (selector, "list-selected", NULL);
 }
 
 static void
@@ -276,7 +181,7 @@ gtd_list_selector_list_get_search_query (GtdListSelector *selector)
 {
   g_return_val_if_fail (GTD_IS_LIST_SELECTOR_LIST (selector), NULL);
 
-  return GTD_LIST_SELECTOR_LIST (selector)->search_query;
+  return gtd_list_selector_model_get_search_query (GTD_LIST_SELECTOR_LIST (selector)->model);
 }
 
 static void
@@ -289,12 +194,9 @@ gtd_list_selector_list_set_search_query (GtdListSelector *selector,
 
   self = GTD_LIST_SELECTOR_LIST (selector);
 
-  if (g_strcmp0 (self->search_query, search_query) != 0)
+  if (g_strcmp0 (gtd_list_selector_model_get_search_query (self->model), search_query) != 0)
     {
-      g_clear_pointer (&self->search_query, g_free);
-      self->search_query = g_strdup (search_query);
-
-      gtk_list_box_invalidate_filter (GTK_LIST_BOX (self));
+      gtd_list_selector_model_set_search_query (self->model, search_query);
 
       g_object_notify (G_OBJECT (self), "search-query");
     }
@@ -337,7 +239,7 @@ gtd_list_selector_list_finalize (GObject *object)
 {
   GtdListSelectorList *self = (GtdListSelectorList *)object;
 
-  g_clear_pointer (&self->search_query, g_free);
+  g_clear_object (&self->model);
 
   G_OBJECT_CLASS (gtd_list_selector_list_parent_class)->finalize (object);
 }
@@ -357,7 +259,7 @@ gtd_list_selector_list_get_property (GObject    *object,
       break;
 
     case PROP_SEARCH_QUERY:
-      g_value_set_string (value, self->search_query);
+      g_value_set_string (value, gtd_list_selector_model_get_search_query (self->model));
       break;
 
     default:
@@ -437,50 +339,41 @@ gtd_list_selector_list_class_init (GtdListSelectorListClass *klass)
 static void
 gtd_list_selector_list_init (GtdListSelectorList *self)
 {
-  GtdManager *manager;
   GtkWidget *widget;
-  GList *lists;
-  GList *l;
 
-  manager = gtd_manager_get_default ();
-
-  g_signal_connect (manager,
-                    "list-added",
-                    G_CALLBACK (gtd_list_selector_list_list_added),
-                    self);
-  g_signal_connect (manager,
-                    "list-removed",
-                    G_CALLBACK (gtd_list_selector_list_list_removed),
-                    self);
+  /*
+   * The box only has rows for the lists matching the search query,
+   * already sorted by the model.
+   */
+  self->model = gtd_list_selector_model_new ();
 
-  /* Add already loaded lists */
-  lists = gtd_manager_get_task_lists (manager);
+  g_signal_connect_after (self->model,
+                          "items-changed",
+                          G_CALLBACK (items_changed_cb),
+                          self);
 
-  for (l = lists; l != NULL; l = l->next)
-    {
-      gtd_list_selector_list_list_added (manager,
-                                         l->data,
-                                         self);
-    }
+  gtk_list_box_bind_model (GTK_LIST_BOX (self),
+                           G_LIST_MODEL (self->model),
+                           (GtkListBoxCreateWidgetFunc) create_item_func,
+                           self,
+                           NULL);
 
-  g_list_free (lists);
+  /*
+   * In order to determine if a user held control when left-clicking
+   * a list item we capture the button event here and check for
+   * the control mask. The event is always propagated.
+   */
+  g_signal_connect (self,
+                    "button-press-event",
+                    G_CALLBACK (on_click),
+                    NULL);
 
-  /* Setup header, filter and sorting functions */
+  /* Setup the header function */
   gtk_list_box_set_header_func (GTK_LIST_BOX (self),
                                 (GtkListBoxUpdateHeaderFunc) update_header_func,
                                 NULL,
                                 NULL);
 
-  gtk_list_box_set_sort_func (GTK_LIST_BOX (self),
-                              (GtkListBoxSortFunc) sort_func,
-                              NULL,
-                              NULL);
-
-  gtk_list_box_set_filter_func (GTK_LIST_BOX (self),
-                                (GtkListBoxFilterFunc) filter_func,
-                                self,
-                                NULL);
-
   /* Setup some properties */
   widget = GTK_WIDGET (self);
 
@@ -0,0 +1,562 @@
+/* gtd-list-selector-model.c
+ *
+ * Copyright (C) 2017 Georges Basile Stavracas Neto <georges.stavracas@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define G_LOG_DOMAIN "GtdListSelectorModel"
+
+#include "interfaces/gtd-provider.h"
+#include "gtd-list-selector-model.h"
+#include "gtd-manager.h"
+#include "gtd-task-list.h"
+
+#include <string.h>
+
+/*
+ * GtdListSelectorModel is a #GListModel with the task lists known by
+ * the manager, sorted by provider and name, that only exposes the lists
+ * matching the search query. Selectors bind their boxes to it, so only
+ * the matching lists have widgets and filtering never touches widgets
+ * that stay visible.
+ *
+ * The casefolded name of each list is cached, and both arrays are kept
+ * sorted, so adding, removing and looking up lists are binary searches.
+ */
+
+typedef struct
+{
+  GtdTaskList        *list;
+  gchar              *folded_name;
+} ListEntry;
+
+struct _GtdListSelectorModel
+{
+  GObject             parent;
+
+  /* Every list, and the ones matching the search query */
+  GPtrArray          *entries;
+  GPtrArray          *visible;
+
+  /* GtdTaskList → ListEntry */
+  GHashTable         *list_to_entry;
+
+  gchar              *search_query;
+  gchar              *search_folded;
+};
+
+static void          g_list_model_iface_init                     (GListModelInterface *iface);
+
+static void          list_name_changed_cb                        (GtdTaskList          *list,
+                                                                  GParamSpec           *pspec,
+                                                                  GtdListSelectorModel *self);
+
+G_DEFINE_TYPE_WITH_CODE (GtdListSelectorModel, gtd_list_selector_model, G_TYPE_OBJECT,
+                         G_IMPLEMENT_INTERFACE (G_TYPE_LIST_MODEL, g_list_model_iface_init))
+
+enum {
+  PROP_0,
+  PROP_SEARCH_QUERY,
+  N_PROPS
+};
+
+static GParamSpec *properties [N_PROPS];
+
+
+/*
+ * Entries
+ */
+
+static ListEntry*
+list_entry_new (GtdTaskList *list)
+{
+  ListEntry *entry;
+
+  entry = g_slice_new0 (ListEntry);
+  entry->list = g_object_ref (list);
+  entry->folded_name = g_utf8_casefold (gtd_task_list_get_name (list), -1);
+
+  return entry;
+}
+
+static void
+list_entry_free (ListEntry *entry)
+{
+  g_clear_object (&entry->list);
+  g_clear_pointer (&entry->folded_name, g_free);
+  g_slice_free (ListEntry, entry);
+}
+
+static gint
+compare_entries (const ListEntry *a,
+                 const ListEntry *b)
+{
+  GtdProvider *p1;
+  GtdProvider *p2;
+  gint retval;
+
+  if (a == b)
+    return 0;
+
+  p1 = gtd_task_list_get_provider (a->list);
+  p2 = gtd_task_list_get_provider (b->list);
+
+  retval = g_strcmp0 (gtd_provider_get_description (p1), gtd_provider_get_description (p2));
+
+  if (retval != 0)
+    return retval;
+
+  retval = g_strcmp0 (a->folded_name, b->folded_name);
+
+  if (retval != 0)
+    return retval;
+
+  /* Lists with the same name still need a stable order */
+  return a < b ? -1 : 1;
+}
+
+/*
+ * Looks for @entry in the sorted @array. Returns whether it is there,
+ * and sets @position to either its index or where it should be inserted.
+ */
+static gboolean
+find_entry (GPtrArray *array,
+            ListEntry *entry,
+            guint     *position)
+{
+  guint low, high;
+
+  low = 0;
+  high = array->len;
+
+  while (low < high)
+    {
+      guint middle;
+      gint result;
+
+      middle = low + (high - low) / 2;
+      result = compare_entries (g_ptr_array_index (array, middle), entry);
+
+      if (result == 0)
+        {
+          *position = middle;
+          return TRUE;
+        }
+
+      if (result < 0)
+        low = middle + 1;
+      else
+        high = middle;
+    }
+
+  *position = low;
+
+  return FALSE;
+}
+
+static gboolean
+entry_matches (GtdListSelectorModel *self,
+               ListEntry            *entry)
+{
+  if (!self->search_folded || self->search_folded[0] == '\0')
+    return TRUE;
+
+  return strstr (entry->folded_name, self->search_folded) != NULL;
+}
+
+static void
+insert_entry (GtdListSelectorModel *self,
+              ListEntry            *entry)
+{
+  guint position;
+
+  find_entry (self->entries, entry, &position);
+  g_ptr_array_insert (self->entries, position, entry);
+
+  if (!entry_matches (self, entry))
+    return;
+
+  find_entry (self->visible, entry, &position);
+  g_ptr_array_insert (self->visible, position, entry);
+
+  g_list_model_items_changed (G_LIST_MODEL (self), position, 0, 1);
+}
+
+/*
+ * Removes @entry from the arrays without freeing it. Must be called
+ * before the sorting key of @entry changes.
+ */
+static void
+steal_entry (GtdListSelectorModel *self,
+             ListEntry            *entry)
+{
+  guint position;
+
+  if (find_entry (self->visible, entry, &position))
+    {
+      g_ptr_array_remove_index (self->visible, position);
+      g_list_model_items_changed (G_LIST_MODEL (self), position, 1, 0);
+    }
+
+  if (find_entry (self->entries, entry, &position))
+    g_ptr_array_remove_index (self->entries, position);
+}
+
+/*
+ * Updates the visible lists after the search query changed. Since both
+ * arrays have the same order, a single pass is enough, and contiguous
+ * changes are reported together so the boxes only create widgets for
+ * the lists that appear and destroy the ones that disappear.
+ */
+static void
+refilter (GtdListSelectorModel *self)
+{
+  guint run_start;
+  guint n_removed;
+  guint n_added;
+  guint position;
+  guint i;
+
+  run_start = 0;
+  n_removed = 0;
+  n_added = 0;
+  position = 0;
+
+  for (i = 0; i < self->entries->len; i++)
+    {
+      ListEntry *entry;
+      gboolean was_visible;
+      gboolean is_visible;
+
+      entry = g_ptr_array_index (self->entries, i);
+      was_visible = position < self->visible->len && g_ptr_array_index (self->visible, position) == entry;
+      is_visible = entry_matches (self, entry);
+
+      if (was_visible && is_visible)
+        {
+          if (n_removed > 0 || n_added > 0)
+            g_list_model_items_changed (G_LIST_MODEL (self), run_start, n_removed, n_added);
+
+          n_removed = n_added = 0;
+          position++;
+          continue;
+        }
+
+      if (n_removed == 0 && n_added == 0)
+        run_start = position;
+
+      if (was_visible)
+        {
+          g_ptr_array_remove_index (self->visible, position);
+          n_removed++;
+        }
+      else if (is_visible)
+        {
+          g_ptr_array_insert (self->visible, position, entry);
+          position++;
+          n_added++;
+        }
+    }
+
+  if (n_removed > 0 || n_added > 0)
+    g_list_model_items_changed (G_LIST_MODEL (self), run_start, n_removed, n_added);
+}
+
+
+/*
+ * Callbacks
+ */
+
+static void
+list_added_cb (GtdManager           *manager,
+               GtdTaskList          *list,
+               GtdListSelectorModel *self)
+{
+  ListEntry *entry;
+
+  if (g_hash_table_contains (self->list_to_entry, list))
+    return;
+
+  entry = list_entry_new (list);
+
+  g_hash_table_insert (self->list_to_entry, list, entry);
+
+  g_signal_connect_object (list,
+                           "notify::name",
+                           G_CALLBACK (list_name_changed_cb),
+                           self,
+                           0);
+
+  insert_entry (self, entry);
+}
+
+static void
+list_removed_cb (GtdManager           *manager,
+                 GtdTaskList          *list,
+                 GtdListSelectorModel *self)
+{
+  ListEntry *entry;
+
+  entry = g_hash_table_lookup (self->list_to_entry, list);
+
+  if (!entry)
+    return;
+
+  g_signal_handlers_disconnect_by_func (list, list_name_changed_cb, self);
+
+  steal_entry (self, entry);
+
+  g_hash_table_remove (self->list_to_entry, list);
+}
+
+static void
+list_name_changed_cb (GtdTaskList          *list,
+                      GParamSpec           *pspec,
+                      GtdListSelectorModel *self)
+{
+  ListEntry *entry;
+
+  entry = g_hash_table_lookup (self->list_to_entry, list);
+
+  /* Take the entry out with its old name, so it can be found */
+  steal_entry (self, entry);
+
+  g_clear_pointer (&entry->folded_name, g_free);
+  entry->folded_name = g_utf8_casefold (gtd_task_list_get_name (list), -1);
+
+  insert_entry (self, entry);
+}
+
+
+/*
+ * GListModel iface
+ */
+
+static GType
+gtd_list_selector_model_get_item_type (GListModel *model)
+{
+  return GTD_TYPE_TASK_LIST;
+}
+
+static guint
+gtd_list_selector_model_get_n_items (GListModel *model)
+{
+  return GTD_LIST_SELECTOR_MODEL (model)->visible->len;
+}
+
+static gpointer
+gtd_list_selector_model_get_item (GListModel *model,
+                                  guint       position)
+{
+  GtdListSelectorModel *self = GTD_LIST_SELECTOR_MODEL (model);
+  ListEntry *entry;
+
+  if (position >= self->visible->len)
+    return NULL;
+
+  entry = g_ptr_array_index (self->visible, position);
+
+  return g_object_ref (entry->list);
+}
+
+static void
+g_list_model_iface_init (GListModelInterface *iface)
+{
+  iface->get_item_type = gtd_list_selector_model_get_item_type;
+  iface->get_n_items = gtd_list_selector_model_get_n_items;
+  iface->get_item = gtd_list_selector_model_get_item;
+}
+
+
+/*
+ * GObject overrides
+ */
+
+static void
+gtd_list_selector_model_finalize (GObject *object)
+{
+  GtdListSelectorModel *self = (GtdListSelectorModel *)object;
+  GHashTableIter iter;
+  gpointer list;
+
+  g_hash_table_iter_init (&iter, self->list_to_entry);
+
+  while (g_hash_table_iter_next (&iter, &list, NULL))
+    g_signal_handlers_disconnect_by_func (list, list_name_changed_cb, self);
+
+  g_clear_pointer (&self->visible, g_ptr_array_unref);
+  g_clear_pointer (&self->entries, g_ptr_array_unref);
+  g_clear_pointer (&self->list_to_entry, g_hash_table_destroy);
+  g_clear_pointer (&self->search_query, g_free);
+  g_clear_pointer (&self->search_folded, g_free);
+
+  G_OBJECT_CLASS (gtd_list_selector_model_parent_class)->finalize (object);
+}
+
+static void
+gtd_list_selector_model_get_property (GObject    *object,
+                                      guint       prop_id,
+                                      GValue     *value,
+                                      GParamSpec *pspec)
+{
+  GtdListSelectorModel *self = GTD_LIST_SELECTOR_MODEL (object);
+
+  switch (prop_id)
+    {
+    case PROP_SEARCH_QUERY:
+      g_value_set_string (value, self->search_query);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+    }
+}
+
+static void
+gtd_list_selector_model_set_property (GObject      *object,
+                                      guint         prop_id,
+                                      const GValue *value,
+                                      GParamSpec   *pspec)
+{
+  GtdListSelectorModel *self = GTD_LIST_SELECTOR_MODEL (object);
+
+  switch (prop_id)
+    {
+    case PROP_SEARCH_QUERY:
+      gtd_list_selector_model_set_search_query (self, g_value_get_string (value));
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+    }
+}
+
+static void
+gtd_list_selector_model_class_init (GtdListSelectorModelClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->finalize = gtd_list_selector_model_finalize;
+  object_class->get_property = gtd_list_selector_model_get_property;
+  object_class->set_property = gtd_list_selector_model_set_property;
+
+  /**
+   * GtdListSelectorModel::search-query:
+   *
+   * The search query used to filter the lists.
+   */
+  properties[PROP_SEARCH_QUERY] = g_param_spec_string ("search-query",
+                                                       "Search query",
+                                                       "The search query used to filter the lists",
+                                                       NULL,
+                                                       G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY);
+
+  g_object_class_install_properties (object_class, N_PROPS, properties);
+}
+
+static void
+gtd_list_selector_model_init (GtdListSelectorModel *self)
+{
+  GtdManager *manager;
+  GList *lists;
+  GList *l;
+
+  self->entries = g_ptr_array_new ();
+  self->visible = g_ptr_array_new ();
+  self->list_to_entry = g_hash_table_new_full (g_direct_hash,
+                                               g_direct_equal,
+                                               NULL,
+                                               (GDestroyNotify) list_entry_free);
+
+  manager = gtd_manager_get_default ();
+
+  g_signal_connect_object (manager,
+                           "list-added",
+                           G_CALLBACK (list_added_cb),
+                           self,
+                           0);
+
+  g_signal_connect_object (manager,
+                           "list-removed",
+                           G_CALLBACK (list_removed_cb),
+                           self,
+                           0);
+
+  /* Add already loaded lists */
+  lists = gtd_manager_get_task_lists (manager);
+
+  for (l = lists; l != NULL; l = l->next)
+    list_added_cb (manager, l->data, self);
+
+  g_list_free (lists);
+}
+
+/**
+ * gtd_list_selector_model_new:
+ *
+ * Creates a new #GtdListSelectorModel with the task lists of the
+ * default #GtdManager.
+ *
+ * Returns: (transfer full): a #GtdListSelectorModel
+ */
+GtdListSelectorModel*
+gtd_list_selector_model_new (void)
+{
+  return g_object_new (GTD_TYPE_LIST_SELECTOR_MODEL, NULL);
+}
+
+/**
+ * gtd_list_selector_model_get_search_query:
+ * @self: a #GtdListSelectorModel
+ *
+ * Retrieves the search query of @self.
+ *
+ * Returns: (nullable): the search query
+ */
+const gchar*
+gtd_list_selector_model_get_search_query (GtdListSelectorModel *self)
+{
+  g_return_val_if_fail (GTD_IS_LIST_SELECTOR_MODEL (self), NULL);
+
+  return self->search_query;
+}
+
+/**
+ * gtd_list_selector_model_set_search_query:
+ * @self: a #GtdListSelectorModel
+ * @search_query: (nullable): the search query
+ *
+ * Sets the search query of @self. Only lists whose name contains
+ * @search_query, ignoring case, are exposed by @self.
+ */
+void
+gtd_list_selector_model_set_search_query (GtdListSelectorModel *self,
+                                          const gchar          *search_query)
+{
+  g_return_if_fail (GTD_IS_LIST_SELECTOR_MODEL (self));
+
+  if (g_strcmp0 (self->search_query, search_query) == 0)
+    return;
+
+  g_clear_pointer (&self->search_query, g_free);
+  g_clear_pointer (&self->search_folded, g_free);
+
+  self->search_query = g_strdup (search_query);
+  self->search_folded = search_query ? g_utf8_casefold (search_query, -1) : NULL;
+
+  refilter (self);
+
+  g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_SEARCH_QUERY]);
+}
@@ -0,0 +1,39 @@
+/* gtd-list-selector-model.h
+ *
+ * Copyright (C) 2017 Georges Basile Stavracas Neto <georges.stavracas@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GTD_LIST_SELECTOR_MODEL_H
+#define GTD_LIST_SELECTOR_MODEL_H
+
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+#define GTD_TYPE_LIST_SELECTOR_MODEL (gtd_list_selector_model_get_type())
+
+G_DECLARE_FINAL_TYPE (GtdListSelectorModel, gtd_list_selector_model, GTD, LIST_SELECTOR_MODEL, GObject)
+
+GtdListSelectorModel* gtd_list_selector_model_new                (void);
+
+const gchar*         gtd_list_selector_model_get_search_query    (GtdListSelectorModel *self);
+
+void                 gtd_list_selector_model_set_search_query    (GtdListSelectorModel *self,
+                                                                  const gchar          *search_query);
+
+G_END_DECLS
+
+#endif /* GTD_LIST_SELECTOR_MODEL_H */